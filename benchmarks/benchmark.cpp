@@ -0,0 +1,895 @@
+// Header files
+#include <arpa/inet.h>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include "../geolocation_service.h"
+#include <iomanip>
+#include <iostream>
+#include "../json_serializer.h"
+#include "../logger.h"
+#include <new>
+#include "../peer_registry.h"
+#include "../peer_store.h"
+#include <random>
+#include <regex>
+#include "../snapshot_writer.h"
+#include <sstream>
+#include <sys/resource.h>
+#include <thread>
+#include "../user_agent.h"
+#include <vector>
+
+using namespace std;
+
+
+// Structures
+
+// Replayed peer structure
+struct ReplayedPeer {
+
+	// Peer identifier
+	string peerIdentifier;
+	
+	// User agent
+	string userAgent;
+	
+	// Peer
+	PeerRegistry::Peer peer;
+};
+
+// Benchmark result structure
+struct BenchmarkResult {
+
+	// Name
+	string name;
+	
+	// Nanoseconds per operation
+	double nanosecondsPerOperation;
+	
+	// Allocations per operation
+	double allocationsPerOperation;
+	
+	// Mebibytes per second
+	double mebibytesPerSecond;
+	
+	// Peak resident set size in kibibytes
+	uint64_t peakResidentSetSize;
+};
+
+
+// Constants
+
+// Number of peers
+static const size_t NUMBER_OF_PEERS = 2000;
+
+// Number of iterations
+static const size_t NUMBER_OF_ITERATIONS = 200;
+
+// Number of store iterations
+static const size_t NUMBER_OF_STORE_ITERATIONS = 50;
+
+// Number of snapshot iterations
+static const size_t NUMBER_OF_SNAPSHOT_ITERATIONS = 20;
+
+// Replayed peers location
+static const char *REPLAYED_PEERS_LOCATION = "./mainnet_peers.json";
+
+// IP geolocate database location
+static const char *IP_GEOLOCATE_DATABASE_LOCATION = "./ip_geolocate_database.mmdb";
+
+// Store location
+static const char *STORE_LOCATION = "./benchmark_peers_state.log";
+
+// Snapshot JSON location
+static const char *SNAPSHOT_JSON_LOCATION = "./benchmark_peers.json";
+
+// Snapshot binary location
+static const char *SNAPSHOT_BINARY_LOCATION = "./benchmark_peers.bin";
+
+// Snapshot aggregates location
+static const char *SNAPSHOT_AGGREGATES_LOCATION = "./benchmark_peers_aggregates.json";
+
+// Snapshot history location
+static const char *SNAPSHOT_HISTORY_LOCATION = "./benchmark_peers_history.json";
+
+// History location
+static const char *HISTORY_LOCATION = "./benchmark_peers_history_state.bin";
+
+// Known user agent pattern
+static const regex KNOWN_USER_AGENT_PATTERN(R"(^(?:MW\/MWC |MWC Validation Node |MWC Pay |MWC Node Map |mwc-node-cpp\/|mwc-node-go\/)\d{1,3}\.\d{1,3}\.\d{1,3}$)");
+
+// User agents
+static const char *USER_AGENTS[] = {
+
+	// Known user agents
+	"MW/MWC 5.3.9",
+	"MW/MWC 6.0.1",
+	"MWC Validation Node 1.2.3",
+	"mwc-node-go/0.1.0",
+	
+	// Unknown user agents
+	"MW/MWC 6.0.1-beta",
+	"Something else entirely"
+};
+
+
+// Global variables
+
+// User agent table
+static UserAgentTable userAgentTable;
+
+// Number of allocations
+static atomic<uint64_t> numberOfAllocations(0);
+
+// Benchmark results
+static vector<BenchmarkResult> benchmarkResults;
+
+
+// Function prototypes
+
+// Create peers
+static vector<pair<string, PeerRegistry::Peer>> createPeers();
+
+// Load replayed peers
+static vector<ReplayedPeer> loadReplayedPeers();
+
+// Get JSON field
+static string getJsonField(const string &record, const char *name);
+
+// Serialize peer with stream
+static void serializePeerWithStream(ostream &stream, const string &peerIdentifier, const PeerRegistry::Peer &peer);
+
+// Measure
+static void measure(const char *name, const size_t numberOfIterations, const size_t numberOfOperationsPerIteration, const function<size_t(const size_t iteration)> &run, const function<void(const size_t iteration)> &prepare = nullptr);
+
+// Save benchmark results
+static void saveBenchmarkResults(const char *location);
+
+
+// Operators
+
+// New operator (counts allocations so that they can be reported per operation)
+void *operator new(const size_t size) {
+
+	// Increment number of allocations
+	numberOfAllocations.fetch_add(1, memory_order_relaxed);
+	
+	// Check if allocating memory failed
+	void *memory = malloc(size ? size : 1);
+	if(!memory) {
+	
+		// Throw exception
+		throw bad_alloc();
+	}
+	
+	// Return memory
+	return memory;
+}
+
+// Delete operator
+void operator delete(void *memory) noexcept {
+
+	// Free memory
+	free(memory);
+}
+
+// Delete operator
+void operator delete(void *memory, const size_t size) noexcept {
+
+	// Free memory
+	free(memory);
+}
+
+
+// Main function
+int main(int argc, char *argv[]) {
+
+	// Create peers with generated IPv4, IPv6, and Tor identifiers
+	const vector<pair<string, PeerRegistry::Peer>> peers = createPeers();
+	
+	// Load replayed peers
+	const vector<ReplayedPeer> replayedPeers = loadReplayedPeers();
+	if(replayedPeers.empty()) {
+	
+		// Display message
+		cout << "Skipping replayed benchmarks since " << REPLAYED_PEERS_LOCATION << " doesn't exist" << endl;
+	}
+	
+	// Check if the IP geolocate database exists
+	if(filesystem::exists(IP_GEOLOCATE_DATABASE_LOCATION)) {
+	
+		// Create logger for the geolocation services' messages
+		Logger logger(Logger::Severity::INFO);
+		
+		// Benchmark geolocating generated peers
+		const GeolocationService geolocationService(IP_GEOLOCATE_DATABASE_LOCATION, logger);
+		measure("Geolocate generated", NUMBER_OF_ITERATIONS, peers.size(), [&peers, &geolocationService](const size_t iteration) -> size_t {
+		
+			// Go through all peers
+			for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+			
+				// Geolocate peer
+				geolocationService.geolocate(peer.first);
+			}
+			
+			// Return no bytes
+			return 0;
+		});
+		
+		// Check if replayed peers exist
+		if(!replayedPeers.empty()) {
+		
+			// Benchmark geolocating replayed peers
+			measure("Geolocate replayed", NUMBER_OF_ITERATIONS, replayedPeers.size(), [&replayedPeers, &geolocationService](const size_t iteration) -> size_t {
+			
+				// Go through all replayed peers
+				for(const ReplayedPeer &replayedPeer : replayedPeers) {
+				
+					// Geolocate replayed peer
+					geolocationService.geolocate(replayedPeer.peerIdentifier);
+				}
+				
+				// Return no bytes
+				return 0;
+			});
+		}
+		
+		// Loop while the indexed geolocation service is being indexed
+		const GeolocationService indexedGeolocationService(IP_GEOLOCATE_DATABASE_LOCATION, logger, true);
+		while(indexedGeolocationService.isReloading()) {
+		
+			// Sleep
+			this_thread::sleep_for(10ms);
+		}
+		
+		// Benchmark geolocating generated peers with the index
+		measure("Geolocate generated indexed", NUMBER_OF_ITERATIONS, peers.size(), [&peers, &indexedGeolocationService](const size_t iteration) -> size_t {
+		
+			// Go through all peers
+			for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+			
+				// Geolocate peer
+				indexedGeolocationService.geolocate(peer.first);
+			}
+			
+			// Return no bytes
+			return 0;
+		});
+		
+		// Check if replayed peers exist
+		if(!replayedPeers.empty()) {
+		
+			// Benchmark geolocating replayed peers with the index
+			measure("Geolocate replayed indexed", NUMBER_OF_ITERATIONS, replayedPeers.size(), [&replayedPeers, &indexedGeolocationService](const size_t iteration) -> size_t {
+			
+				// Go through all replayed peers
+				for(const ReplayedPeer &replayedPeer : replayedPeers) {
+				
+					// Geolocate replayed peer
+					indexedGeolocationService.geolocate(replayedPeer.peerIdentifier);
+				}
+				
+				// Return no bytes
+				return 0;
+			});
+		}
+	}
+	
+	// Otherwise
+	else {
+	
+		// Display message
+		cout << "Skipping geolocate benchmarks since " << IP_GEOLOCATE_DATABASE_LOCATION << " doesn't exist" << endl;
+	}
+	
+	// Benchmark matching user agents with a regular expression
+	size_t numberOfMatches = 0;
+	measure("User agent regex", NUMBER_OF_ITERATIONS, NUMBER_OF_PEERS, [&numberOfMatches](const size_t iteration) -> size_t {
+	
+		// Go through all peers
+		for(size_t i = iteration * NUMBER_OF_PEERS; i < (iteration + 1) * NUMBER_OF_PEERS; ++i) {
+		
+			// Match user agent with a regular expression
+			numberOfMatches += regex_match(USER_AGENTS[i % size(USER_AGENTS)], KNOWN_USER_AGENT_PATTERN);
+		}
+		
+		// Return no bytes
+		return 0;
+	});
+	
+	// Benchmark matching user agents with the user agent matcher
+	measure("User agent matcher", NUMBER_OF_ITERATIONS, NUMBER_OF_PEERS, [&numberOfMatches](const size_t iteration) -> size_t {
+	
+		// Go through all peers
+		for(size_t i = iteration * NUMBER_OF_PEERS; i < (iteration + 1) * NUMBER_OF_PEERS; ++i) {
+		
+			// Match user agent with the user agent matcher
+			numberOfMatches -= UserAgentMatcher::match(USER_AGENTS[i % size(USER_AGENTS)]).has_value();
+		}
+		
+		// Return no bytes
+		return 0;
+	});
+	
+	// Check if the user agent matcher and the regular expression disagree
+	if(numberOfMatches) {
+	
+		// Display message
+		cout << "User agent matcher and regular expression disagree" << endl;
+		
+		// Return failure
+		return EXIT_FAILURE;
+	}
+	
+	// Check if replayed peers exist
+	if(!replayedPeers.empty()) {
+	
+		// Benchmark interning replayed peers' user agents
+		measure("User agent intern", NUMBER_OF_ITERATIONS, replayedPeers.size(), [&replayedPeers](const size_t iteration) -> size_t {
+		
+			// Go through all replayed peers
+			for(const ReplayedPeer &replayedPeer : replayedPeers) {
+			
+				// Intern replayed peer's user agent
+				userAgentTable.intern(replayedPeer.userAgent);
+			}
+			
+			// Return no bytes
+			return 0;
+		});
+	}
+	
+	// Benchmark serializing peers with a stream
+	measure("Stream serializer", NUMBER_OF_ITERATIONS, peers.size(), [&peers](const size_t iteration) -> size_t {
+	
+		// Go through all peers
+		ostringstream stream;
+		for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+		
+			// Serialize peer with stream
+			serializePeerWithStream(stream, peer.first, peer.second);
+		}
+		
+		// Return number of bytes
+		return stream.tellp();
+	});
+	
+	// Benchmark serializing peers with the JSON serializer
+	const PeerRegistry peerRegistry(userAgentTable, 168h);
+	JsonSerializer serializer;
+	measure("JSON serializer", NUMBER_OF_ITERATIONS, peers.size(), [&peers, &peerRegistry, &serializer](const size_t iteration) -> size_t {
+	
+		// Go through all peers
+		serializer.clear();
+		for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+		
+			// Serialize peer with the JSON serializer
+			peerRegistry.serializePeer(serializer, peer.first, peer.second);
+		}
+		
+		// Return number of bytes
+		return serializer.getSize();
+	});
+	
+	// Check if replayed peers exist
+	if(!replayedPeers.empty()) {
+	
+		// Benchmark serializing replayed peers with the JSON serializer
+		measure("JSON serializer replayed", NUMBER_OF_ITERATIONS, replayedPeers.size(), [&replayedPeers, &peerRegistry, &serializer](const size_t iteration) -> size_t {
+		
+			// Go through all replayed peers
+			serializer.clear();
+			for(const ReplayedPeer &replayedPeer : replayedPeers) {
+			
+				// Serialize replayed peer with the JSON serializer
+				peerRegistry.serializePeer(serializer, replayedPeer.peerIdentifier, replayedPeer.peer);
+			}
+			
+			// Return number of bytes
+			return serializer.getSize();
+		});
+	}
+	
+	// Benchmark updating peers in a registry and its history the same way the ingestion pipeline does
+	PeerRegistry recentPeers(userAgentTable, 168h);
+	PeerHistory history(HISTORY_LOCATION, userAgentTable);
+	recentPeers.setHistory(&history);
+	measure("Registry update", NUMBER_OF_ITERATIONS, peers.size(), [&peers, &recentPeers](const size_t iteration) -> size_t {
+	
+		// Go through all peers
+		for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+		
+			// Update peer in the registry
+			Geolocation geolocation = peer.second.geolocation;
+			recentPeers.updatePeer(peer.first, peer.second.capabilities, peer.second.userAgentId, peer.second.baseFee, move(geolocation), peer.second.isInbound, peer.second.latency);
+		}
+		
+		// Return no bytes
+		return 0;
+	});
+	
+	// Benchmark getting the number of unique peers seen today and over the last month from the history
+	const uint64_t today = PeerHistory::getDay(chrono::system_clock::now());
+	uint64_t numberOfUniquePeers = 0;
+	measure("History unique peers", NUMBER_OF_ITERATIONS, 2, [&history, today, &numberOfUniquePeers](const size_t iteration) -> size_t {
+	
+		// Get number of unique peers seen today and over the last month
+		numberOfUniquePeers += history.getNumberOfUniquePeers(today) + history.getNumberOfUniquePeers(today - 29, today);
+		
+		// Return no bytes
+		return 0;
+	});
+	
+	// Benchmark a filtered peer query like the ones that the HTTP server serves
+	const PeerIndex::Query query = *PeerIndex::parseQuery("continent=Europe&version=5.3&capabilities=1&tor=false&inbound=false&limit=100");
+	measure("Registry query", NUMBER_OF_ITERATIONS, 1, [&recentPeers, &serializer, &query](const size_t iteration) -> size_t {
+	
+		// Serialize peers that match the query
+		serializer.clear();
+		recentPeers.serializeQuery(serializer, query);
+		
+		// Return number of bytes
+		return serializer.getSize();
+	});
+	
+	// Check if replayed peers exist
+	if(!replayedPeers.empty()) {
+	
+		// Go through all replayed peers
+		for(const ReplayedPeer &replayedPeer : replayedPeers) {
+		
+			// Add replayed peer to the registry so that snapshots contain them
+			Geolocation geolocation = replayedPeer.peer.geolocation;
+			recentPeers.updatePeer(replayedPeer.peerIdentifier, replayedPeer.peer.capabilities, replayedPeer.peer.userAgentId, replayedPeer.peer.baseFee, move(geolocation), replayedPeer.peer.isInbound, replayedPeer.peer.latency);
+		}
+	}
+	
+	// Benchmark appending peers that were seen since the last save to the store
+	filesystem::remove(STORE_LOCATION);
+	{
+		PeerStore store(STORE_LOCATION, userAgentTable);
+		PeerRegistry restoredPeers(userAgentTable, 168h);
+		store.load(restoredPeers);
+		measure("Store append", NUMBER_OF_STORE_ITERATIONS, recentPeers.getPeers().size(), [&store, &recentPeers](const size_t iteration) -> size_t {
+		
+			// Serialize and save peers that were seen since the last save
+			const uintmax_t previousSize = filesystem::file_size(STORE_LOCATION);
+			store.serialize(recentPeers);
+			store.save();
+			
+			// Return number of bytes appended or the store's size if it was compacted
+			const uintmax_t size = filesystem::file_size(STORE_LOCATION);
+			return (size >= previousSize) ? size - previousSize : size;
+			
+		}, [&peers, &replayedPeers, &recentPeers](const size_t iteration) -> void {
+		
+			// Go through all peers
+			for(const pair<string, PeerRegistry::Peer> &peer : peers) {
+			
+				// Update peer in the registry so that it's saved
+				Geolocation geolocation = peer.second.geolocation;
+				recentPeers.updatePeer(peer.first, peer.second.capabilities, peer.second.userAgentId, peer.second.baseFee, move(geolocation), peer.second.isInbound, peer.second.latency);
+			}
+			
+			// Go through all replayed peers
+			for(const ReplayedPeer &replayedPeer : replayedPeers) {
+			
+				// Update replayed peer in the registry so that it's saved
+				Geolocation geolocation = replayedPeer.peer.geolocation;
+				recentPeers.updatePeer(replayedPeer.peerIdentifier, replayedPeer.peer.capabilities, replayedPeer.peer.userAgentId, replayedPeer.peer.baseFee, move(geolocation), replayedPeer.peer.isInbound, replayedPeer.peer.latency);
+			}
+		});
+	}
+	filesystem::remove(STORE_LOCATION);
+	
+	// Benchmark rebuilding a full snapshot
+	SnapshotWriter snapshotWriter(SNAPSHOT_JSON_LOCATION, SNAPSHOT_BINARY_LOCATION, SNAPSHOT_AGGREGATES_LOCATION, SNAPSHOT_HISTORY_LOCATION);
+	measure("Snapshot rebuild", NUMBER_OF_SNAPSHOT_ITERATIONS, 1, [&snapshotWriter, &recentPeers](const size_t iteration) -> size_t {
+	
+		// Serialize and compress peers
+		snapshotWriter.serialize(recentPeers);
+		snapshotWriter.compress();
+		
+		// Go through all serialized files
+		size_t numberOfBytes = 0;
+		for(size_t i = 0; i < SnapshotWriter::NUMBER_OF_FILES / 2; ++i) {
+		
+			// Add serialized file's size to the number of bytes
+			numberOfBytes += snapshotWriter.getData(i).size();
+		}
+		
+		// Return number of bytes
+		return numberOfBytes;
+	});
+	
+	// Check if a results location was provided
+	if(argc > 1) {
+	
+		// Try
+		try {
+		
+			// Save benchmark results
+			saveBenchmarkResults(argv[1]);
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Display message
+			cout << "Saving benchmark results failed: " << error.what() << endl;
+			
+			// Return failure
+			return EXIT_FAILURE;
+		}
+	}
+	
+	// Return success
+	return EXIT_SUCCESS;
+}
+
+
+// Supporting function implementation
+
+// Create peers
+vector<pair<string, PeerRegistry::Peer>> createPeers() {
+
+	// Initialize random number generator with a fixed seed so that runs are comparable
+	mt19937_64 randomNumberGenerator(0);
+	
+	// Go through all peers
+	vector<pair<string, PeerRegistry::Peer>> peers;
+	for(size_t i = 0; i < NUMBER_OF_PEERS; ++i) {
+	
+		// Create peer with a latency unless it's a Tor peer since the crawler doesn't measure those
+		const bool isTor = !(i % 10);
+		const chrono::microseconds latency = isTor ? chrono::microseconds::zero() : chrono::microseconds(10000 + randomNumberGenerator() % 490000);
+		PeerRegistry::Peer peer = {
+		
+			// Capabilities
+			.capabilities = static_cast<MwcValidationNode::Node::Capabilities>(randomNumberGenerator() & 0xFF),
+			
+			// User agent ID
+			.userAgentId = userAgentTable.intern("MW/MWC 5.3." + to_string(randomNumberGenerator() % 10)),
+			
+			// Base fee
+			.baseFee = 1000,
+			
+			// Geolocation
+			.geolocation = isTor ? Geolocation() : Geolocation{
+			
+				// Continent
+				.continent = "Europe",
+				
+				// Country
+				.country = "Germany",
+				
+				// Subdivision
+				.subdivision = "Hesse",
+				
+				// City
+				.city = "Frankfurt am Main",
+				
+				// Longitude
+				.longitude = static_cast<double>(randomNumberGenerator() % 360000) / 1000 - 180,
+				
+				// Latitude
+				.latitude = static_cast<double>(randomNumberGenerator() % 180000) / 1000 - 90
+			},
+			
+			// First seen time
+			.firstSeenTime = chrono::system_clock::now(),
+			
+			// Last seen time
+			.lastSeenTime = chrono::system_clock::now(),
+			
+			// Seen count
+			.seenCount = randomNumberGenerator() % 100,
+			
+			// Is inbound
+			.isInbound = !(i % 3),
+			
+			// Latency
+			.latency = latency,
+			
+			// Minimum latency
+			.minimumLatency = latency
+		};
+		
+		// Check if peer is a Tor peer
+		string peerIdentifier;
+		if(isTor) {
+		
+			// Set peer identifier to a Tor address
+			peerIdentifier = to_string(randomNumberGenerator()) + ".onion";
+		}
+		
+		// Otherwise check if peer is an IPv6 peer
+		else if(i % 10 == 1) {
+		
+			// Set peer identifier to an IPv6 address and port
+			char ipv6Address[INET6_ADDRSTRLEN];
+			const array<uint64_t, 2> ipv6AddressBytes = {randomNumberGenerator(), randomNumberGenerator()};
+			inet_ntop(AF_INET6, ipv6AddressBytes.data(), ipv6Address, sizeof(ipv6Address));
+			peerIdentifier = string("[") + ipv6Address + "]:3414";
+		}
+		
+		// Otherwise
+		else {
+		
+			// Set peer identifier to an IPv4 address and port
+			peerIdentifier = to_string(randomNumberGenerator() % 256) + '.' + to_string(randomNumberGenerator() % 256) + '.' + to_string(randomNumberGenerator() % 256) + '.' + to_string(randomNumberGenerator() % 256) + ":3414";
+		}
+		
+		// Add peer to list
+		peers.emplace_back(move(peerIdentifier), move(peer));
+	}
+	
+	// Return peers
+	return peers;
+}
+
+// Load replayed peers
+vector<ReplayedPeer> loadReplayedPeers() {
+
+	// Check if opening replayed peers file failed
+	vector<ReplayedPeer> replayedPeers;
+	ifstream file(REPLAYED_PEERS_LOCATION);
+	if(!file) {
+	
+		// Return replayed peers
+		return replayedPeers;
+	}
+	
+	// Go through all records in the replayed peers file
+	for(string record; getline(file, record);) {
+	
+		// Check if record isn't a peer
+		if(!record.starts_with('{')) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Get record's longitude and latitude
+		const string longitude = getJsonField(record, "longitude");
+		const string latitude = getJsonField(record, "latitude");
+		
+		// Append replayed peer to the replayed peers
+		const string userAgent = getJsonField(record, "user_agent");
+		replayedPeers.push_back({
+		
+			// Peer identifier
+			.peerIdentifier = getJsonField(record, "address"),
+			
+			// User agent
+			.userAgent = userAgent,
+			
+			// Peer
+			.peer = {
+			
+				// Capabilities
+				.capabilities = static_cast<MwcValidationNode::Node::Capabilities>(strtoul(getJsonField(record, "capabilities").c_str(), nullptr, 10)),
+				
+				// User agent ID
+				.userAgentId = userAgentTable.intern(userAgent),
+				
+				// Base fee
+				.baseFee = strtoull(getJsonField(record, "base_fee").c_str(), nullptr, 10),
+				
+				// Geolocation
+				.geolocation = {
+				
+					// Continent
+					.continent = getJsonField(record, "continent"),
+					
+					// Country
+					.country = getJsonField(record, "country"),
+					
+					// Subdivision
+					.subdivision = getJsonField(record, "subdivision"),
+					
+					// City
+					.city = getJsonField(record, "city"),
+					
+					// Longitude
+					.longitude = longitude.empty() ? NAN : strtod(longitude.c_str(), nullptr),
+					
+					// Latitude
+					.latitude = latitude.empty() ? NAN : strtod(latitude.c_str(), nullptr)
+				},
+				
+				// First seen time
+				.firstSeenTime = chrono::system_clock::now(),
+				
+				// Last seen time
+				.lastSeenTime = chrono::system_clock::now(),
+				
+				// Seen count
+				.seenCount = 1
+			}
+		});
+	}
+	
+	// Return replayed peers
+	return replayedPeers;
+}
+
+// Get JSON field
+string getJsonField(const string &record, const char *name) {
+
+	// Check if field doesn't exist or isn't a string
+	string value;
+	const size_t start = record.find(string("\"") + name + "\":\"");
+	if(start == string::npos) {
+	
+		// Return value
+		return value;
+	}
+	
+	// Go through all of the field's characters
+	for(size_t i = start + strlen(name) + sizeof("\"\":\"") - sizeof('\0'); i < record.size() && record[i] != '"'; ++i) {
+	
+		// Check if character is escaped
+		if(record[i] == '\\' && i + 1 < record.size()) {
+		
+			// Skip escape
+			++i;
+		}
+		
+		// Append character to the value
+		value.push_back(record[i]);
+	}
+	
+	// Return value
+	return value;
+}
+
+// Serialize peer with stream
+void serializePeerWithStream(ostream &stream, const string &peerIdentifier, const PeerRegistry::Peer &peer) {
+
+	// Get peer's geolocation
+	const Geolocation &geolocation = peer.geolocation;
+	
+	// Append peer's info to stream the same way that the recent peers JSON file used to be created
+	stream << ',' << endl << "{"
+		"\"address\":" << quoted(peerIdentifier.ends_with(".onion") ? to_string(hash<string>{}(peerIdentifier)) + ".onion" : peerIdentifier) << ","
+		"\"capabilities\":\"" << static_cast<uint32_t>(peer.capabilities) << "\","
+		"\"user_agent\":" << quoted(userAgentTable.getName(peer.userAgentId)) << ","
+		"\"base_fee\":\"" << peer.baseFee << "\","
+		"\"continent\":";
+		if(geolocation.continent.empty()) {
+			stream << "null";
+		}
+		else {
+			stream << quoted(geolocation.continent);
+		}
+		stream << ",\"country\":";
+		if(geolocation.country.empty()) {
+			stream << "null";
+		}
+		else {
+			stream << quoted(geolocation.country);
+		}
+		stream << ",\"subdivision\":";
+		if(geolocation.subdivision.empty()) {
+			stream << "null";
+		}
+		else {
+			stream << quoted(geolocation.subdivision);
+		}
+		stream << ",\"city\":";
+		if(geolocation.city.empty()) {
+			stream << "null";
+		}
+		else {
+			stream << quoted(geolocation.city);
+		}
+		stream << ",\"longitude\":" << (!isnan(geolocation.longitude) ? '"' + to_string(geolocation.longitude) + '"' : "null") << ","
+		"\"latitude\":" << (!isnan(geolocation.latitude) ? '"' + to_string(geolocation.latitude) + '"' : "null") << ","
+		"\"first_seen\":\"" << chrono::duration_cast<chrono::seconds>(peer.firstSeenTime.time_since_epoch()).count() << "\","
+		"\"last_seen\":\"" << chrono::duration_cast<chrono::seconds>(peer.lastSeenTime.time_since_epoch()).count() << "\","
+		"\"seen_count\":\"" << peer.seenCount << "\""
+	"}";
+}
+
+// Measure
+void measure(const char *name, const size_t numberOfIterations, const size_t numberOfOperationsPerIteration, const function<size_t(const size_t iteration)> &run, const function<void(const size_t iteration)> &prepare) {
+
+	// Go through all iterations
+	chrono::steady_clock::duration duration = chrono::steady_clock::duration::zero();
+	uint64_t numberOfIterationAllocations = 0;
+	size_t numberOfBytes = 0;
+	for(size_t i = 0; i < numberOfIterations; ++i) {
+	
+		// Check if iteration needs to be prepared
+		if(prepare) {
+		
+			// Prepare iteration
+			prepare(i);
+		}
+		
+		// Run iteration
+		const uint64_t startNumberOfAllocations = numberOfAllocations.load(memory_order_relaxed);
+		const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+		numberOfBytes += run(i);
+		duration += chrono::steady_clock::now() - startTime;
+		numberOfIterationAllocations += numberOfAllocations.load(memory_order_relaxed) - startNumberOfAllocations;
+	}
+	
+	// Get peak resident set size
+	rusage resourceUsage;
+	getrusage(RUSAGE_SELF, &resourceUsage);
+	
+	// Add benchmark result to the benchmark results
+	const size_t numberOfOperations = numberOfIterations * numberOfOperationsPerIteration;
+	const BenchmarkResult &benchmarkResult = benchmarkResults.emplace_back(BenchmarkResult{
+	
+		// Name
+		.name = name,
+		
+		// Nanoseconds per operation
+		.nanosecondsPerOperation = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(duration).count()) / numberOfOperations,
+		
+		// Allocations per operation
+		.allocationsPerOperation = static_cast<double>(numberOfIterationAllocations) / numberOfOperations,
+		
+		// Mebibytes per second
+		.mebibytesPerSecond = numberOfBytes ? static_cast<double>(numberOfBytes) / chrono::duration<double>(duration).count() / (1024 * 1024) : 0,
+		
+		// Peak resident set size in kibibytes
+		.peakResidentSetSize = static_cast<uint64_t>(resourceUsage.ru_maxrss)
+	});
+	
+	// Display message
+	cout << left << setw(26) << name << fixed << setprecision(1) << benchmarkResult.nanosecondsPerOperation << " ns/op, " << setprecision(2) << benchmarkResult.allocationsPerOperation << " allocs/op";
+	
+	// Check if bytes were produced
+	if(numberOfBytes) {
+	
+		// Display throughput
+		cout << ", " << setprecision(1) << benchmarkResult.mebibytesPerSecond << " MiB/s";
+	}
+	
+	// Display peak resident set size
+	cout << ", " << benchmarkResult.peakResidentSetSize << " KiB peak RSS" << endl;
+}
+
+// Save benchmark results
+void saveBenchmarkResults(const char *location) {
+
+	// Append version
+	JsonSerializer serializer;
+	serializer.appendRaw("{\"version\":");
+	serializer.appendString(TOSTRING(PROGRAM_VERSION));
+	
+	// Go through all benchmark results
+	serializer.appendRaw(",\"results\":[");
+	char number[32];
+	for(size_t i = 0; i < benchmarkResults.size(); ++i) {
+	
+		// Append benchmark result
+		const BenchmarkResult &benchmarkResult = benchmarkResults[i];
+		serializer.appendRaw(i ? ",\n{\"name\":" : "\n{\"name\":");
+		serializer.appendString(benchmarkResult.name);
+		serializer.appendRaw(",\"ns_per_op\":");
+		serializer.appendRaw(string_view(number, to_chars(number, number + sizeof(number), benchmarkResult.nanosecondsPerOperation, chars_format::fixed, 1).ptr));
+		serializer.appendRaw(",\"allocations_per_op\":");
+		serializer.appendRaw(string_view(number, to_chars(number, number + sizeof(number), benchmarkResult.allocationsPerOperation, chars_format::fixed, 3).ptr));
+		serializer.appendRaw(",\"mib_per_second\":");
+		serializer.appendRaw(string_view(number, to_chars(number, number + sizeof(number), benchmarkResult.mebibytesPerSecond, chars_format::fixed, 1).ptr));
+		serializer.appendRaw(",\"peak_rss_kib\":");
+		serializer.appendUnsignedInteger(benchmarkResult.peakResidentSetSize);
+		serializer.appendRaw('}');
+	}
+	serializer.appendRaw("\n]}\n");
+	
+	// Save benchmark results
+	serializer.save(location);
+}
@@ -0,0 +1,1395 @@
+// Header files
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <optional>
+#include "../peer_protocol.h"
+#include <random>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+// Enumerations
+
+// Fake peer state
+enum class FakePeerState {
+
+	// Connecting
+	CONNECTING,
+	
+	// Handshaking
+	HANDSHAKING,
+	
+	// Holding
+	HOLDING
+};
+
+// Garbage type
+enum class GarbageType {
+
+	// Random bytes
+	RANDOM_BYTES,
+	
+	// Wrong magic
+	WRONG_MAGIC,
+	
+	// Oversized length
+	OVERSIZED_LENGTH,
+	
+	// Truncated hand
+	TRUNCATED_HAND
+};
+
+
+// Structures
+
+// Options structure
+struct Options {
+
+	// Address
+	string address;
+	
+	// Port
+	uint16_t port;
+	
+	// Duration in seconds
+	uint64_t duration;
+	
+	// Number of concurrent peers
+	size_t numberOfConcurrentPeers;
+	
+	// Connection rate per second
+	double connectionRate;
+	
+	// Mean lifetime in milliseconds that a peer stays connected after its handshake
+	double meanLifetime;
+	
+	// Garbage rate
+	double garbageRate;
+	
+	// IPv6 rate
+	double ipv6Rate;
+	
+	// Onion rate
+	double onionRate;
+	
+	// User agents
+	vector<string> userAgents;
+	
+	// Capabilities
+	uint32_t capabilities;
+	
+	// Base fee
+	uint64_t baseFee;
+	
+	// Genesis block hash
+	array<uint8_t, 32> genesisBlockHash;
+	
+	// Spread source addresses
+	bool spreadSourceAddresses;
+	
+	// Map process ID
+	pid_t mapProcessId;
+	
+	// Metrics port
+	uint16_t metricsPort;
+};
+
+// Fake peer structure
+struct FakePeer {
+
+	// State
+	FakePeerState state;
+	
+	// Is garbage
+	bool isGarbage;
+	
+	// Output
+	vector<uint8_t> output;
+	
+	// Output offset
+	size_t outputOffset;
+	
+	// Input
+	vector<uint8_t> input;
+	
+	// Start time
+	chrono::steady_clock::time_point startTime;
+	
+	// Deadline
+	chrono::steady_clock::time_point deadline;
+};
+
+// Statistics structure
+struct Statistics {
+
+	// Number of successful handshakes
+	uint64_t numberOfSuccessfulHandshakes;
+	
+	// Number of rejected handshakes
+	uint64_t numberOfRejectedHandshakes;
+	
+	// Number of timed out handshakes
+	uint64_t numberOfTimedOutHandshakes;
+	
+	// Number of failed connections
+	uint64_t numberOfFailedConnections;
+	
+	// Number of early disconnects
+	uint64_t numberOfEarlyDisconnects;
+	
+	// Number of garbage connections
+	uint64_t numberOfGarbageConnections;
+	
+	// Number of disconnected garbage connections
+	uint64_t numberOfDisconnectedGarbageConnections;
+	
+	// Handshake latencies in microseconds
+	vector<uint32_t> handshakeLatencies;
+};
+
+
+// Constants
+
+// Check if floonet
+#ifdef ENABLE_FLOONET
+
+	// Default port
+	static const uint16_t DEFAULT_PORT = 9031;
+	
+	// Default metrics port
+	static const uint16_t DEFAULT_METRICS_PORT = 8031;
+	
+// Otherwise
+#else
+
+	// Default port
+	static const uint16_t DEFAULT_PORT = 9030;
+	
+	// Default metrics port
+	static const uint16_t DEFAULT_METRICS_PORT = 8030;
+#endif
+
+// Default user agents
+static const char *DEFAULT_USER_AGENTS = "MW/MWC 5.3.9,MW/MWC 6.0.1,MWC Validation Node 1.2.3,mwc-node-go/0.1.0,MW/MWC 6.0.1-beta,Something else entirely";
+
+// Check if genesis block hash is provided at compile time
+#ifdef GENESIS_BLOCK_HASH
+
+	// Genesis block hash usage
+	static const char *GENESIS_BLOCK_HASH_USAGE = "(default: " GENESIS_BLOCK_HASH ")";
+	
+// Otherwise
+#else
+
+	// Genesis block hash usage
+	static const char *GENESIS_BLOCK_HASH_USAGE = "(required)";
+#endif
+
+// Handshake timeout
+static const chrono::seconds HANDSHAKE_TIMEOUT(10);
+
+// Report interval
+static const chrono::seconds REPORT_INTERVAL(1);
+
+// Poll timeout in milliseconds
+static const int POLL_TIMEOUT = 10;
+
+// Max number of events
+static const int MAX_NUMBER_OF_EVENTS = 1024;
+
+// Metrics timeout
+static const chrono::seconds METRICS_TIMEOUT(2);
+
+// Max random bytes length
+static const size_t MAX_RANDOM_BYTES_LENGTH = 1024;
+
+// Onion address length
+static const size_t ONION_ADDRESS_LENGTH = 56;
+
+// Oversized message length
+static const uint64_t OVERSIZED_MESSAGE_LENGTH = UINT32_MAX;
+
+// Percentiles
+static const double PERCENTILES[] = {50, 90, 99, 99.9};
+
+// Map metrics
+static const char *MAP_METRICS[] = {
+
+	// Processed peers
+	"mwc_node_map_ingestion_processed_peers_total",
+	
+	// Dropped peers
+	"mwc_node_map_ingestion_dropped_peers_total",
+	
+	// Invalid peers
+	"mwc_node_map_ingestion_invalid_peers_total",
+	
+	// Inbound handshakes
+	"mwc_node_map_handshakes_total{direction=\"inbound\"}",
+	
+	// Unique peers
+	"mwc_node_map_unique_peers",
+	
+	// Evicted peers
+	"mwc_node_map_recent_peers_evicted_total",
+	
+	// Rejected peers
+	"mwc_node_map_recent_peers_rejected_total"
+};
+
+
+// Global variables
+
+// Random number generator
+static mt19937_64 randomNumberGenerator(random_device{}());
+
+
+// Function prototypes
+
+// Parse options
+static optional<Options> parseOptions(int argc, char *argv[]);
+
+// Display usage
+static void displayUsage(const char *programName);
+
+// Start fake peer
+static void startFakePeer(const Options &options, const int epoll, unordered_map<int, FakePeer> &fakePeers, Statistics &statistics);
+
+// Create hand message
+static vector<uint8_t> createHandMessage(const Options &options);
+
+// Create garbage
+static vector<uint8_t> createGarbage(const Options &options);
+
+// Send output
+static bool sendOutput(const int epoll, const int socket, FakePeer &fakePeer);
+
+// Receive input
+static bool receiveInput(const Options &options, const int socket, FakePeer &fakePeer, Statistics &statistics);
+
+// Close fake peer
+static void closeFakePeer(unordered_map<int, FakePeer>::iterator fakePeer, unordered_map<int, FakePeer> &fakePeers);
+
+// Get resident set size
+static optional<uint64_t> getResidentSetSize(const pid_t processId);
+
+// Scrape metrics
+static optional<unordered_map<string, double>> scrapeMetrics(const string &address, const uint16_t port);
+
+
+// Main function
+int main(int argc, char *argv[]) {
+
+	// Check if parsing options failed
+	const optional<Options> parsedOptions = parseOptions(argc, argv);
+	if(!parsedOptions.has_value()) {
+	
+		// Display usage
+		displayUsage(argv[0]);
+		
+		// Return failure
+		return EXIT_FAILURE;
+	}
+	
+	// Get options
+	const Options &options = parsedOptions.value();
+	
+	// Check if creating epoll failed
+	const int epoll = epoll_create1(EPOLL_CLOEXEC);
+	if(epoll == -1) {
+	
+		// Display message
+		cout << "Creating epoll failed" << endl;
+		
+		// Return failure
+		return EXIT_FAILURE;
+	}
+	
+	// Get map's initial resident set size and metrics
+	const optional<uint64_t> initialResidentSetSize = options.mapProcessId ? getResidentSetSize(options.mapProcessId) : nullopt;
+	const optional<unordered_map<string, double>> initialMetrics = options.metricsPort ? scrapeMetrics(options.address, options.metricsPort) : nullopt;
+	if(options.metricsPort && !initialMetrics.has_value()) {
+	
+		// Display message
+		cout << "Scraping the map's metrics failed so ingestion throughput won't be reported" << endl;
+	}
+	
+	// Display message
+	cout << "Load testing " << (options.address.find(':') != string::npos ? "[" + options.address + "]" : options.address) << ':' << options.port << " with " << options.numberOfConcurrentPeers << " concurrent peers at " << options.connectionRate << " connections/s for " << options.duration << "s" << endl;
+	
+	// Loop until the duration elapses
+	unordered_map<int, FakePeer> fakePeers;
+	Statistics statistics = {};
+	const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	const chrono::steady_clock::time_point endTime = startTime + chrono::seconds(options.duration);
+	chrono::steady_clock::time_point previousTime = startTime;
+	chrono::steady_clock::time_point nextReportTime = startTime + REPORT_INTERVAL;
+	uint64_t previousNumberOfSuccessfulHandshakes = 0;
+	uint64_t peakResidentSetSize = initialResidentSetSize.value_or(0);
+	double connectionTokens = 0;
+	for(chrono::steady_clock::time_point currentTime = startTime; currentTime < endTime; currentTime = chrono::steady_clock::now()) {
+	
+		// Add connection tokens for the elapsed time without letting them build up more than a second's worth
+		connectionTokens = min(connectionTokens + chrono::duration<double>(currentTime - previousTime).count() * options.connectionRate, max(options.connectionRate, 1.0));
+		previousTime = currentTime;
+		
+		// Loop while connection tokens exist and more fake peers can be started
+		while(connectionTokens >= 1 && fakePeers.size() < options.numberOfConcurrentPeers) {
+		
+			// Start fake peer
+			startFakePeer(options, epoll, fakePeers, statistics);
+			--connectionTokens;
+		}
+		
+		// Wait for events
+		epoll_event events[MAX_NUMBER_OF_EVENTS];
+		const int numberOfEvents = epoll_wait(epoll, events, MAX_NUMBER_OF_EVENTS, POLL_TIMEOUT);
+		
+		// Go through all events
+		for(int i = 0; i < numberOfEvents; ++i) {
+		
+			// Check if fake peer no longer exists
+			const int socket = events[i].data.fd;
+			unordered_map<int, FakePeer>::iterator fakePeer = fakePeers.find(socket);
+			if(fakePeer == fakePeers.end()) {
+			
+				// Continue
+				continue;
+			}
+			
+			// Check if fake peer is connecting
+			if(fakePeer->second.state == FakePeerState::CONNECTING) {
+			
+				// Check if connecting failed
+				int error;
+				socklen_t errorLength = sizeof(error);
+				if(getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &errorLength) || error) {
+				
+					// Increment number of failed connections
+					++statistics.numberOfFailedConnections;
+					
+					// Close fake peer
+					closeFakePeer(fakePeer, fakePeers);
+					
+					// Continue
+					continue;
+				}
+				
+				// Check if fake peer is garbage
+				if(fakePeer->second.isGarbage) {
+				
+					// Set fake peer's state to holding so that it stays connected until its deadline or until the map disconnects it
+					fakePeer->second.state = FakePeerState::HOLDING;
+					fakePeer->second.deadline = chrono::steady_clock::now() + chrono::milliseconds(static_cast<uint64_t>(exponential_distribution<double>(1 / options.meanLifetime)(randomNumberGenerator)));
+				}
+				
+				// Otherwise
+				else {
+				
+					// Set fake peer's state to handshaking
+					fakePeer->second.state = FakePeerState::HANDSHAKING;
+				}
+			}
+			
+			// Check if sending fake peer's output failed
+			if(fakePeer->second.outputOffset != fakePeer->second.output.size() && !sendOutput(epoll, socket, fakePeer->second)) {
+			
+				// Check if fake peer was handshaking
+				if(fakePeer->second.state == FakePeerState::HANDSHAKING) {
+				
+					// Increment number of rejected handshakes
+					++statistics.numberOfRejectedHandshakes;
+				}
+				
+				// Otherwise check if fake peer is garbage
+				else if(fakePeer->second.isGarbage) {
+				
+					// Increment number of disconnected garbage connections
+					++statistics.numberOfDisconnectedGarbageConnections;
+				}
+				
+				// Close fake peer
+				closeFakePeer(fakePeer, fakePeers);
+				
+				// Continue
+				continue;
+			}
+			
+			// Check if fake peer has input or was disconnected
+			if((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !receiveInput(options, socket, fakePeer->second, statistics)) {
+			
+				// Close fake peer
+				closeFakePeer(fakePeer, fakePeers);
+			}
+		}
+		
+		// Go through all fake peers
+		currentTime = chrono::steady_clock::now();
+		for(unordered_map<int, FakePeer>::iterator i = fakePeers.begin(); i != fakePeers.end();) {
+		
+			// Check if fake peer's deadline hasn't passed
+			if(currentTime < i->second.deadline) {
+			
+				// Go to next fake peer
+				++i;
+				
+				// Continue
+				continue;
+			}
+			
+			// Check if fake peer didn't connect or handshake in time
+			if(i->second.state == FakePeerState::CONNECTING) {
+			
+				// Increment number of failed connections
+				++statistics.numberOfFailedConnections;
+			}
+			
+			// Otherwise check if fake peer didn't handshake in time
+			else if(i->second.state == FakePeerState::HANDSHAKING) {
+			
+				// Increment number of timed out handshakes
+				++statistics.numberOfTimedOutHandshakes;
+			}
+			
+			// Close fake peer
+			closeFakePeer(i++, fakePeers);
+		}
+		
+		// Check if reporting progress
+		if(currentTime >= nextReportTime) {
+		
+			// Get map's resident set size
+			const optional<uint64_t> residentSetSize = options.mapProcessId ? getResidentSetSize(options.mapProcessId) : nullopt;
+			if(residentSetSize.has_value()) {
+			
+				// Update peak resident set size
+				peakResidentSetSize = max(peakResidentSetSize, residentSetSize.value());
+			}
+			
+			// Display progress
+			cout << fixed << setprecision(0) << chrono::duration<double>(currentTime - startTime).count() << "s: " << (statistics.numberOfSuccessfulHandshakes - previousNumberOfSuccessfulHandshakes) / chrono::duration<double>(REPORT_INTERVAL).count() << " handshakes/s, " << fakePeers.size() << " connected, " << statistics.numberOfRejectedHandshakes + statistics.numberOfTimedOutHandshakes + statistics.numberOfFailedConnections << " failures";
+			if(residentSetSize.has_value()) {
+			
+				// Display map's resident set size
+				cout << ", map RSS " << setprecision(1) << residentSetSize.value() / 1024.0 << " MiB";
+			}
+			cout << endl;
+			
+			// Set next report time
+			previousNumberOfSuccessfulHandshakes = statistics.numberOfSuccessfulHandshakes;
+			nextReportTime += REPORT_INTERVAL;
+		}
+	}
+	
+	// Go through all fake peers
+	for(unordered_map<int, FakePeer>::iterator i = fakePeers.begin(); i != fakePeers.end();) {
+	
+		// Close fake peer
+		closeFakePeer(i++, fakePeers);
+	}
+	
+	// Close epoll
+	close(epoll);
+	
+	// Get elapsed time
+	const double elapsedTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	
+	// Display handshake results
+	cout << endl << "Handshakes" << endl;
+	cout << "  Successful: " << statistics.numberOfSuccessfulHandshakes << " (" << setprecision(1) << statistics.numberOfSuccessfulHandshakes / elapsedTime * 60 << "/min)" << endl;
+	cout << "  Rejected: " << statistics.numberOfRejectedHandshakes << endl;
+	cout << "  Timed out: " << statistics.numberOfTimedOutHandshakes << endl;
+	cout << "  Failed connections: " << statistics.numberOfFailedConnections << endl;
+	cout << "  Disconnected before lifetime: " << statistics.numberOfEarlyDisconnects << endl;
+	cout << "  Garbage connections: " << statistics.numberOfGarbageConnections << " (" << statistics.numberOfDisconnectedGarbageConnections << " disconnected by the map)" << endl;
+	
+	// Check if handshake latencies exist
+	if(!statistics.handshakeLatencies.empty()) {
+	
+		// Sort handshake latencies
+		sort(statistics.handshakeLatencies.begin(), statistics.handshakeLatencies.end());
+		
+		// Go through all percentiles
+		cout << "  Latency:";
+		for(const double percentile : PERCENTILES) {
+		
+			// Display percentile's handshake latency
+			cout << " p" << setprecision(percentile == static_cast<uint64_t>(percentile) ? 0 : 1) << percentile << ' ' << setprecision(2) << statistics.handshakeLatencies[min(static_cast<size_t>(percentile / 100 * statistics.handshakeLatencies.size()), statistics.handshakeLatencies.size() - 1)] / 1000.0 << "ms";
+		}
+		cout << " max " << statistics.handshakeLatencies.back() / 1000.0 << "ms" << endl;
+	}
+	
+	// Check if the map's initial metrics exist
+	if(initialMetrics.has_value()) {
+	
+		// Check if scraping the map's final metrics was successful
+		const optional<unordered_map<string, double>> finalMetrics = scrapeMetrics(options.address, options.metricsPort);
+		if(finalMetrics.has_value()) {
+		
+			// Go through all map metrics
+			cout << endl << "Map ingestion" << endl;
+			for(const char *name : MAP_METRICS) {
+			
+				// Check if the map has the metric
+				const unordered_map<string, double>::const_iterator initialValue = initialMetrics.value().find(name);
+				const unordered_map<string, double>::const_iterator finalValue = finalMetrics.value().find(name);
+				if(initialValue != initialMetrics.value().end() && finalValue != finalMetrics.value().end()) {
+				
+					// Display metric's change
+					cout << "  " << name << ": " << setprecision(0) << initialValue->second << " -> " << finalValue->second << " (" << setprecision(1) << (finalValue->second - initialValue->second) / elapsedTime << "/s)" << endl;
+				}
+			}
+		}
+		
+		// Otherwise
+		else {
+		
+			// Display message
+			cout << "Scraping the map's metrics failed" << endl;
+		}
+	}
+	
+	// Check if the map's initial resident set size exists
+	if(initialResidentSetSize.has_value()) {
+	
+		// Check if getting the map's final resident set size was successful
+		const optional<uint64_t> finalResidentSetSize = getResidentSetSize(options.mapProcessId);
+		if(finalResidentSetSize.has_value()) {
+		
+			// Display memory growth
+			peakResidentSetSize = max(peakResidentSetSize, finalResidentSetSize.value());
+			cout << endl << "Map memory" << endl;
+			cout << "  RSS: " << setprecision(1) << initialResidentSetSize.value() / 1024.0 << " MiB -> " << finalResidentSetSize.value() / 1024.0 << " MiB (peak " << peakResidentSetSize / 1024.0 << " MiB, growth " << (static_cast<double>(finalResidentSetSize.value()) - static_cast<double>(initialResidentSetSize.value())) / 1024 << " MiB)" << endl;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Display message
+			cout << "Getting the map's resident set size failed" << endl;
+		}
+	}
+	
+	// Return success
+	return EXIT_SUCCESS;
+}
+
+
+// Supporting function implementation
+
+// Parse options
+optional<Options> parseOptions(int argc, char *argv[]) {
+
+	// Check if address wasn't provided
+	if(argc < 2 || string(argv[1]).starts_with("--")) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Set default options
+	Options options = {
+	
+		// Address
+		.address = argv[1],
+		
+		// Port
+		.port = DEFAULT_PORT,
+		
+		// Duration
+		.duration = 60,
+		
+		// Number of concurrent peers
+		.numberOfConcurrentPeers = 1000,
+		
+		// Connection rate
+		.connectionRate = 1000,
+		
+		// Mean lifetime
+		.meanLifetime = 1000,
+		
+		// Garbage rate
+		.garbageRate = 0.01,
+		
+		// IPv6 rate
+		.ipv6Rate = 0.2,
+		
+		// Onion rate
+		.onionRate = 0.1,
+		
+		// User agents
+		.userAgents = {},
+		
+		// Capabilities
+		.capabilities = static_cast<uint32_t>(MwcValidationNode::Node::Capabilities::NONE),
+		
+		// Base fee
+		.baseFee = MwcValidationNode::Node::DEFAULT_BASE_FEE,
+		
+		// Genesis block hash
+		.genesisBlockHash = {},
+		
+		// Spread source addresses
+		.spreadSourceAddresses = true,
+		
+		// Map process ID
+		.mapProcessId = 0,
+		
+		// Metrics port
+		.metricsPort = 0
+	};
+	
+	// Check if genesis block hash is provided at compile time
+	#ifdef GENESIS_BLOCK_HASH
+	
+		// Check if parsing genesis block hash failed
+		const optional<array<uint8_t, 32>> defaultGenesisBlockHash = PeerProtocol::parseGenesisBlockHash(GENESIS_BLOCK_HASH);
+		if(!defaultGenesisBlockHash.has_value()) {
+		
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Set genesis block hash
+		options.genesisBlockHash = defaultGenesisBlockHash.value();
+	#endif
+	
+	// Go through all arguments
+	bool hasGenesisBlockHash = options.genesisBlockHash != array<uint8_t, 32>{};
+	string userAgents = DEFAULT_USER_AGENTS;
+	for(int i = 2; i < argc; ++i) {
+	
+		// Check if argument isn't an option
+		const string argument = argv[i];
+		const size_t separator = argument.find('=');
+		if(!argument.starts_with("--") || separator == string::npos) {
+		
+			// Display message
+			cout << "Invalid argument: " << argument << endl;
+			
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Get option's name and value
+		const string name = argument.substr(sizeof("--") - sizeof('\0'), separator - (sizeof("--") - sizeof('\0')));
+		const string value = argument.substr(separator + sizeof('='));
+		
+		// Check if option is a string
+		if(name == "user-agents") {
+		
+			// Set user agents
+			userAgents = value;
+			
+			// Continue
+			continue;
+		}
+		
+		// Otherwise check if option is the genesis block hash
+		else if(name == "genesis-block-hash") {
+		
+			// Check if parsing genesis block hash failed
+			const optional<array<uint8_t, 32>> genesisBlockHash = PeerProtocol::parseGenesisBlockHash(value.c_str());
+			if(!genesisBlockHash.has_value()) {
+			
+				// Display message
+				cout << "Invalid genesis block hash" << endl;
+				
+				// Return nothing
+				return nullopt;
+			}
+			
+			// Set genesis block hash
+			options.genesisBlockHash = genesisBlockHash.value();
+			hasGenesisBlockHash = true;
+			
+			// Continue
+			continue;
+		}
+		
+		// Check if parsing option's value as a number failed
+		double number;
+		const from_chars_result result = from_chars(value.data(), value.data() + value.size(), number);
+		if(result.ec != errc() || result.ptr != value.data() + value.size() || number < 0) {
+		
+			// Display message
+			cout << "Invalid value for " << name << endl;
+			
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Check option's name
+		if(name == "port" && number && number <= UINT16_MAX) {
+		
+			// Set port
+			options.port = number;
+		}
+		else if(name == "duration" && number) {
+		
+			// Set duration
+			options.duration = number;
+		}
+		else if(name == "peers" && number >= 1) {
+		
+			// Set number of concurrent peers
+			options.numberOfConcurrentPeers = number;
+		}
+		else if(name == "rate" && number) {
+		
+			// Set connection rate
+			options.connectionRate = number;
+		}
+		else if(name == "lifetime" && number) {
+		
+			// Set mean lifetime
+			options.meanLifetime = number;
+		}
+		else if(name == "garbage-rate" && number <= 1) {
+		
+			// Set garbage rate
+			options.garbageRate = number;
+		}
+		else if(name == "ipv6-rate" && number <= 1) {
+		
+			// Set IPv6 rate
+			options.ipv6Rate = number;
+		}
+		else if(name == "onion-rate" && number <= 1) {
+		
+			// Set onion rate
+			options.onionRate = number;
+		}
+		else if(name == "capabilities" && number <= UINT32_MAX) {
+		
+			// Set capabilities
+			options.capabilities = number;
+		}
+		else if(name == "base-fee") {
+		
+			// Set base fee
+			options.baseFee = number;
+		}
+		else if(name == "spread-source-addresses" && number <= 1) {
+		
+			// Set spread source addresses
+			options.spreadSourceAddresses = number;
+		}
+		else if(name == "pid" && number) {
+		
+			// Set map process ID
+			options.mapProcessId = number;
+		}
+		else if(name == "metrics-port" && number <= UINT16_MAX) {
+		
+			// Set metrics port
+			options.metricsPort = number;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Display message
+			cout << "Invalid option: " << name << endl;
+			
+			// Return nothing
+			return nullopt;
+		}
+	}
+	
+	// Check if genesis block hash wasn't provided
+	if(!hasGenesisBlockHash) {
+	
+		// Display message
+		cout << "Genesis block hash is required" << endl;
+		
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Check if IPv6 and onion rates are too large
+	if(options.ipv6Rate + options.onionRate > 1) {
+	
+		// Display message
+		cout << "IPv6 and onion rates can't add up to more than one" << endl;
+		
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Go through all user agents
+	for(size_t start = 0, end; start <= userAgents.size(); start = end + sizeof(',')) {
+	
+		// Add user agent
+		end = min(userAgents.find(',', start), userAgents.size());
+		options.userAgents.emplace_back(userAgents.substr(start, end - start));
+	}
+	
+	// Return options
+	return options;
+}
+
+// Display usage
+void displayUsage(const char *programName) {
+
+	// Display usage
+	cout << "Usage: \"" << programName << "\" address [--option=value ...]" << endl;
+	cout << "  address                      Address that the map is listening at" << endl;
+	cout << "  --port                       Port that the map is listening at (default: " << DEFAULT_PORT << ')' << endl;
+	cout << "  --duration                   Duration in seconds (default: 60)" << endl;
+	cout << "  --peers                      Number of concurrent fake peers (default: 1000)" << endl;
+	cout << "  --rate                       Connections started per second (default: 1000)" << endl;
+	cout << "  --lifetime                   Mean milliseconds a fake peer stays connected after its handshake (default: 1000)" << endl;
+	cout << "  --garbage-rate               Fraction of connections that send malformed messages (default: 0.01)" << endl;
+	cout << "  --ipv6-rate                  Fraction of fake peers that advertise an IPv6 address (default: 0.2)" << endl;
+	cout << "  --onion-rate                 Fraction of fake peers that advertise an onion address (default: 0.1)" << endl;
+	cout << "  --user-agents                Comma separated user agents to choose from" << endl;
+	cout << "  --capabilities               Capabilities that fake peers advertise (default: 0)" << endl;
+	cout << "  --base-fee                   Base fee that fake peers advertise (default: " << MwcValidationNode::Node::DEFAULT_BASE_FEE << ')' << endl;
+	cout << "  --genesis-block-hash         Genesis block hash of the map's network " << GENESIS_BLOCK_HASH_USAGE << endl;
+	cout << "  --spread-source-addresses    Connect to an IPv4 address from random 127.0.0.0/8 addresses so that each fake peer is unique (default: 1)" << endl;
+	cout << "  --pid                        Map's process ID to report its memory growth" << endl;
+	cout << "  --metrics-port               Map's HTTP server port to report its ingestion throughput (default: none, usually " << DEFAULT_METRICS_PORT << ')' << endl;
+}
+
+// Start fake peer
+void startFakePeer(const Options &options, const int epoll, unordered_map<int, FakePeer> &fakePeers, Statistics &statistics) {
+
+	// Get map's address
+	sockaddr_storage address = {};
+	socklen_t addressLength;
+	if(inet_pton(AF_INET6, options.address.c_str(), &reinterpret_cast<sockaddr_in6 *>(&address)->sin6_addr) == 1) {
+	
+		// Set IPv6 address's family and port
+		reinterpret_cast<sockaddr_in6 *>(&address)->sin6_family = AF_INET6;
+		reinterpret_cast<sockaddr_in6 *>(&address)->sin6_port = htons(options.port);
+		addressLength = sizeof(sockaddr_in6);
+	}
+	
+	// Otherwise check if address is an IPv4 address
+	else if(inet_pton(AF_INET, options.address.c_str(), &reinterpret_cast<sockaddr_in *>(&address)->sin_addr) == 1) {
+	
+		// Set IPv4 address's family and port
+		reinterpret_cast<sockaddr_in *>(&address)->sin_family = AF_INET;
+		reinterpret_cast<sockaddr_in *>(&address)->sin_port = htons(options.port);
+		addressLength = sizeof(sockaddr_in);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Increment number of failed connections
+		++statistics.numberOfFailedConnections;
+		
+		// Return
+		return;
+	}
+	
+	// Check if creating socket failed
+	const int socket = ::socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(socket == -1) {
+	
+		// Increment number of failed connections
+		++statistics.numberOfFailedConnections;
+		
+		// Return
+		return;
+	}
+	
+	// Check if spreading source addresses and address is an IPv4 address
+	if(options.spreadSourceAddresses && address.ss_family == AF_INET) {
+	
+		// Bind socket to a random loopback address so that the map sees each fake peer as a different peer
+		sockaddr_in sourceAddress = {};
+		sourceAddress.sin_family = AF_INET;
+		sourceAddress.sin_addr.s_addr = htonl((127 << 24) | uniform_int_distribution<uint32_t>(1, 0xFFFFFE)(randomNumberGenerator));
+		bind(socket, reinterpret_cast<const sockaddr *>(&sourceAddress), sizeof(sourceAddress));
+	}
+	
+	// Check if connecting failed
+	if(connect(socket, reinterpret_cast<const sockaddr *>(&address), addressLength) && errno != EINPROGRESS) {
+	
+		// Increment number of failed connections
+		++statistics.numberOfFailedConnections;
+		
+		// Close socket
+		close(socket);
+		
+		// Return
+		return;
+	}
+	
+	// Check if adding socket to the epoll failed
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+	event.data.fd = socket;
+	if(epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &event)) {
+	
+		// Increment number of failed connections
+		++statistics.numberOfFailedConnections;
+		
+		// Close socket
+		close(socket);
+		
+		// Return
+		return;
+	}
+	
+	// Check if fake peer is garbage
+	const bool isGarbage = bernoulli_distribution(options.garbageRate)(randomNumberGenerator);
+	if(isGarbage) {
+	
+		// Increment number of garbage connections
+		++statistics.numberOfGarbageConnections;
+	}
+	
+	// Add fake peer
+	const chrono::steady_clock::time_point currentTime = chrono::steady_clock::now();
+	fakePeers.emplace(socket, FakePeer{
+	
+		// State
+		.state = FakePeerState::CONNECTING,
+		
+		// Is garbage
+		.isGarbage = isGarbage,
+		
+		// Output
+		.output = isGarbage ? createGarbage(options) : createHandMessage(options),
+		
+		// Output offset
+		.outputOffset = 0,
+		
+		// Input
+		.input = {},
+		
+		// Start time
+		.startTime = currentTime,
+		
+		// Deadline
+		.deadline = currentTime + HANDSHAKE_TIMEOUT
+	});
+}
+
+// Create hand message
+vector<uint8_t> createHandMessage(const Options &options) {
+
+	// Get sender address
+	string senderAddress;
+	const double addressType = uniform_real_distribution<double>(0, 1)(randomNumberGenerator);
+	if(addressType < options.onionRate) {
+	
+		// Set sender address to a random onion address
+		static const char BASE32_CHARACTERS[] = "abcdefghijklmnopqrstuvwxyz234567";
+		for(size_t i = 0; i < ONION_ADDRESS_LENGTH; ++i) {
+		
+			// Append random base32 character to the sender address
+			senderAddress.push_back(BASE32_CHARACTERS[uniform_int_distribution<size_t>(0, sizeof(BASE32_CHARACTERS) - sizeof('\0') - 1)(randomNumberGenerator)]);
+		}
+		senderAddress.append(".onion");
+	}
+	
+	// Otherwise check if sender address is an IPv6 address
+	else if(addressType < options.onionRate + options.ipv6Rate) {
+	
+		// Set sender address to a random global IPv6 address
+		in6_addr ipAddress;
+		for(uint8_t &byte : ipAddress.s6_addr) {
+		
+			// Set byte to a random value
+			byte = uniform_int_distribution<uint16_t>(0, UINT8_MAX)(randomNumberGenerator);
+		}
+		ipAddress.s6_addr[0] = 0x20 | (ipAddress.s6_addr[0] & 0x1F);
+		char ipAddressString[INET6_ADDRSTRLEN];
+		inet_ntop(AF_INET6, &ipAddress, ipAddressString, sizeof(ipAddressString));
+		senderAddress = string("[") + ipAddressString + "]:" + to_string(DEFAULT_PORT);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Set sender address to a random IPv4 address
+		const uint32_t ipAddress = uniform_int_distribution<uint32_t>(0x01000000, 0xDFFFFFFF)(randomNumberGenerator);
+		senderAddress = to_string(ipAddress >> 24) + '.' + to_string((ipAddress >> 16) & UINT8_MAX) + '.' + to_string((ipAddress >> 8) & UINT8_MAX) + '.' + to_string(ipAddress & UINT8_MAX) + ':' + to_string(DEFAULT_PORT);
+	}
+	
+	// Return hand message with a random user agent
+	return PeerProtocol::createHandMessage({
+	
+		// Protocol version
+		.protocolVersion = PeerProtocol::PROTOCOL_VERSION,
+		
+		// Capabilities
+		.capabilities = static_cast<MwcValidationNode::Node::Capabilities>(options.capabilities),
+		
+		// Total difficulty
+		.totalDifficulty = 0,
+		
+		// User agent
+		.userAgent = options.userAgents[uniform_int_distribution<size_t>(0, options.userAgents.size() - 1)(randomNumberGenerator)],
+		
+		// Genesis block hash
+		.genesisBlockHash = options.genesisBlockHash,
+		
+		// Base fee
+		.baseFee = options.baseFee
+		
+	}, senderAddress, options.address.find(':') != string::npos ? "[" + options.address + "]:" + to_string(options.port) : options.address + ':' + to_string(options.port), randomNumberGenerator());
+}
+
+// Create garbage
+vector<uint8_t> createGarbage(const Options &options) {
+
+	// Check garbage type
+	vector<uint8_t> garbage;
+	switch(static_cast<GarbageType>(uniform_int_distribution<int>(static_cast<int>(GarbageType::RANDOM_BYTES), static_cast<int>(GarbageType::TRUNCATED_HAND))(randomNumberGenerator))) {
+	
+		// Random bytes
+		case GarbageType::RANDOM_BYTES:
+		
+			// Set garbage to random bytes
+			garbage.resize(uniform_int_distribution<size_t>(1, MAX_RANDOM_BYTES_LENGTH)(randomNumberGenerator));
+			for(uint8_t &byte : garbage) {
+			
+				// Set byte to a random value
+				byte = uniform_int_distribution<uint16_t>(0, UINT8_MAX)(randomNumberGenerator);
+			}
+			
+			// Break
+			break;
+			
+		// Wrong magic
+		case GarbageType::WRONG_MAGIC:
+		
+			// Set garbage to a hand message with the wrong magic
+			garbage = createHandMessage(options);
+			garbage[0] ^= UINT8_MAX;
+			garbage[1] ^= UINT8_MAX;
+			
+			// Break
+			break;
+			
+		// Oversized length
+		case GarbageType::OVERSIZED_LENGTH:
+		
+			// Set garbage to a hand message with a length that's larger than any message can be
+			garbage = createHandMessage(options);
+			for(size_t i = 0; i < sizeof(OVERSIZED_MESSAGE_LENGTH); ++i) {
+			
+				// Set length's byte in big endian
+				garbage[PeerProtocol::MESSAGE_HEADER_SIZE - sizeof(OVERSIZED_MESSAGE_LENGTH) + i] = OVERSIZED_MESSAGE_LENGTH >> ((sizeof(OVERSIZED_MESSAGE_LENGTH) - i - 1) * 8);
+			}
+			
+			// Break
+			break;
+			
+		// Truncated hand
+		case GarbageType::TRUNCATED_HAND:
+		
+			// Set garbage to the first half of a hand message
+			garbage = createHandMessage(options);
+			garbage.resize(PeerProtocol::MESSAGE_HEADER_SIZE + (garbage.size() - PeerProtocol::MESSAGE_HEADER_SIZE) / 2);
+			
+			// Break
+			break;
+	}
+	
+	// Return garbage
+	return garbage;
+}
+
+// Send output
+bool sendOutput(const int epoll, const int socket, FakePeer &fakePeer) {
+
+	// Loop while output remains
+	while(fakePeer.outputOffset != fakePeer.output.size()) {
+	
+		// Check if sending output failed
+		const ssize_t bytesSent = send(socket, fakePeer.output.data() + fakePeer.outputOffset, fakePeer.output.size() - fakePeer.outputOffset, MSG_NOSIGNAL);
+		if(bytesSent == -1) {
+		
+			// Return if the socket isn't writable yet
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		
+		// Update output offset
+		fakePeer.outputOffset += bytesSent;
+	}
+	
+	// Stop waiting for the socket to be writable
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.fd = socket;
+	epoll_ctl(epoll, EPOLL_CTL_MOD, socket, &event);
+	
+	// Return true
+	return true;
+}
+
+// Receive input
+bool receiveInput(const Options &options, const int socket, FakePeer &fakePeer, Statistics &statistics) {
+
+	// Loop forever
+	while(true) {
+	
+		// Check if receiving input failed
+		uint8_t buffer[PeerProtocol::MAX_MESSAGE_LENGTH];
+		const ssize_t bytesReceived = recv(socket, buffer, sizeof(buffer), 0);
+		if(bytesReceived == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		
+			// Return true
+			return true;
+		}
+		
+		// Check if the map disconnected
+		if(bytesReceived <= 0) {
+		
+			// Check fake peer's state
+			if(fakePeer.state == FakePeerState::HANDSHAKING) {
+			
+				// Increment number of rejected handshakes
+				++statistics.numberOfRejectedHandshakes;
+			}
+			
+			// Otherwise check if fake peer is garbage
+			else if(fakePeer.isGarbage) {
+			
+				// Increment number of disconnected garbage connections
+				++statistics.numberOfDisconnectedGarbageConnections;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Increment number of early disconnects
+				++statistics.numberOfEarlyDisconnects;
+			}
+			
+			// Return false
+			return false;
+		}
+		
+		// Check if fake peer isn't handshaking
+		if(fakePeer.state != FakePeerState::HANDSHAKING) {
+		
+			// Continue to discard input
+			continue;
+		}
+		
+		// Check if message header hasn't been received
+		fakePeer.input.insert(fakePeer.input.end(), buffer, buffer + bytesReceived);
+		if(fakePeer.input.size() < PeerProtocol::MESSAGE_HEADER_SIZE) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if message header is invalid or isn't for a shake message
+		const optional<PeerProtocol::MessageHeader> messageHeader = PeerProtocol::parseMessageHeader(fakePeer.input.data());
+		if(!messageHeader.has_value() || messageHeader.value().type != PeerProtocol::MessageType::SHAKE) {
+		
+			// Increment number of rejected handshakes
+			++statistics.numberOfRejectedHandshakes;
+			
+			// Return false
+			return false;
+		}
+		
+		// Check if shake message's payload hasn't been received
+		if(fakePeer.input.size() < PeerProtocol::MESSAGE_HEADER_SIZE + messageHeader.value().length) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if parsing shake failed or the map is on a different network
+		const optional<PeerProtocol::Handshake> shake = PeerProtocol::parseHandshake(PeerProtocol::MessageType::SHAKE, vector<uint8_t>(fakePeer.input.begin() + PeerProtocol::MESSAGE_HEADER_SIZE, fakePeer.input.begin() + PeerProtocol::MESSAGE_HEADER_SIZE + messageHeader.value().length));
+		if(!shake.has_value() || shake.value().genesisBlockHash != options.genesisBlockHash) {
+		
+			// Increment number of rejected handshakes
+			++statistics.numberOfRejectedHandshakes;
+			
+			// Return false
+			return false;
+		}
+		
+		// Record handshake latency
+		const chrono::steady_clock::time_point currentTime = chrono::steady_clock::now();
+		++statistics.numberOfSuccessfulHandshakes;
+		statistics.handshakeLatencies.push_back(min<uint64_t>(chrono::duration_cast<chrono::microseconds>(currentTime - fakePeer.startTime).count(), UINT32_MAX));
+		
+		// Set fake peer's state to holding until the end of its randomly chosen lifetime
+		fakePeer.state = FakePeerState::HOLDING;
+		fakePeer.deadline = currentTime + chrono::milliseconds(static_cast<uint64_t>(exponential_distribution<double>(1 / options.meanLifetime)(randomNumberGenerator)));
+		fakePeer.input.clear();
+		fakePeer.input.shrink_to_fit();
+	}
+}
+
+// Close fake peer
+void closeFakePeer(unordered_map<int, FakePeer>::iterator fakePeer, unordered_map<int, FakePeer> &fakePeers) {
+
+	// Close socket which also removes it from the epoll
+	close(fakePeer->first);
+	
+	// Remove fake peer
+	fakePeers.erase(fakePeer);
+}
+
+// Get resident set size
+optional<uint64_t> getResidentSetSize(const pid_t processId) {
+
+	// Check if opening the process's status file failed
+	ifstream file("/proc/" + to_string(processId) + "/status");
+	if(!file) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Go through all lines in the file
+	for(string line; getline(file, line);) {
+	
+		// Check if line is the resident set size
+		if(line.starts_with("VmRSS:")) {
+		
+			// Return resident set size in kibibytes
+			return strtoull(&line[sizeof("VmRSS:") - sizeof('\0')], nullptr, 10);
+		}
+	}
+	
+	// Return nothing
+	return nullopt;
+}
+
+// Scrape metrics
+optional<unordered_map<string, double>> scrapeMetrics(const string &address, const uint16_t port) {
+
+	// Check if getting the HTTP server's address failed
+	sockaddr_storage serverAddress = {};
+	socklen_t serverAddressLength;
+	if(inet_pton(AF_INET6, address.c_str(), &reinterpret_cast<sockaddr_in6 *>(&serverAddress)->sin6_addr) == 1) {
+	
+		// Set IPv6 address's family and port
+		reinterpret_cast<sockaddr_in6 *>(&serverAddress)->sin6_family = AF_INET6;
+		reinterpret_cast<sockaddr_in6 *>(&serverAddress)->sin6_port = htons(port);
+		serverAddressLength = sizeof(sockaddr_in6);
+	}
+	else if(inet_pton(AF_INET, address.c_str(), &reinterpret_cast<sockaddr_in *>(&serverAddress)->sin_addr) == 1) {
+	
+		// Set IPv4 address's family and port
+		reinterpret_cast<sockaddr_in *>(&serverAddress)->sin_family = AF_INET;
+		reinterpret_cast<sockaddr_in *>(&serverAddress)->sin_port = htons(port);
+		serverAddressLength = sizeof(sockaddr_in);
+	}
+	else {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Check if creating socket failed
+	const int socket = ::socket(serverAddress.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(socket == -1) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Automatically close socket when done
+	const unique_ptr<const int, void(*)(const int *)> socketUniquePointer(&socket, [](const int *socket) {
+	
+		// Close socket
+		close(*socket);
+	});
+	
+	// Check if setting the socket's timeouts or connecting failed
+	const timeval timeout = {
+	
+		// Seconds
+		.tv_sec = METRICS_TIMEOUT.count(),
+		
+		// Microseconds
+		.tv_usec = 0
+	};
+	if(setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) || setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) || connect(socket, reinterpret_cast<const sockaddr *>(&serverAddress), serverAddressLength)) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Check if sending request failed
+	static const char REQUEST[] = "GET /metrics HTTP/1.0\r\n\r\n";
+	if(send(socket, REQUEST, sizeof(REQUEST) - sizeof('\0'), MSG_NOSIGNAL) != sizeof(REQUEST) - sizeof('\0')) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Loop until the HTTP server closes the connection
+	string response;
+	while(true) {
+	
+		// Check if receiving response failed
+		char buffer[4096];
+		const ssize_t bytesReceived = recv(socket, buffer, sizeof(buffer), 0);
+		if(bytesReceived == -1) {
+		
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Check if the HTTP server closed the connection
+		if(!bytesReceived) {
+		
+			// Break
+			break;
+		}
+		
+		// Append buffer to the response
+		response.append(buffer, bytesReceived);
+	}
+	
+	// Check if response isn't successful or doesn't have a body
+	const size_t bodyStart = response.find("\r\n\r\n");
+	if(!response.starts_with("HTTP/1.") || response.compare(sizeof("HTTP/1.1") - sizeof('\0'), sizeof(" 200 ") - sizeof('\0'), " 200 ") || bodyStart == string::npos) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Go through all lines in the body
+	unordered_map<string, double> metrics;
+	for(size_t start = bodyStart + sizeof("\r\n\r\n") - sizeof('\0'), end; start < response.size(); start = end + sizeof('\n')) {
+	
+		// Check if line is a sample
+		end = min(response.find('\n', start), response.size());
+		const size_t separator = response.rfind(' ', end);
+		if(response[start] != '#' && separator != string::npos && separator > start) {
+		
+			// Add sample to the metrics
+			metrics.emplace(response.substr(start, separator - start), strtod(response.substr(separator + sizeof(' '), end - separator - sizeof(' ')).c_str(), nullptr));
+		}
+	}
+	
+	// Return metrics
+	return metrics;
+}
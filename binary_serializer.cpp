@@ -0,0 +1,151 @@
+// Header files
+#include "./binary_serializer.h"
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+BinarySerializer::BinarySerializer() :
+
+	// Create buffer
+	buffer(INITIAL_CAPACITY),
+	
+	// Set size to zero
+	size(0)
+{
+}
+
+// Clear
+void BinarySerializer::clear() {
+
+	// Set size to zero
+	size = 0;
+}
+
+// Append raw
+void BinarySerializer::appendRaw(const string_view &value) {
+
+	// Append value to the buffer
+	memcpy(reserve(value.size()), value.data(), value.size());
+	size += value.size();
+}
+
+// Append varint
+void BinarySerializer::appendVarint(uint64_t value) {
+
+	// Loop while value doesn't fit in seven bits
+	uint8_t *destination = reserve(MAX_VARINT_LENGTH);
+	uint8_t *current = destination;
+	while(value >= 0x80) {
+	
+		// Append value's lowest seven bits with the continuation bit set
+		*current++ = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	
+	// Append value's last seven bits
+	*current++ = value;
+	
+	// Update size
+	size += current - destination;
+}
+
+// Append string
+void BinarySerializer::appendString(const string_view &value) {
+
+	// Append value's length and value
+	appendVarint(value.size());
+	appendRaw(value);
+}
+
+// Append fixed point or null
+void BinarySerializer::appendFixedPointOrNull(const double value) {
+
+	// Get value as a fixed point number or null if it isn't finite
+	const int32_t fixedPoint = isfinite(value) ? static_cast<int32_t>(round(value * FIXED_POINT_SCALE)) : NULL_FIXED_POINT;
+	
+	// Append fixed point number in little endian
+	uint8_t *destination = reserve(sizeof(fixedPoint));
+	for(size_t i = 0; i < sizeof(fixedPoint); ++i) {
+	
+		// Append byte
+		destination[i] = static_cast<uint32_t>(fixedPoint) >> (i * 8);
+	}
+	
+	// Update size
+	size += sizeof(fixedPoint);
+}
+
+// Get data
+const char *BinarySerializer::getData() const {
+
+	// Return buffer's data
+	return reinterpret_cast<const char *>(buffer.data());
+}
+
+// Get size
+size_t BinarySerializer::getSize() const {
+
+	// Return size
+	return size;
+}
+
+// Read varint
+bool BinarySerializer::readVarint(const uint8_t *&current, const uint8_t *end, uint64_t &value) {
+
+	// Go through all of the varint's bytes
+	value = 0;
+	for(size_t shift = 0; current != end && shift < sizeof(value) * 8; shift += 7) {
+	
+		// Add byte's lowest seven bits to the value
+		const uint8_t byte = *current++;
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		
+		// Check if byte is the last one
+		if(!(byte & 0x80)) {
+		
+			// Return true
+			return true;
+		}
+	}
+	
+	// Return false
+	return false;
+}
+
+// Read string
+bool BinarySerializer::readString(const uint8_t *&current, const uint8_t *end, string &value) {
+
+	// Check if reading string's length failed or the string is truncated
+	uint64_t length;
+	if(!readVarint(current, end, length) || static_cast<uint64_t>(end - current) < length) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Set value to the string
+	value.assign(reinterpret_cast<const char *>(current), length);
+	current += length;
+	
+	// Return true
+	return true;
+}
+
+// Reserve
+uint8_t *BinarySerializer::reserve(const size_t length) {
+
+	// Check if buffer isn't large enough
+	if(size + length > buffer.size()) {
+	
+		// Grow buffer
+		buffer.resize(max(buffer.size() * 2, size + length));
+	}
+	
+	// Return end of the buffer
+	return &buffer[size];
+}
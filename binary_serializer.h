@@ -0,0 +1,79 @@
+// Header guard
+#ifndef BINARY_SERIALIZER_H
+#define BINARY_SERIALIZER_H
+
+
+// Header files
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Binary serializer class
+class BinarySerializer final {
+
+	// Public
+	public:
+	
+		// Null fixed point
+		static const int32_t NULL_FIXED_POINT = INT32_MIN;
+		
+		// Fixed point scale
+		static constexpr const double FIXED_POINT_SCALE = 1000000;
+		
+		// Constructor
+		BinarySerializer();
+		
+		// Clear
+		void clear();
+		
+		// Append raw
+		void appendRaw(const string_view &value);
+		
+		// Append varint
+		void appendVarint(uint64_t value);
+		
+		// Append string
+		void appendString(const string_view &value);
+		
+		// Append fixed point or null
+		void appendFixedPointOrNull(const double value);
+		
+		// Get data
+		const char *getData() const;
+		
+		// Get size
+		size_t getSize() const;
+		
+		// Read varint
+		static bool readVarint(const uint8_t *&current, const uint8_t *end, uint64_t &value);
+		
+		// Read string
+		static bool readString(const uint8_t *&current, const uint8_t *end, string &value);
+		
+	// Private
+	private:
+	
+		// Initial capacity
+		static const size_t INITIAL_CAPACITY = 16 * 1024;
+		
+		// Max varint length
+		static const size_t MAX_VARINT_LENGTH = 10;
+		
+		// Reserve
+		uint8_t *reserve(const size_t length);
+		
+		// Buffer
+		vector<uint8_t> buffer;
+		
+		// Size
+		size_t size;
+};
+
+
+#endif
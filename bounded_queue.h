@@ -0,0 +1,200 @@
+// Header guard
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+
+// Header files
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+using namespace std;
+
+
+// Classes
+
+// Bounded queue class (lock-free multi-producer multi-consumer queue with a fixed capacity)
+template<typename Type, size_t capacity> class BoundedQueue final {
+
+	// Check if capacity isn't a power of two
+	static_assert(capacity && !(capacity & (capacity - 1)), "Capacity must be a power of two");
+	
+	// Public
+	public:
+	
+		// Constructor
+		BoundedQueue();
+		
+		// Copy constructor
+		BoundedQueue(const BoundedQueue &other) = delete;
+		
+		// Copy assignment operator
+		BoundedQueue &operator=(const BoundedQueue &other) = delete;
+		
+		// Push
+		bool push(const Type &value);
+		
+		// Pop
+		bool pop(Type &value);
+		
+		// Size
+		size_t size() const;
+		
+	// Private
+	private:
+	
+		// Cache line size
+		static const size_t CACHE_LINE_SIZE = 64;
+		
+		// Cell structure
+		struct Cell {
+		
+			// Sequence
+			atomic<size_t> sequence;
+			
+			// Value
+			Type value;
+		};
+		
+		// Cells
+		const unique_ptr<Cell[]> cells;
+		
+		// Enqueue position
+		alignas(CACHE_LINE_SIZE) atomic<size_t> enqueuePosition;
+		
+		// Dequeue position
+		alignas(CACHE_LINE_SIZE) atomic<size_t> dequeuePosition;
+};
+
+
+// Supporting function implementation
+
+// Constructor
+template<typename Type, size_t capacity> BoundedQueue<Type, capacity>::BoundedQueue() :
+
+	// Create cells
+	cells(make_unique<Cell[]>(capacity)),
+	
+	// Set enqueue position to zero
+	enqueuePosition(0),
+	
+	// Set dequeue position to zero
+	dequeuePosition(0)
+{
+
+	// Go through all cells
+	for(size_t i = 0; i < capacity; ++i) {
+	
+		// Set cell's sequence to its index
+		cells[i].sequence.store(i, memory_order_relaxed);
+	}
+}
+
+// Push
+template<typename Type, size_t capacity> bool BoundedQueue<Type, capacity>::push(const Type &value) {
+
+	// Loop until a cell is claimed
+	size_t position = enqueuePosition.load(memory_order_relaxed);
+	Cell *cell;
+	while(true) {
+	
+		// Get cell at the position
+		cell = &cells[position & (capacity - 1)];
+		
+		// Check if cell is free
+		const size_t sequence = cell->sequence.load(memory_order_acquire);
+		if(sequence == position) {
+		
+			// Check if claiming the cell was successful
+			if(enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+			
+				// Break
+				break;
+			}
+		}
+		
+		// Otherwise check if queue is full
+		else if(static_cast<ptrdiff_t>(sequence - position) < 0) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Get updated position
+			position = enqueuePosition.load(memory_order_relaxed);
+		}
+	}
+	
+	// Set cell's value
+	cell->value = value;
+	
+	// Publish the cell to consumers
+	cell->sequence.store(position + 1, memory_order_release);
+	
+	// Return true
+	return true;
+}
+
+// Pop
+template<typename Type, size_t capacity> bool BoundedQueue<Type, capacity>::pop(Type &value) {
+
+	// Loop until a cell is claimed
+	size_t position = dequeuePosition.load(memory_order_relaxed);
+	Cell *cell;
+	while(true) {
+	
+		// Get cell at the position
+		cell = &cells[position & (capacity - 1)];
+		
+		// Check if cell is published
+		const size_t sequence = cell->sequence.load(memory_order_acquire);
+		if(sequence == position + 1) {
+		
+			// Check if claiming the cell was successful
+			if(dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+			
+				// Break
+				break;
+			}
+		}
+		
+		// Otherwise check if queue is empty
+		else if(static_cast<ptrdiff_t>(sequence - (position + 1)) < 0) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Get updated position
+			position = dequeuePosition.load(memory_order_relaxed);
+		}
+	}
+	
+	// Get cell's value
+	value = cell->value;
+	
+	// Free the cell for producers
+	cell->sequence.store(position + capacity, memory_order_release);
+	
+	// Return true
+	return true;
+}
+
+// Size
+template<typename Type, size_t capacity> size_t BoundedQueue<Type, capacity>::size() const {
+
+	// Return approximate number of values in the queue
+	const size_t currentDequeuePosition = dequeuePosition.load(memory_order_relaxed);
+	const size_t currentEnqueuePosition = enqueuePosition.load(memory_order_relaxed);
+	return (currentEnqueuePosition > currentDequeuePosition) ? currentEnqueuePosition - currentDequeuePosition : 0;
+}
+
+
+#endif
@@ -0,0 +1,75 @@
+// Header files
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include "./file_writer.h"
+#include <memory>
+#include <stdexcept>
+#include "zlib.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Write
+void FileWriter::write(const string &location, const char *data, const size_t size) {
+
+	// Get temporary location
+	const string temporaryLocation = location + ".tmp";
+	
+	// Set temporary file to throw an exception on error
+	ofstream fout;
+	fout.exceptions(ios::badbit | ios::failbit);
+	
+	// Create temporary file
+	fout.open(temporaryLocation, ios::binary | ios::trunc);
+	
+	// Write data to the temporary file
+	fout.write(data, size);
+	
+	// Close temporary file
+	fout.close();
+	
+	// Replace file with the temporary file
+	filesystem::rename(temporaryLocation, location);
+}
+
+// Compress
+void FileWriter::compress(vector<char> &compressedData, const char *data, const size_t size) {
+
+	// Check if initializing compression failed
+	z_stream stream = {};
+	if(deflateInit2(&stream, COMPRESSION_LEVEL, Z_DEFLATED, GZIP_WINDOW_BITS, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+	
+		// Throw exception
+		throw runtime_error("Initializing compression failed");
+	}
+	
+	// Automatically end compression when done
+	const unique_ptr<z_stream, decltype(&deflateEnd)> streamUniquePointer(&stream, deflateEnd);
+	
+	// Check if data is too large to compress at once
+	if(size > UINT_MAX) {
+	
+		// Throw exception
+		throw runtime_error("Data is too large to compress");
+	}
+	
+	// Make compressed data large enough for the worst case
+	compressedData.resize(deflateBound(&stream, size));
+	
+	// Check if compressing data failed
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+	stream.avail_in = size;
+	stream.next_out = reinterpret_cast<Bytef *>(compressedData.data());
+	stream.avail_out = compressedData.size();
+	if(deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+	
+		// Throw exception
+		throw runtime_error("Compressing data failed");
+	}
+	
+	// Shrink compressed data to its actual size
+	compressedData.resize(stream.total_out);
+}
@@ -0,0 +1,45 @@
+// Header guard
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+
+// Header files
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// File writer class
+class FileWriter final {
+
+	// Public
+	public:
+	
+		// Constructor
+		FileWriter() = delete;
+		
+		// Write
+		static void write(const string &location, const char *data, const size_t size);
+		
+		// Compress
+		static void compress(vector<char> &compressedData, const char *data, const size_t size);
+		
+	// Private
+	private:
+	
+		// Compression level
+		static const int COMPRESSION_LEVEL = 9;
+		
+		// Gzip window bits
+		static const int GZIP_WINDOW_BITS = 15 + 16;
+		
+		// Memory level
+		static const int MEMORY_LEVEL = 8;
+};
+
+
+#endif
@@ -0,0 +1,38 @@
+// Header guard
+#ifndef GEOLOCATION_H
+#define GEOLOCATION_H
+
+
+// Header files
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+
+// Structures
+
+// Geolocation structure
+struct Geolocation {
+
+	// Continent
+	string continent;
+	
+	// Country
+	string country;
+	
+	// Subdivision
+	string subdivision;
+	
+	// City
+	string city;
+	
+	// Longitude
+	double longitude = NAN;
+	
+	// Latitude
+	double latitude = NAN;
+};
+
+
+#endif
@@ -0,0 +1,381 @@
+// Header files
+#include <arpa/inet.h>
+#include "./geolocation_index.h"
+#include "./geolocation_service.h"
+#include <netinet/in.h>
+#include <stdexcept>
+
+using namespace std;
+
+
+// Constants
+
+// IPv4 address length in bits
+static const uint8_t IPV4_ADDRESS_LENGTH = 32;
+
+// IPv6 address length in bits
+static const uint8_t IPV6_ADDRESS_LENGTH = 128;
+
+// IPv4 subtree prefix length in an IPv6 database
+static const uint8_t IPV4_SUBTREE_PREFIX_LENGTH = 96;
+
+
+// Supporting function implementation
+
+// Constructor
+GeolocationIndex::GeolocationIndex(const MMDB_s &ipGeolocateDatabase) {
+
+	// Add empty string so that missing fields have the first string ID
+	getStringId("");
+	
+	// Find the IPv4 start record
+	uint64_t ipv4StartRecord;
+	uint8_t ipv4StartRecordType;
+	MMDB_entry_s ipv4StartRecordEntry;
+	findIpv4StartRecord(ipGeolocateDatabase, ipv4StartRecord, ipv4StartRecordType, ipv4StartRecordEntry);
+	
+	// Check IPv4 start record's type
+	switch(ipv4StartRecordType) {
+	
+		// Search node
+		case MMDB_RECORD_TYPE_SEARCH_NODE:
+		
+			// Add IPv4 ranges from the IPv4 search tree
+			addRanges<uint32_t>(ipGeolocateDatabase, ipv4StartRecord, 0, 0, UINT64_MAX, ipv4RangeStarts, ipv4RangeLocationIds);
+			
+			// Break
+			break;
+			
+		// Data
+		case MMDB_RECORD_TYPE_DATA:
+		
+			// Add IPv4 range that covers all IPv4 addresses
+			addRange<uint32_t>(0, getLocationId(ipv4StartRecordEntry), ipv4RangeStarts, ipv4RangeLocationIds);
+			
+			// Break
+			break;
+			
+		// Empty
+		case MMDB_RECORD_TYPE_EMPTY:
+		
+			// Add IPv4 range that covers all IPv4 addresses
+			addRange<uint32_t>(0, NO_LOCATION_ID, ipv4RangeStarts, ipv4RangeLocationIds);
+			
+			// Break
+			break;
+			
+		// Default
+		default:
+		
+			// Throw exception
+			throw runtime_error("IP geolocate database is corrupt");
+	}
+	
+	// Check if database contains IPv6 addresses
+	if(ipGeolocateDatabase.metadata.ip_version == 6) {
+	
+		// Add IPv6 ranges from the search tree while replacing subtrees that alias the IPv4 search tree with references to it
+		addRanges<Ipv6Address>(ipGeolocateDatabase, 0, 0, 0, (ipv4StartRecordType == MMDB_RECORD_TYPE_SEARCH_NODE) ? ipv4StartRecord : UINT64_MAX, ipv6RangeStarts, ipv6RangeLocationIds);
+	}
+	
+	// Free memory that's only used while building
+	ipv4RangeStarts.shrink_to_fit();
+	ipv4RangeLocationIds.shrink_to_fit();
+	ipv6RangeStarts.shrink_to_fit();
+	ipv6RangeLocationIds.shrink_to_fit();
+	locations.shrink_to_fit();
+	strings.shrink_to_fit();
+	unordered_map<uint32_t, uint32_t>().swap(locationIds);
+	unordered_map<string, uint32_t>().swap(stringIds);
+}
+
+// Geolocate
+Geolocation GeolocationIndex::geolocate(const sockaddr_storage &ipAddress) const {
+
+	// Check if IP address is an IPv4 address
+	if(ipAddress.ss_family == AF_INET) {
+	
+		// Return geolocation of the IPv4 range that contains the IP address
+		return getGeolocation(ipv4RangeLocationIds[findRange(ipv4RangeStarts, ntohl(reinterpret_cast<const sockaddr_in *>(&ipAddress)->sin_addr.s_addr))]);
+	}
+	
+	// Check if IPv6 ranges don't exist
+	if(ipv6RangeStarts.empty()) {
+	
+		// Return no geolocation
+		return Geolocation();
+	}
+	
+	// Get IPv6 address as an integer
+	Ipv6Address address = 0;
+	for(const uint8_t byte : reinterpret_cast<const sockaddr_in6 *>(&ipAddress)->sin6_addr.s6_addr) {
+	
+		// Append byte to the address
+		address = (address << 8) | byte;
+	}
+	
+	// Check if the IPv6 range that contains the IP address is an alias of the IPv4 search tree
+	const uint32_t locationId = ipv6RangeLocationIds[findRange(ipv6RangeStarts, address)];
+	if(locationId != NO_LOCATION_ID && (locationId & IPV4_ALIAS_LOCATION_ID)) {
+	
+		// Return geolocation of the IPv4 range that contains the IPv4 address that follows the alias's prefix
+		const uint8_t prefixLength = locationId & ~IPV4_ALIAS_LOCATION_ID;
+		return getGeolocation(ipv4RangeLocationIds[findRange(ipv4RangeStarts, static_cast<uint32_t>(address >> (IPV6_ADDRESS_LENGTH - prefixLength - IPV4_ADDRESS_LENGTH)))]);
+	}
+	
+	// Return geolocation
+	return getGeolocation(locationId);
+}
+
+// Get number of ranges
+size_t GeolocationIndex::getNumberOfRanges() const {
+
+	// Return number of ranges
+	return ipv4RangeStarts.size() + ipv6RangeStarts.size();
+}
+
+// Get number of locations
+size_t GeolocationIndex::getNumberOfLocations() const {
+
+	// Return number of locations
+	return locations.size();
+}
+
+// Find IPv4 start record
+void GeolocationIndex::findIpv4StartRecord(const MMDB_s &ipGeolocateDatabase, uint64_t &record, uint8_t &recordType, MMDB_entry_s &recordEntry) const {
+
+	// Set record to the root node
+	record = 0;
+	recordType = MMDB_RECORD_TYPE_SEARCH_NODE;
+	
+	// Check if database only contains IPv4 addresses
+	if(ipGeolocateDatabase.metadata.ip_version != 6) {
+	
+		// Return
+		return;
+	}
+	
+	// Go through the IPv4 subtree's prefix which is all zeros
+	for(uint8_t i = 0; i < IPV4_SUBTREE_PREFIX_LENGTH && recordType == MMDB_RECORD_TYPE_SEARCH_NODE; ++i) {
+	
+		// Check if reading node failed
+		MMDB_search_node_s node;
+		if(MMDB_read_node(&ipGeolocateDatabase, record, &node) != MMDB_SUCCESS) {
+		
+			// Throw exception
+			throw runtime_error("Reading IP geolocate database node failed");
+		}
+		
+		// Set record to the node's left record
+		record = node.left_record;
+		recordType = node.left_record_type;
+		recordEntry = node.left_record_entry;
+	}
+}
+
+// Add ranges
+template<typename Type> void GeolocationIndex::addRanges(const MMDB_s &ipGeolocateDatabase, const uint64_t node, const Type prefix, const uint8_t depth, const uint64_t ipv4StartNode, vector<Type> &rangeStarts, vector<uint32_t> &rangeLocationIds) {
+
+	// Check if reading node failed
+	MMDB_search_node_s searchNode;
+	if(MMDB_read_node(&ipGeolocateDatabase, node, &searchNode) != MMDB_SUCCESS) {
+	
+		// Throw exception
+		throw runtime_error("Reading IP geolocate database node failed");
+	}
+	
+	// Go through the node's left and right records in address order
+	for(const bool isRight : {false, true}) {
+	
+		// Get record's prefix
+		const Type recordPrefix = prefix | (static_cast<Type>(isRight) << (sizeof(Type) * 8 - depth - 1));
+		
+		// Check record's type
+		switch(isRight ? searchNode.right_record_type : searchNode.left_record_type) {
+		
+			// Search node
+			case MMDB_RECORD_TYPE_SEARCH_NODE:
+			
+				// Check if record is the IPv4 search tree
+				if((isRight ? searchNode.right_record : searchNode.left_record) == ipv4StartNode && depth + 1 <= IPV4_SUBTREE_PREFIX_LENGTH) {
+				
+					// Add range that aliases the IPv4 search tree
+					addRange(recordPrefix, IPV4_ALIAS_LOCATION_ID | (depth + 1), rangeStarts, rangeLocationIds);
+				}
+				
+				// Otherwise check if search tree is deeper than an address
+				else if(depth >= sizeof(Type) * 8 - 1) {
+				
+					// Throw exception
+					throw runtime_error("IP geolocate database is corrupt");
+				}
+				
+				// Otherwise
+				else {
+				
+					// Add ranges from the record's node
+					addRanges(ipGeolocateDatabase, isRight ? searchNode.right_record : searchNode.left_record, recordPrefix, depth + 1, ipv4StartNode, rangeStarts, rangeLocationIds);
+				}
+				
+				// Break
+				break;
+				
+			// Data
+			case MMDB_RECORD_TYPE_DATA:
+			
+				// Add range for the record's location
+				addRange(recordPrefix, getLocationId(isRight ? searchNode.right_record_entry : searchNode.left_record_entry), rangeStarts, rangeLocationIds);
+				
+				// Break
+				break;
+				
+			// Empty
+			case MMDB_RECORD_TYPE_EMPTY:
+			
+				// Add range without a location
+				addRange(recordPrefix, NO_LOCATION_ID, rangeStarts, rangeLocationIds);
+				
+				// Break
+				break;
+				
+			// Default
+			default:
+			
+				// Throw exception
+				throw runtime_error("IP geolocate database is corrupt");
+		}
+	}
+}
+
+// Add range
+template<typename Type> void GeolocationIndex::addRange(const Type rangeStart, const uint32_t locationId, vector<Type> &rangeStarts, vector<uint32_t> &rangeLocationIds) {
+
+	// Check if range continues the previous range
+	if(!rangeLocationIds.empty() && rangeLocationIds.back() == locationId) {
+	
+		// Return
+		return;
+	}
+	
+	// Add range
+	rangeStarts.push_back(rangeStart);
+	rangeLocationIds.push_back(locationId);
+}
+
+// Get location ID
+uint32_t GeolocationIndex::getLocationId(MMDB_entry_s &entry) {
+
+	// Check if entry's location was already added
+	const unordered_map<uint32_t, uint32_t>::const_iterator locationId = locationIds.find(entry.offset);
+	if(locationId != locationIds.end()) {
+	
+		// Return location ID
+		return locationId->second;
+	}
+	
+	// Check if there's too many locations
+	if(locations.size() >= IPV4_ALIAS_LOCATION_ID) {
+	
+		// Throw exception
+		throw runtime_error("IP geolocate database has too many locations");
+	}
+	
+	// Get entry's geolocation
+	Geolocation geolocation = GeolocationService::getGeolocation(entry);
+	
+	// Add location
+	locations.push_back({
+	
+		// Continent ID
+		.continentId = getStringId(move(geolocation.continent)),
+		
+		// Country ID
+		.countryId = getStringId(move(geolocation.country)),
+		
+		// Subdivision ID
+		.subdivisionId = getStringId(move(geolocation.subdivision)),
+		
+		// City ID
+		.cityId = getStringId(move(geolocation.city)),
+		
+		// Longitude
+		.longitude = geolocation.longitude,
+		
+		// Latitude
+		.latitude = geolocation.latitude
+	});
+	
+	// Return location ID
+	return locationIds.emplace(entry.offset, locations.size() - 1).first->second;
+}
+
+// Get string ID
+uint32_t GeolocationIndex::getStringId(string &&value) {
+
+	// Check if string was already added
+	const unordered_map<string, uint32_t>::const_iterator stringId = stringIds.find(value);
+	if(stringId != stringIds.end()) {
+	
+		// Return string ID
+		return stringId->second;
+	}
+	
+	// Add string
+	strings.push_back(value);
+	
+	// Return string ID
+	return stringIds.emplace(move(value), strings.size() - 1).first->second;
+}
+
+// Find range
+template<typename Type> size_t GeolocationIndex::findRange(const vector<Type> &rangeStarts, const Type address) {
+
+	// Go through halves of the range starts without branching since the first range always starts at zero
+	const Type *base = rangeStarts.data();
+	for(size_t length = rangeStarts.size(); length > 1; length -= length / 2) {
+	
+		// Prefetch both of the next possible midpoints
+		__builtin_prefetch(&base[length / 4]);
+		__builtin_prefetch(&base[length / 2 + length / 4]);
+		
+		// Move base to the midpoint if the midpoint's range starts at or before the address
+		base = (base[length / 2] <= address) ? &base[length / 2] : base;
+	}
+	
+	// Return index of the last range that starts at or before the address
+	return base - rangeStarts.data();
+}
+
+// Get geolocation
+Geolocation GeolocationIndex::getGeolocation(const uint32_t locationId) const {
+
+	// Check if location doesn't exist
+	if(locationId == NO_LOCATION_ID) {
+	
+		// Return no geolocation
+		return Geolocation();
+	}
+	
+	// Return location's geolocation
+	const Location &location = locations[locationId];
+	return {
+	
+		// Continent
+		.continent = strings[location.continentId],
+		
+		// Country
+		.country = strings[location.countryId],
+		
+		// Subdivision
+		.subdivision = strings[location.subdivisionId],
+		
+		// City
+		.city = strings[location.cityId],
+		
+		// Longitude
+		.longitude = location.longitude,
+		
+		// Latitude
+		.latitude = location.latitude
+	};
+}
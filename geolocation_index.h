@@ -0,0 +1,119 @@
+// Header guard
+#ifndef GEOLOCATION_INDEX_H
+#define GEOLOCATION_INDEX_H
+
+
+// Header files
+#include <cstdint>
+#include "./geolocation.h"
+#include "maxminddb.h"
+#include <string>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Geolocation index class (a flattened copy of the IP geolocate database's search tree that only keeps the fields that are published)
+class GeolocationIndex final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit GeolocationIndex(const MMDB_s &ipGeolocateDatabase);
+		
+		// Geolocate
+		Geolocation geolocate(const sockaddr_storage &ipAddress) const;
+		
+		// Get number of ranges
+		size_t getNumberOfRanges() const;
+		
+		// Get number of locations
+		size_t getNumberOfLocations() const;
+		
+	// Private
+	private:
+	
+		// IPv6 address type
+		typedef unsigned __int128 Ipv6Address;
+		
+		// Location structure
+		struct Location {
+		
+			// Continent ID
+			uint32_t continentId;
+			
+			// Country ID
+			uint32_t countryId;
+			
+			// Subdivision ID
+			uint32_t subdivisionId;
+			
+			// City ID
+			uint32_t cityId;
+			
+			// Longitude
+			double longitude;
+			
+			// Latitude
+			double latitude;
+		};
+		
+		// No location ID
+		static const uint32_t NO_LOCATION_ID = UINT32_MAX;
+		
+		// IPv4 alias location ID (marks an IPv6 range that the database aliases to its IPv4 search tree, the low bits are the range's prefix length)
+		static const uint32_t IPV4_ALIAS_LOCATION_ID = 0x80000000;
+		
+		// Find IPv4 start record
+		void findIpv4StartRecord(const MMDB_s &ipGeolocateDatabase, uint64_t &record, uint8_t &recordType, MMDB_entry_s &recordEntry) const;
+		
+		// Add ranges
+		template<typename Type> void addRanges(const MMDB_s &ipGeolocateDatabase, const uint64_t node, const Type prefix, const uint8_t depth, const uint64_t ipv4StartNode, vector<Type> &rangeStarts, vector<uint32_t> &rangeLocationIds);
+		
+		// Add range
+		template<typename Type> static void addRange(const Type rangeStart, const uint32_t locationId, vector<Type> &rangeStarts, vector<uint32_t> &rangeLocationIds);
+		
+		// Get location ID
+		uint32_t getLocationId(MMDB_entry_s &entry);
+		
+		// Get string ID
+		uint32_t getStringId(string &&value);
+		
+		// Find range
+		template<typename Type> static size_t findRange(const vector<Type> &rangeStarts, const Type address);
+		
+		// Get geolocation
+		Geolocation getGeolocation(const uint32_t locationId) const;
+		
+		// IPv4 range starts
+		vector<uint32_t> ipv4RangeStarts;
+		
+		// IPv4 range location IDs
+		vector<uint32_t> ipv4RangeLocationIds;
+		
+		// IPv6 range starts
+		vector<Ipv6Address> ipv6RangeStarts;
+		
+		// IPv6 range location IDs
+		vector<uint32_t> ipv6RangeLocationIds;
+		
+		// Locations
+		vector<Location> locations;
+		
+		// Strings
+		vector<string> strings;
+		
+		// Location IDs (only used while building)
+		unordered_map<uint32_t, uint32_t> locationIds;
+		
+		// String IDs (only used while building)
+		unordered_map<string, uint32_t> stringIds;
+};
+
+
+#endif
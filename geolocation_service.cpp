@@ -0,0 +1,433 @@
+// Header files
+#include <arpa/inet.h>
+#include <memory>
+#include "./geolocation_service.h"
+#include "./node/mwc_validation_node.h"
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+
+// Constants
+
+// Min longitude
+static const double MIN_LONGITUDE = -180;
+
+// Max longitude
+static const double MAX_LONGITUDE = 180;
+
+// Min latitude
+static const double MIN_LATITUDE = -90;
+
+// Max latitude
+static const double MAX_LATITUDE = 90;
+
+
+// Supporting function implementation
+
+// Constructor
+GeolocationService::GeolocationService(const char *databaseLocation, Logger &logger, const bool useIndex) :
+
+	// Set database location to database location
+	databaseLocation(databaseLocation),
+	
+	// Set logger to logger
+	logger(logger),
+	
+	// Set use index to use index
+	useIndex(useIndex),
+	
+	// Set database to nothing
+	database(nullptr),
+	
+	// Set epoch to zero
+	epoch(0),
+	
+	// Set readers to zero
+	readers{0, 0},
+	
+	// Set indexed to false
+	indexed(false),
+	
+	// Set reloading to false
+	reloading(false)
+{
+
+	// Set database to the opened database if it exists without waiting for it to be indexed
+	database.store(openDatabase(false));
+	
+	// Check if using an index and the database exists
+	if(useIndex && database.load()) {
+	
+		// Set reloading to true
+		reloading.store(true);
+		
+		// Create reloader to replace the database with an indexed one
+		reloader = thread(&GeolocationService::reload, this);
+	}
+}
+
+// Destructor
+GeolocationService::~GeolocationService() {
+
+	// Check if reloader is running
+	if(reloader.joinable()) {
+	
+		// Wait for reloader to finish
+		reloader.join();
+	}
+	
+	// Close database
+	closeDatabase(database.load());
+}
+
+// Geolocate
+Geolocation GeolocationService::geolocate(const string &address) const {
+
+	// Initialize geolocation
+	Geolocation geolocation;
+	
+	// Initialize IP address
+	sockaddr_storage ipAddress;
+	
+	// Check if address is an IPv6 address and port
+	if(address.starts_with('[') && address.contains(']')) {
+	
+		// Get address without port
+		const string addressWithoutPort = address.substr(sizeof('['), address.find(']') - sizeof('['));
+		
+		// Check if parsing the address without port as an IPv6 address was successful
+		if(inet_pton(AF_INET6, addressWithoutPort.c_str(), &reinterpret_cast<sockaddr_in6 *>(&ipAddress)->sin6_addr) == 1) {
+		
+			// Set IP address's family to IPv6
+			ipAddress.ss_family = AF_INET6;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Return geolocation
+			return geolocation;
+		}
+	}
+	
+	// Otherwise check if address is an IPv4 address and port
+	else if(address.contains(':')) {
+	
+		// Get address without port
+		const string addressWithoutPort = address.substr(0, address.find(':'));
+		
+		// Check if parsing the address without port as an IPv4 address was successful
+		if(inet_pton(AF_INET, addressWithoutPort.c_str(), &reinterpret_cast<sockaddr_in *>(&ipAddress)->sin_addr) == 1) {
+		
+			// Set IP address's family to IPv4
+			ipAddress.ss_family = AF_INET;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Return geolocation
+			return geolocation;
+		}
+	}
+	
+	// Otherwise
+	else {
+	
+		// Return geolocation
+		return geolocation;
+	}
+	
+	// Loop until registered as a reader of the current epoch
+	uint64_t currentEpoch;
+	while(true) {
+	
+		// Add reader to the current epoch's readers
+		currentEpoch = epoch.load();
+		++readers[currentEpoch % size(readers)];
+		
+		// Check if the epoch didn't change while adding the reader
+		if(epoch.load() == currentEpoch) {
+		
+			// Break
+			break;
+		}
+		
+		// Remove reader from the epoch's readers
+		--readers[currentEpoch % size(readers)];
+	}
+	
+	// Automatically remove reader from the current epoch's readers when done
+	const unique_ptr<atomic<uint64_t>, void(*)(atomic<uint64_t> *)> readerUniquePointer(&readers[currentEpoch % size(readers)], [](atomic<uint64_t> *reader) {
+	
+		// Remove reader
+		--*reader;
+	});
+	
+	// Check if the IP geolocate database isn't open
+	Database *currentDatabase = database.load();
+	if(!currentDatabase) {
+	
+		// Throw exception
+		throw runtime_error("Opening the IP geolocate database failed");
+	}
+	
+	// Check if the database is indexed
+	if(currentDatabase->index) {
+	
+		// Return geolocation from the index
+		return currentDatabase->index->geolocate(ipAddress);
+	}
+	
+	// Check if looking up the IP address in the IP geolocate database failed
+	int error;
+	MMDB_lookup_result_s ipGeolocateResult = MMDB_lookup_sockaddr(&currentDatabase->ipGeolocateDatabase, reinterpret_cast<const sockaddr *>(&ipAddress), &error);
+	if(error != MMDB_SUCCESS) {
+	
+		// Throw exception
+		throw runtime_error("Looking up the IP address in the IP geolocate database failed");
+	}
+	
+	// Check if IP address doesn't exist in the IP geolocate database
+	if(!ipGeolocateResult.found_entry) {
+	
+		// Return geolocation
+		return geolocation;
+	}
+	
+	// Return IP geolocate result's geolocation
+	return getGeolocation(ipGeolocateResult.entry);
+}
+
+// Reload if changed
+bool GeolocationService::reloadIfChanged() {
+
+	// Check if already reloading
+	if(reloading.load()) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if getting the database's file info failed
+	struct stat fileInfo;
+	if(stat(databaseLocation.c_str(), &fileInfo)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if the database is open and its file didn't change
+	Database *currentDatabase = database.load();
+	if(currentDatabase && currentDatabase->fileInfo.st_dev == fileInfo.st_dev && currentDatabase->fileInfo.st_ino == fileInfo.st_ino && currentDatabase->fileInfo.st_size == fileInfo.st_size && currentDatabase->fileInfo.st_mtim.tv_sec == fileInfo.st_mtim.tv_sec && currentDatabase->fileInfo.st_mtim.tv_nsec == fileInfo.st_mtim.tv_nsec) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if the previous reloader finished
+	if(reloader.joinable()) {
+	
+		// Wait for previous reloader to finish
+		reloader.join();
+	}
+	
+	// Set reloading to true
+	reloading.store(true);
+	
+	// Create reloader so that the database is opened and indexed in the background
+	reloader = thread(&GeolocationService::reload, this);
+	
+	// Return true
+	return true;
+}
+
+// Is indexed
+bool GeolocationService::isIndexed() const {
+
+	// Return if indexed
+	return indexed.load();
+}
+
+// Is reloading
+bool GeolocationService::isReloading() const {
+
+	// Return if reloading
+	return reloading.load();
+}
+
+// Get geolocation
+Geolocation GeolocationService::getGeolocation(MMDB_entry_s &entry) {
+
+	// Initialize geolocation
+	Geolocation geolocation;
+	
+	// Check if getting the entry's continent was successful
+	MMDB_entry_data_s ipGeolocateEntryData;
+	if(MMDB_get_value(&entry, &ipGeolocateEntryData, "continent", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
+	
+		// Set geolocation's continent to the result
+		geolocation.continent = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
+	}
+	
+	// Check if getting the entry's country was successful
+	if(MMDB_get_value(&entry, &ipGeolocateEntryData, "country", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
+	
+		// Set geolocation's country to the result
+		geolocation.country = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
+	}
+	
+	// Check if getting the entry's subdivision was successful
+	if(MMDB_get_value(&entry, &ipGeolocateEntryData, "subdivisions", "0", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
+	
+		// Set geolocation's subdivision to the result
+		geolocation.subdivision = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
+	}
+	
+	// Check if getting the entry's city was successful
+	if(MMDB_get_value(&entry, &ipGeolocateEntryData, "city", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
+	
+		// Set geolocation's city to the result
+		geolocation.city = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
+	}
+	
+	// Check if getting the entry's longitude was successful
+	if(MMDB_get_value(&entry, &ipGeolocateEntryData, "location", "longitude", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_DOUBLE && isfinite(ipGeolocateEntryData.double_value) && ipGeolocateEntryData.double_value >= MIN_LONGITUDE && ipGeolocateEntryData.double_value <= MAX_LONGITUDE) {
+	
+		// Set geolocation's longitude to the result
+		geolocation.longitude = ipGeolocateEntryData.double_value;
+		
+		// Check if getting the entry's latitude failed
+		if(MMDB_get_value(&entry, &ipGeolocateEntryData, "location", "latitude", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_DOUBLE && isfinite(ipGeolocateEntryData.double_value) && ipGeolocateEntryData.double_value >= MIN_LATITUDE && ipGeolocateEntryData.double_value <= MAX_LATITUDE) {
+		
+			// Set geolocation's latitude to the result
+			geolocation.latitude = ipGeolocateEntryData.double_value;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Reset geolocation's longitude
+			geolocation.longitude = NAN;
+		}
+	}
+	
+	// Return geolocation
+	return geolocation;
+}
+
+// Reload
+void GeolocationService::reload() {
+
+	// Check if opening the new database failed
+	Database *newDatabase = openDatabase(useIndex);
+	if(!newDatabase) {
+	
+		// Log message
+		logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Reloading IP geolocate database failed");
+	}
+	
+	// Otherwise check if the new database is indexed
+	else if(newDatabase->index) {
+	
+		// Log message
+		logger.log(Logger::Severity::INFO, Logger::MessageType::GENERAL, "Reloaded IP geolocate database with an index of ", newDatabase->index->getNumberOfRanges(), " range(s) and ", newDatabase->index->getNumberOfLocations(), " location(s)");
+		
+		// Replace the database with the new database
+		replaceDatabase(newDatabase);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Log message
+		logger.log(Logger::Severity::INFO, Logger::MessageType::GENERAL, "Reloaded IP geolocate database");
+		
+		// Replace the database with the new database
+		replaceDatabase(newDatabase);
+	}
+	
+	// Set reloading to false
+	reloading.store(false);
+}
+
+// Replace database
+void GeolocationService::replaceDatabase(Database *newDatabase) {
+
+	// Set indexed to if the new database is indexed
+	indexed.store(static_cast<bool>(newDatabase->index));
+	
+	// Replace the database with the new database
+	Database *currentDatabase = database.exchange(newDatabase);
+	
+	// Start a new epoch so that new readers use the new database
+	const uint64_t previousEpoch = epoch.fetch_add(1);
+	
+	// Loop while readers from the previous epoch may still be using the previous database
+	while(readers[previousEpoch % size(readers)].load()) {
+	
+		// Yield
+		this_thread::yield();
+	}
+	
+	// Close previous database
+	closeDatabase(currentDatabase);
+}
+
+// Open database
+GeolocationService::Database *GeolocationService::openDatabase(const bool createIndex) const {
+
+	// Create database
+	unique_ptr<Database> newDatabase = make_unique<Database>();
+	
+	// Check if getting the database's file info failed
+	if(stat(databaseLocation.c_str(), &newDatabase->fileInfo)) {
+	
+		// Return nothing
+		return nullptr;
+	}
+	
+	// Check if opening the IP geolocate database failed
+	if(MMDB_open(databaseLocation.c_str(), MMDB_MODE_MMAP, &newDatabase->ipGeolocateDatabase) != MMDB_SUCCESS) {
+	
+		// Return nothing
+		return nullptr;
+	}
+	
+	// Check if creating an index
+	if(createIndex) {
+	
+		// Try
+		try {
+		
+			// Create index from the IP geolocate database
+			newDatabase->index = make_unique<const GeolocationIndex>(newDatabase->ipGeolocateDatabase);
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Indexing IP geolocate database failed: ", error.what());
+		}
+	}
+	
+	// Return database
+	return newDatabase.release();
+}
+
+// Close database
+void GeolocationService::closeDatabase(Database *database) {
+
+	// Check if database exists
+	if(database) {
+	
+		// Close the IP geolocate database
+		MMDB_close(&database->ipGeolocateDatabase);
+		
+		// Free database
+		delete database;
+	}
+}
@@ -0,0 +1,106 @@
+// Header guard
+#ifndef GEOLOCATION_SERVICE_H
+#define GEOLOCATION_SERVICE_H
+
+
+// Header files
+#include <atomic>
+#include "./geolocation.h"
+#include "./geolocation_index.h"
+#include "./logger.h"
+#include "maxminddb.h"
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+
+using namespace std;
+
+
+// Classes
+
+// Geolocation service class
+class GeolocationService final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit GeolocationService(const char *databaseLocation, Logger &logger, const bool useIndex = false);
+		
+		// Destructor
+		~GeolocationService();
+		
+		// Geolocate
+		Geolocation geolocate(const string &address) const;
+		
+		// Reload if changed
+		bool reloadIfChanged();
+		
+		// Is indexed
+		bool isIndexed() const;
+		
+		// Is reloading
+		bool isReloading() const;
+		
+		// Get geolocation
+		static Geolocation getGeolocation(MMDB_entry_s &entry);
+		
+	// Private
+	private:
+	
+		// Database structure
+		struct Database {
+		
+			// IP geolocate database
+			MMDB_s ipGeolocateDatabase;
+			
+			// File info
+			struct stat fileInfo;
+			
+			// Index
+			unique_ptr<const GeolocationIndex> index;
+		};
+		
+		// Reload
+		void reload();
+		
+		// Replace database
+		void replaceDatabase(Database *newDatabase);
+		
+		// Open database
+		Database *openDatabase(const bool createIndex) const;
+		
+		// Close database
+		static void closeDatabase(Database *database);
+		
+		// Database location
+		const string databaseLocation;
+		
+		// Logger
+		Logger &logger;
+		
+		// Use index
+		const bool useIndex;
+		
+		// Database
+		atomic<Database *> database;
+		
+		// Epoch
+		atomic<uint64_t> epoch;
+		
+		// Readers
+		mutable atomic<uint64_t> readers[2];
+		
+		// Indexed
+		atomic<bool> indexed;
+		
+		// Reloading
+		atomic<bool> reloading;
+		
+		// Reloader
+		thread reloader;
+};
+
+
+#endif
@@ -0,0 +1,1243 @@
+// Header files
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "./file_writer.h"
+#include "./http_server.h"
+#include <iterator>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+HttpServer::HttpServer(const Metrics &metrics) :
+
+	// Set metrics to metrics
+	metrics(metrics),
+	
+	// Set listening socket to nothing
+	listeningSocket(-1),
+	
+	// Set epoll file to nothing
+	epollFile(-1),
+	
+	// Set wake file to nothing
+	wakeFile(-1),
+	
+	// Create resources
+	resources(make_shared<const unordered_map<string, shared_ptr<const Resource>>>()),
+	
+	// Set next client ID to zero
+	nextClientId(0),
+	
+	// Set number of clients to zero
+	numberOfClients(0),
+	
+	// Set number of event stream clients to zero
+	numberOfEventStreamClients(0),
+	
+	// Set number of dropped events to zero
+	numberOfDroppedEvents(0),
+	
+	// Set number of dropped events at last snapshot to zero
+	numberOfDroppedEventsAtLastSnapshot(0),
+	
+	// Set number of dropped events at snapshot before last to zero
+	numberOfDroppedEventsAtSnapshotBeforeLast(0),
+	
+	// Set stopping to false
+	stopping(false)
+{
+}
+
+// Destructor
+HttpServer::~HttpServer() {
+
+	// Set stopping to true
+	stopping.store(true);
+	
+	// Check if peer query worker is running
+	if(peerQueryWorker.joinable()) {
+	
+		// Lock
+		{
+			lock_guard guard(peerQueriesLock);
+		}
+		
+		// Notify peer query worker
+		peerQueriesCondition.notify_one();
+		
+		// Wait for peer query worker to finish
+		peerQueryWorker.join();
+	}
+	
+	// Check if worker is running
+	if(worker.joinable()) {
+	
+		// Wake worker
+		const uint64_t value = 1;
+		if(write(wakeFile, &value, sizeof(value))) {
+		
+		}
+		
+		// Wait for worker to finish
+		worker.join();
+	}
+	
+	// Go through all clients
+	for(const pair<const int, Client> &client : clients) {
+	
+		// Close client's socket
+		close(client.first);
+	}
+	
+	// Go through all files
+	for(const int file : {listeningSocket, epollFile, wakeFile}) {
+	
+		// Check if file is open
+		if(file != -1) {
+		
+			// Close file
+			close(file);
+		}
+	}
+}
+
+// Set peer query handler
+void HttpServer::setPeerQueryHandler(const string &path, const function<bool(const string_view &queryString, string &response)> &peerQueryHandler) {
+
+	// Set path's peer query handler to peer query handler
+	peerQueryHandlers[path] = peerQueryHandler;
+}
+
+// Start
+void HttpServer::start(const char *address, const uint16_t port) {
+
+	// Check if address is an IPv6 address
+	sockaddr_storage socketAddress = {};
+	socklen_t socketAddressLength;
+	sockaddr_in6 &ipv6SocketAddress = reinterpret_cast<sockaddr_in6 &>(socketAddress);
+	sockaddr_in &ipv4SocketAddress = reinterpret_cast<sockaddr_in &>(socketAddress);
+	if(inet_pton(AF_INET6, address, &ipv6SocketAddress.sin6_addr) == 1) {
+	
+		// Set IPv6 socket address's family and port
+		ipv6SocketAddress.sin6_family = AF_INET6;
+		ipv6SocketAddress.sin6_port = htons(port);
+		socketAddressLength = sizeof(ipv6SocketAddress);
+	}
+	
+	// Otherwise check if address is an IPv4 address
+	else if(inet_pton(AF_INET, address, &ipv4SocketAddress.sin_addr) == 1) {
+	
+		// Set IPv4 socket address's family and port
+		ipv4SocketAddress.sin_family = AF_INET;
+		ipv4SocketAddress.sin_port = htons(port);
+		socketAddressLength = sizeof(ipv4SocketAddress);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Throw exception
+		throw runtime_error("HTTP server address is invalid");
+	}
+	
+	// Check if creating non-blocking listening socket failed
+	listeningSocket = socket(socketAddress.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(listeningSocket == -1) {
+	
+		// Throw exception
+		throw runtime_error("Creating HTTP server socket failed");
+	}
+	
+	// Check if allowing the address to be reused failed or accepting IPv4 clients on an IPv6 socket failed
+	const int reuseAddress = 1;
+	const int ipv6Only = 0;
+	if(setsockopt(listeningSocket, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress)) || (socketAddress.ss_family == AF_INET6 && setsockopt(listeningSocket, IPPROTO_IPV6, IPV6_V6ONLY, &ipv6Only, sizeof(ipv6Only)))) {
+	
+		// Throw exception
+		throw runtime_error("Configuring HTTP server socket failed");
+	}
+	
+	// Check if binding or listening failed
+	if(bind(listeningSocket, reinterpret_cast<const sockaddr *>(&socketAddress), socketAddressLength) || listen(listeningSocket, SOMAXCONN)) {
+	
+		// Throw exception
+		throw runtime_error("Listening for HTTP clients failed");
+	}
+	
+	// Check if creating epoll file or wake file failed
+	epollFile = epoll_create1(EPOLL_CLOEXEC);
+	wakeFile = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(epollFile == -1 || wakeFile == -1) {
+	
+		// Throw exception
+		throw runtime_error("Creating HTTP server events failed");
+	}
+	
+	// Go through the listening socket and the wake file
+	for(const int file : {listeningSocket, wakeFile}) {
+	
+		// Check if waiting for the file to be readable failed
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = file;
+		if(epoll_ctl(epollFile, EPOLL_CTL_ADD, file, &event)) {
+		
+			// Throw exception
+			throw runtime_error("Creating HTTP server events failed");
+		}
+	}
+	
+	// Go through all static files
+	unordered_map<string, shared_ptr<const Resource>> staticResources;
+	for(const char *location : STATIC_FILES) {
+	
+		// Check if opening static file failed
+		ifstream file(location, ios::binary);
+		if(!file) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Read static file
+		const shared_ptr<const string> data = make_shared<const string>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+		
+		// Check if static file is text
+		const string path = &location[sizeof(".") - sizeof('\0')];
+		shared_ptr<const string> compressedData;
+		if(getContentType(path).starts_with("text/")) {
+		
+			// Check if compressing static file made it smaller
+			vector<char> compressedBuffer;
+			FileWriter::compress(compressedBuffer, data->data(), data->size());
+			if(compressedBuffer.size() < data->size()) {
+			
+				// Set compressed data to the compressed static file
+				compressedData = make_shared<const string>(compressedBuffer.begin(), compressedBuffer.end());
+			}
+		}
+		
+		// Add static file to the static resources
+		staticResources.emplace(path, createResource(path, data, compressedData));
+	}
+	
+	// Set resources to the static resources
+	resources = make_shared<const unordered_map<string, shared_ptr<const Resource>>>(move(staticResources));
+	
+	// Set last heartbeat time to now
+	lastHeartbeatTime = chrono::steady_clock::now();
+	
+	// Set next sweep time to never since there's no clients
+	nextSweepTime = chrono::steady_clock::time_point::max();
+	
+	// Create worker
+	worker = thread(&HttpServer::run, this);
+	
+	// Create peer query worker
+	peerQueryWorker = thread(&HttpServer::runPeerQueries, this);
+}
+
+// Publish snapshot
+void HttpServer::publishSnapshot(const SnapshotWriter &snapshotWriter) {
+
+	// Copy the current resources
+	unordered_map<string, shared_ptr<const Resource>> newResources;
+	{
+		lock_guard guard(resourcesLock);
+		newResources = *resources;
+	}
+	
+	// Go through all of the snapshot's uncompressed files
+	for(size_t i = 0; i < SnapshotWriter::NUMBER_OF_FILES / 2; ++i) {
+	
+		// Get file's data and compressed data
+		const shared_ptr<const string> data = make_shared<const string>(snapshotWriter.getData(i));
+		const shared_ptr<const string> compressedData = make_shared<const string>(snapshotWriter.getData(i + SnapshotWriter::NUMBER_OF_FILES / 2));
+		
+		// Replace file's resource with one that can be sent compressed and its compressed file's resource with one that shares the compressed data
+		const string path = &snapshotWriter.getLocations()[i][sizeof(".") - sizeof('\0')];
+		newResources[path] = createResource(path, data, compressedData);
+		newResources[path + SnapshotWriter::COMPRESSED_EXTENSION] = createResource(path + SnapshotWriter::COMPRESSED_EXTENSION, compressedData, nullptr);
+	}
+	
+	// Lock
+	{
+		lock_guard guard(resourcesLock);
+		
+		// Set resources to the new resources
+		resources = make_shared<const unordered_map<string, shared_ptr<const Resource>>>(move(newResources));
+	}
+	
+	// Check if events were dropped since the snapshot before last (events dropped while the last snapshot was being published may not be in it) and event stream clients exist
+	const uint64_t currentNumberOfDroppedEvents = numberOfDroppedEvents.load(memory_order_relaxed);
+	if(currentNumberOfDroppedEvents != numberOfDroppedEventsAtSnapshotBeforeLast && hasEventStreamClients()) {
+	
+		// Publish snapshot event so that event stream clients get the new snapshot instead of keeping a copy that's missing the dropped events (clients that are disconnected for falling behind get it when they reconnect and other clients' copies are kept current by the peer events)
+		publishEvent("snapshot", "{}");
+	}
+	
+	// Update number of dropped events at the last snapshots
+	numberOfDroppedEventsAtSnapshotBeforeLast = numberOfDroppedEventsAtLastSnapshot;
+	numberOfDroppedEventsAtLastSnapshot = currentNumberOfDroppedEvents;
+}
+
+// Publish event
+void HttpServer::publishEvent(const string_view &type, const string_view &data) {
+
+	// Check if not started
+	if(wakeFile == -1) {
+	
+		// Return
+		return;
+	}
+	
+	// Lock
+	bool wasEmpty;
+	{
+		lock_guard guard(pendingEventsLock);
+		
+		// Check if there's too many pending events
+		if(pendingEvents.size() + type.size() + data.size() + sizeof("event: \ndata: \n\n") > MAX_PENDING_EVENTS_SIZE) {
+		
+			// Increment number of dropped events
+			numberOfDroppedEvents.fetch_add(1, memory_order_relaxed);
+			
+			// Return
+			return;
+		}
+		
+		// Append event to the pending events
+		wasEmpty = pendingEvents.empty();
+		pendingEvents.append("event: ").append(type).append("\ndata: ").append(data).append("\n\n");
+	}
+	
+	// Check if pending events were empty
+	if(wasEmpty) {
+	
+		// Wake worker so that it broadcasts the pending events
+		const uint64_t value = 1;
+		if(write(wakeFile, &value, sizeof(value))) {
+		
+		}
+	}
+}
+
+// Has event stream clients
+bool HttpServer::hasEventStreamClients() const {
+
+	// Return if event stream clients exist
+	return numberOfEventStreamClients.load(memory_order_relaxed);
+}
+
+// Get number of clients
+size_t HttpServer::getNumberOfClients() const {
+
+	// Return number of clients
+	return numberOfClients.load(memory_order_relaxed);
+}
+
+// Get number of event stream clients
+size_t HttpServer::getNumberOfEventStreamClients() const {
+
+	// Return number of event stream clients
+	return numberOfEventStreamClients.load(memory_order_relaxed);
+}
+
+// Get number of dropped events
+uint64_t HttpServer::getNumberOfDroppedEvents() const {
+
+	// Return number of dropped events
+	return numberOfDroppedEvents.load(memory_order_relaxed);
+}
+
+// Create resource
+shared_ptr<const HttpServer::Resource> HttpServer::createResource(const string &path, const shared_ptr<const string> &data, const shared_ptr<const string> &compressedData) {
+
+	// Return resource
+	return make_shared<const Resource>(Resource{
+	
+		// Content type
+		.contentType = getContentType(path),
+		
+		// Data
+		.data = data,
+		
+		// Entity tag
+		.entityTag = getEntityTag(*data, false),
+		
+		// Compressed data
+		.compressedData = compressedData,
+		
+		// Compressed entity tag
+		.compressedEntityTag = compressedData ? getEntityTag(*data, true) : ""
+	});
+}
+
+// Get content type
+string HttpServer::getContentType(const string &path) {
+
+	// Check path's extension
+	const string extension = filesystem::path(path).extension().string();
+	if(extension == ".html") {
+	
+		// Return HTML content type
+		return "text/html; charset=utf-8";
+	}
+	else if(extension == ".js") {
+	
+		// Return JavaScript content type
+		return "text/javascript; charset=utf-8";
+	}
+	else if(extension == ".json") {
+	
+		// Return JSON content type
+		return "application/json";
+	}
+	else if(extension == ".webp") {
+	
+		// Return WebP content type
+		return "image/webp";
+	}
+	else if(extension == SnapshotWriter::COMPRESSED_EXTENSION) {
+	
+		// Return gzip content type
+		return "application/gzip";
+	}
+	
+	// Return binary content type
+	return "application/octet-stream";
+}
+
+// Get entity tag
+string HttpServer::getEntityTag(const string_view &data, const bool compressed) {
+
+	// Return quoted hash of the data followed by if it's compressed
+	char hash[sizeof(uint64_t) * 2 + sizeof('\0')];
+	snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(std::hash<string_view>()(data)));
+	return string("\"") + hash + (compressed ? "-gzip\"" : "\"");
+}
+
+// Run
+void HttpServer::run() {
+
+	// Loop while not stopping
+	array<epoll_event, MAX_NUMBER_OF_EPOLL_EVENTS> events;
+	while(!stopping.load()) {
+	
+		// Check if a sweep is pending
+		int timeout = -1;
+		if(nextSweepTime != chrono::steady_clock::time_point::max()) {
+		
+			// Set timeout to the time until the next sweep
+			timeout = static_cast<int>(max(chrono::ceil<chrono::milliseconds>(nextSweepTime - chrono::steady_clock::now()).count(), static_cast<chrono::milliseconds::rep>(0)));
+		}
+		
+		// Check if waiting for events until the next sweep failed
+		const int numberOfEvents = epoll_wait(epollFile, events.data(), events.size(), timeout);
+		if(numberOfEvents == -1 && errno != EINTR) {
+		
+			// Break
+			break;
+		}
+		
+		// Go through all events
+		for(int i = 0; i < numberOfEvents; ++i) {
+		
+			// Check if event is for the listening socket
+			const int file = events[i].data.fd;
+			if(file == listeningSocket) {
+			
+				// Accept clients
+				acceptClients();
+			}
+			
+			// Otherwise check if event is for the wake file
+			else if(file == wakeFile) {
+			
+				// Reset wake file
+				uint64_t value;
+				if(read(wakeFile, &value, sizeof(value))) {
+				
+				}
+				
+				// Broadcast events
+				broadcastEvents();
+				
+				// Finish peer queries
+				finishPeerQueries();
+			}
+			
+			// Otherwise
+			else {
+			
+				// Check if client was already closed
+				unordered_map<int, Client>::iterator client = clients.find(file);
+				if(client == clients.end()) {
+				
+					// Continue
+					continue;
+				}
+				
+				// Check if client failed, sending to the client failed, or receiving from the client failed
+				if((events[i].events & EPOLLERR) || ((events[i].events & EPOLLOUT) && (!send(file, client->second) || !handleRequests(file, client->second))) || ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !receive(file, client->second))) {
+				
+					// Close client
+					closeClient(file);
+				}
+			}
+		}
+		
+		// Check if time to sweep
+		if(chrono::steady_clock::now() >= nextSweepTime) {
+		
+			// Sweep
+			sweep();
+		}
+	}
+}
+
+// Accept clients
+void HttpServer::acceptClients() {
+
+	// Loop while clients are waiting to be accepted
+	while(true) {
+	
+		// Check if accepting client failed
+		const int socket = accept4(listeningSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(socket == -1) {
+		
+			// Break
+			break;
+		}
+		
+		// Check if there's too many clients
+		if(clients.size() >= MAX_NUMBER_OF_CLIENTS) {
+		
+			// Close socket
+			close(socket);
+			
+			// Continue
+			continue;
+		}
+		
+		// Check if waiting for the client to be readable failed
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.fd = socket;
+		if(epoll_ctl(epollFile, EPOLL_CTL_ADD, socket, &event)) {
+		
+			// Close socket
+			close(socket);
+			
+			// Continue
+			continue;
+		}
+		
+		// Add client to the clients
+		Client &client = clients[socket];
+		client.id = nextClientId++;
+		client.events = event.events;
+		client.lastActivityTime = chrono::steady_clock::now();
+		numberOfClients.fetch_add(1, memory_order_relaxed);
+		
+		// Sweep no later than when the client's idle timeout expires
+		nextSweepTime = min(nextSweepTime, client.lastActivityTime + IDLE_TIMEOUT);
+	}
+}
+
+// Receive
+bool HttpServer::receive(const int socket, Client &client) {
+
+	// Loop while data can be received
+	char buffer[RECEIVE_BUFFER_SIZE];
+	while(true) {
+	
+		// Check if receiving data failed
+		const ssize_t numberOfBytesReceived = recv(socket, buffer, sizeof(buffer), 0);
+		if(numberOfBytesReceived == -1) {
+		
+			// Check if no more data is available
+			if(errno == EAGAIN || errno == EWOULDBLOCK) {
+			
+				// Break
+				break;
+			}
+			
+			// Otherwise check if receiving was interrupted
+			else if(errno == EINTR) {
+			
+				// Continue
+				continue;
+			}
+			
+			// Return false
+			return false;
+		}
+		
+		// Otherwise check if client closed its side of the connection
+		else if(!numberOfBytesReceived) {
+		
+			// Check if nothing is being sent to the client
+			if(client.isEventStream || (!client.waitingForPeerQuery && client.outputOffset == client.output.size() && client.bodyOffset == client.body.size() && client.input.find("\r\n\r\n") == string::npos)) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Set close after write to true
+			client.closeAfterWrite = true;
+			
+			// Break
+			break;
+		}
+		
+		// Check if client isn't an event stream since event stream clients aren't expected to send anything
+		if(!client.isEventStream) {
+		
+			// Check if input is too large (requests that haven't been handled yet count towards it so that a client that pipelines requests without reading their responses can't grow it without limit)
+			client.input.append(buffer, numberOfBytesReceived);
+			if(client.input.size() > MAX_REQUEST_SIZE) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Check if a complete request was received
+			if(client.input.find("\r\n\r\n") != string::npos) {
+			
+				// Break so that the rest is received once the request is handled
+				break;
+			}
+		}
+	}
+	
+	// Set client's last activity time to now
+	client.lastActivityTime = chrono::steady_clock::now();
+	
+	// Return handling client's requests
+	return handleRequests(socket, client);
+}
+
+// Handle requests
+bool HttpServer::handleRequests(const int socket, Client &client) {
+
+	// Loop while nothing is being sent to the client
+	while(!client.isEventStream && !client.waitingForPeerQuery && client.outputOffset == client.output.size() && client.bodyOffset == client.body.size()) {
+	
+		// Check if a complete request hasn't been received
+		const size_t requestEnd = client.input.find("\r\n\r\n");
+		if(requestEnd == string::npos) {
+		
+			// Break
+			break;
+		}
+		
+		// Handle request
+		handleRequest(socket, client, string_view(client.input).substr(0, requestEnd + sizeof("\r\n\r\n") - sizeof('\0')));
+		
+		// Remove request from the input
+		client.input.erase(0, requestEnd + sizeof("\r\n\r\n") - sizeof('\0'));
+		
+		// Check if waiting for the request's peer query's response
+		if(client.waitingForPeerQuery) {
+		
+			// Break
+			break;
+		}
+		
+		// Check if sending response failed
+		if(!send(socket, client)) {
+		
+			// Return false
+			return false;
+		}
+	}
+	
+	// Return updating the client's events
+	return updateEvents(socket, client);
+}
+
+// Handle request
+void HttpServer::handleRequest(const int socket, Client &client, const string_view &request) {
+
+	// Check if request line is invalid
+	const string_view requestLine = request.substr(0, request.find("\r\n"));
+	const size_t methodEnd = requestLine.find(' ');
+	const size_t targetEnd = (methodEnd == string_view::npos) ? string_view::npos : requestLine.find(' ', methodEnd + sizeof(' '));
+	if(targetEnd == string_view::npos) {
+	
+		// Respond with bad request and close connection
+		client.output = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+		client.outputOffset = 0;
+		client.closeAfterWrite = true;
+		
+		// Return
+		return;
+	}
+	
+	// Get request's method, path, and version
+	const string_view method = requestLine.substr(0, methodEnd);
+	string_view path = requestLine.substr(methodEnd + sizeof(' '), targetEnd - methodEnd - sizeof(' '));
+	const size_t queryStart = path.find('?');
+	const string_view queryString = (queryStart == string_view::npos) ? string_view() : path.substr(queryStart + sizeof('?'));
+	path = path.substr(0, queryStart);
+	const string_view version = requestLine.substr(targetEnd + sizeof(' '));
+	
+	// Go through all of the request's headers
+	string connection;
+	string acceptEncoding;
+	string ifNoneMatch;
+	for(size_t lineStart = requestLine.size() + sizeof("\r\n") - sizeof('\0'); lineStart < request.size();) {
+	
+		// Get header
+		const size_t lineEnd = request.find("\r\n", lineStart);
+		const string_view header = request.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + sizeof("\r\n") - sizeof('\0');
+		
+		// Check if header has a value
+		const size_t nameEnd = header.find(':');
+		if(nameEnd != string_view::npos) {
+		
+			// Get header's lowercase name and value without surrounding whitespace
+			string name(header.substr(0, nameEnd));
+			for(char &character : name) {
+			
+				// Make character lowercase
+				character = tolower(character);
+			}
+			string value(header.substr(nameEnd + sizeof(':')));
+			value.erase(0, value.find_first_not_of(" \t"));
+			value.erase(value.find_last_not_of(" \t") + 1);
+			
+			// Check if header is one that's used
+			if(name == "connection") {
+			
+				// Set connection to the header's lowercase value
+				for(char &character : value) {
+				
+					// Make character lowercase
+					character = tolower(character);
+				}
+				connection = move(value);
+			}
+			else if(name == "accept-encoding") {
+			
+				// Set accept encoding to the header's value
+				acceptEncoding = move(value);
+			}
+			else if(name == "if-none-match") {
+			
+				// Set if none match to the header's value
+				ifNoneMatch = move(value);
+			}
+		}
+	}
+	
+	// Set close after write to if the connection isn't persistent
+	client.closeAfterWrite = client.closeAfterWrite || ((version == "HTTP/1.1") ? connection.find("close") != string::npos : connection.find("keep-alive") == string::npos);
+	const char *connectionHeader = client.closeAfterWrite ? "Connection: close\r\n" : "Connection: keep-alive\r\n";
+	client.outputOffset = 0;
+	
+	// Check if method isn't supported
+	const bool isHead = method == "HEAD";
+	if(method != "GET" && !isHead) {
+	
+		// Respond with method not allowed
+		client.output = string("HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Length: 0\r\n") + connectionHeader + "\r\n";
+		
+		// Return
+		return;
+	}
+	
+	// Check if requesting the event stream
+	if(path == EVENT_STREAM_PATH && !isHead) {
+	
+		// Respond with the start of the event stream
+		client.output = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nAccess-Control-Allow-Origin: *\r\nConnection: keep-alive\r\n\r\nretry: 5000\n\n";
+		
+		// Set client to be an event stream
+		client.isEventStream = true;
+		client.closeAfterWrite = false;
+		client.input.clear();
+		numberOfEventStreamClients.fetch_add(1, memory_order_relaxed);
+		
+		// Sweep no later than when the next heartbeat is due
+		nextSweepTime = min(nextSweepTime, lastHeartbeatTime + HEARTBEAT_INTERVAL);
+		
+		// Return
+		return;
+	}
+	
+	// Check if requesting the metrics
+	if(path == METRICS_PATH) {
+	
+		// Respond with the current metrics
+		const shared_ptr<const string> currentMetrics = make_shared<const string>(metrics.serialize());
+		client.output = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " + to_string(currentMetrics->size()) + "\r\nCache-Control: no-store\r\n" + connectionHeader + "\r\n";
+		
+		// Check if not a head request
+		if(!isHead) {
+		
+			// Set body to the current metrics
+			client.bodyOwner = currentMetrics;
+			client.body = *currentMetrics;
+			client.bodyOffset = 0;
+		}
+		
+		// Return
+		return;
+	}
+	
+	// Check if requesting a peer query
+	const unordered_map<string, function<bool(const string_view &queryString, string &response)>>::const_iterator peerQueryHandler = peerQueryHandlers.find(string(path));
+	if(peerQueryHandler != peerQueryHandlers.end()) {
+	
+		// Lock
+		{
+			lock_guard guard(peerQueriesLock);
+			
+			// Check if there's too many pending peer queries
+			if(pendingPeerQueries.size() >= MAX_NUMBER_OF_PENDING_PEER_QUERIES) {
+			
+				// Respond with service unavailable
+				client.output = string("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 1\r\nAccess-Control-Allow-Origin: *\r\n") + connectionHeader + "\r\n";
+				
+				// Return
+				return;
+			}
+			
+			// Add query to the pending peer queries
+			pendingPeerQueries.push_back(PeerQuery{
+			
+				// Socket
+				.socket = socket,
+				
+				// Client ID
+				.clientId = client.id,
+				
+				// Handler
+				.handler = &peerQueryHandler->second,
+				
+				// Query string
+				.queryString = string(queryString),
+				
+				// Is head
+				.isHead = isHead,
+				
+				// Is valid
+				.isValid = false,
+				
+				// Response
+				.response = make_shared<string>()
+			});
+		}
+		
+		// Notify peer query worker
+		peerQueriesCondition.notify_one();
+		
+		// Set client to wait for its peer query's response
+		client.output.clear();
+		client.waitingForPeerQuery = true;
+		
+		// Return
+		return;
+	}
+	
+	// Get resources
+	shared_ptr<const unordered_map<string, shared_ptr<const Resource>>> currentResources;
+	{
+		lock_guard guard(resourcesLock);
+		currentResources = resources;
+	}
+	
+	// Check if resource doesn't exist
+	const unordered_map<string, shared_ptr<const Resource>>::const_iterator resource = currentResources->find((path == "/") ? string(INDEX_PATH) : string(path));
+	if(resource == currentResources->end()) {
+	
+		// Respond with not found
+		client.output = string("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nAccess-Control-Allow-Origin: *\r\n") + connectionHeader + "\r\n";
+		
+		// Return
+		return;
+	}
+	
+	// Get if sending the compressed representation
+	const bool compressed = resource->second->compressedData && acceptEncoding.find("gzip") != string::npos;
+	const string &entityTag = compressed ? resource->second->compressedEntityTag : resource->second->entityTag;
+	
+	// Check if client already has the representation
+	if(!ifNoneMatch.empty() && (ifNoneMatch == "*" || ifNoneMatch.find(entityTag) != string::npos)) {
+	
+		// Respond with not modified
+		client.output = "HTTP/1.1 304 Not Modified\r\nETag: " + entityTag + "\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\nAccess-Control-Allow-Origin: *\r\n" + connectionHeader + "\r\n";
+		
+		// Return
+		return;
+	}
+	
+	// Respond with the representation
+	const shared_ptr<const string> &data = compressed ? resource->second->compressedData : resource->second->data;
+	client.output = "HTTP/1.1 200 OK\r\nContent-Type: " + resource->second->contentType + "\r\nContent-Length: " + to_string(data->size()) + "\r\nETag: " + entityTag + "\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\nAccess-Control-Allow-Origin: *\r\n" + (compressed ? "Content-Encoding: gzip\r\n" : "") + connectionHeader + "\r\n";
+	
+	// Check if not a head request
+	if(!isHead) {
+	
+		// Set body to the data without copying it
+		client.bodyOwner = data;
+		client.body = *data;
+		client.bodyOffset = 0;
+	}
+}
+
+// Send
+bool HttpServer::send(const int socket, Client &client) {
+
+	// Loop while data is being sent to the client
+	while(client.outputOffset != client.output.size() || client.bodyOffset != client.body.size()) {
+	
+		// Check if sending the output and body failed
+		iovec buffers[] = {
+			{const_cast<char *>(client.output.data() + client.outputOffset), client.output.size() - client.outputOffset},
+			{const_cast<char *>(client.body.data() + client.bodyOffset), client.body.size() - client.bodyOffset}
+		};
+		msghdr message = {};
+		message.msg_iov = buffers;
+		message.msg_iovlen = size(buffers);
+		const ssize_t numberOfBytesSent = sendmsg(socket, &message, MSG_NOSIGNAL);
+		if(numberOfBytesSent == -1) {
+		
+			// Check if client can't accept more data right now
+			if(errno == EAGAIN || errno == EWOULDBLOCK) {
+			
+				// Return updating the client's events so that it's waited for to be writable
+				return updateEvents(socket, client);
+			}
+			
+			// Otherwise check if sending was interrupted
+			else if(errno == EINTR) {
+			
+				// Continue
+				continue;
+			}
+			
+			// Return false
+			return false;
+		}
+		
+		// Update output offset and body offset with what was sent
+		const size_t numberOfOutputBytesSent = min(static_cast<size_t>(numberOfBytesSent), client.output.size() - client.outputOffset);
+		client.outputOffset += numberOfOutputBytesSent;
+		client.bodyOffset += numberOfBytesSent - numberOfOutputBytesSent;
+		
+		// Set client's last activity time to now
+		client.lastActivityTime = chrono::steady_clock::now();
+	}
+	
+	// Clear output and body
+	client.output.clear();
+	client.outputOffset = 0;
+	client.bodyOwner.reset();
+	client.body = string_view();
+	client.bodyOffset = 0;
+	
+	// Check if closing after write
+	if(client.closeAfterWrite) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Return updating the client's events so that it's waited for to be readable again
+	return updateEvents(socket, client);
+}
+
+// Update events
+bool HttpServer::updateEvents(const int socket, Client &client) {
+
+	// Get events to wait for (nothing is received from a client while its peer query's response or its output is pending so that what it sends meanwhile stays in its socket's buffer)
+	const uint32_t events = client.waitingForPeerQuery ? 0 : ((client.outputOffset != client.output.size() || client.bodyOffset != client.body.size()) ? static_cast<uint32_t>(EPOLLOUT) : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP));
+	
+	// Check if events changed
+	if(events != client.events) {
+	
+		// Check if waiting for the events failed
+		epoll_event event = {};
+		event.events = events;
+		event.data.fd = socket;
+		if(epoll_ctl(epollFile, EPOLL_CTL_MOD, socket, &event)) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set client's events to the events
+		client.events = events;
+	}
+	
+	// Return true
+	return true;
+}
+
+// Broadcast events
+void HttpServer::broadcastEvents() {
+
+	// Lock
+	string events;
+	{
+		lock_guard guard(pendingEventsLock);
+		
+		// Take pending events
+		events.swap(pendingEvents);
+	}
+	
+	// Check if there's no events
+	if(events.empty()) {
+	
+		// Return
+		return;
+	}
+	
+	// Go through all clients
+	vector<int> closedClients;
+	for(pair<const int, Client> &client : clients) {
+	
+		// Check if client is an event stream
+		if(client.second.isEventStream) {
+		
+			// Check if client has fallen too far behind
+			if(client.second.output.size() - client.second.outputOffset + events.size() > MAX_CLIENT_OUTPUT_SIZE) {
+			
+				// Close client
+				closedClients.push_back(client.first);
+			}
+			
+			// Otherwise
+			else {
+			
+				// Check if sending events to the client failed
+				client.second.output.append(events);
+				if(!send(client.first, client.second)) {
+				
+					// Close client
+					closedClients.push_back(client.first);
+				}
+			}
+		}
+	}
+	
+	// Go through all closed clients
+	for(const int socket : closedClients) {
+	
+		// Close client
+		closeClient(socket);
+	}
+}
+
+// Run peer queries
+void HttpServer::runPeerQueries() {
+
+	// Loop forever
+	while(true) {
+	
+		// Wait until a peer query is pending or stopping
+		unique_lock guard(peerQueriesLock);
+		peerQueriesCondition.wait(guard, [this]() -> bool {
+		
+			// Return if a peer query is pending or stopping
+			return !pendingPeerQueries.empty() || stopping.load();
+		});
+		
+		// Check if stopping
+		if(stopping.load()) {
+		
+			// Break
+			break;
+		}
+		
+		// Take the oldest pending peer query
+		PeerQuery peerQuery = move(pendingPeerQueries.front());
+		pendingPeerQueries.pop_front();
+		
+		// Unlock so that queries can be added while this one is answered
+		guard.unlock();
+		
+		// Try
+		try {
+		
+			// Answer peer query
+			peerQuery.isValid = (*peerQuery.handler)(peerQuery.queryString, *peerQuery.response);
+		}
+		
+		// Catch errors
+		catch(...) {
+		
+			// Set peer query to be invalid
+			peerQuery.isValid = false;
+		}
+		
+		// Lock
+		guard.lock();
+		
+		// Add peer query to the finished peer queries
+		finishedPeerQueries.push_back(move(peerQuery));
+		
+		// Unlock
+		guard.unlock();
+		
+		// Wake worker so that it sends the peer query's response
+		const uint64_t value = 1;
+		if(write(wakeFile, &value, sizeof(value))) {
+		
+		}
+	}
+}
+
+// Finish peer queries
+void HttpServer::finishPeerQueries() {
+
+	// Lock
+	vector<PeerQuery> peerQueries;
+	{
+		lock_guard guard(peerQueriesLock);
+		
+		// Take finished peer queries
+		peerQueries.swap(finishedPeerQueries);
+	}
+	
+	// Go through all finished peer queries
+	for(const PeerQuery &peerQuery : peerQueries) {
+	
+		// Check if the client that made the peer query was closed
+		const unordered_map<int, Client>::iterator client = clients.find(peerQuery.socket);
+		if(client == clients.end() || client->second.id != peerQuery.clientId || !client->second.waitingForPeerQuery) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Set client to no longer wait for its peer query's response
+		client->second.waitingForPeerQuery = false;
+		const char *connectionHeader = client->second.closeAfterWrite ? "Connection: close\r\n" : "Connection: keep-alive\r\n";
+		client->second.outputOffset = 0;
+		
+		// Check if peer query is invalid
+		if(!peerQuery.isValid) {
+		
+			// Respond with bad request
+			client->second.output = string("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nAccess-Control-Allow-Origin: *\r\n") + connectionHeader + "\r\n";
+		}
+		
+		// Otherwise
+		else {
+		
+			// Respond with the peer query's result
+			client->second.output = "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nContent-Length: " + to_string(peerQuery.response->size()) + "\r\nCache-Control: no-store\r\nAccess-Control-Allow-Origin: *\r\n" + connectionHeader + "\r\n";
+			
+			// Check if not a head request
+			if(!peerQuery.isHead) {
+			
+				// Set body to the peer query's result
+				client->second.bodyOwner = peerQuery.response;
+				client->second.body = *peerQuery.response;
+				client->second.bodyOffset = 0;
+			}
+		}
+		
+		// Check if sending the response or handling the client's next requests failed
+		if(!send(peerQuery.socket, client->second) || !handleRequests(peerQuery.socket, client->second)) {
+		
+			// Close client
+			closeClient(peerQuery.socket);
+		}
+	}
+}
+
+// Sweep
+void HttpServer::sweep() {
+
+	// Get if time to send a heartbeat to event stream clients
+	const chrono::steady_clock::time_point currentTime = chrono::steady_clock::now();
+	const bool sendHeartbeat = currentTime - lastHeartbeatTime >= HEARTBEAT_INTERVAL;
+	if(sendHeartbeat) {
+	
+		// Set last heartbeat time to now
+		lastHeartbeatTime = currentTime;
+	}
+	
+	// Go through all clients
+	vector<int> closedClients;
+	nextSweepTime = chrono::steady_clock::time_point::max();
+	for(pair<const int, Client> &client : clients) {
+	
+		// Check if client is an event stream
+		if(client.second.isEventStream) {
+		
+			// Check if sending a heartbeat comment so that proxies keep the connection open and sending it to the client failed
+			if(sendHeartbeat && client.second.output.size() - client.second.outputOffset < MAX_CLIENT_OUTPUT_SIZE && !send(client.first, (client.second.output.append(":\n\n"), client.second))) {
+			
+				// Close client
+				closedClients.push_back(client.first);
+			}
+			
+			// Otherwise
+			else {
+			
+				// Sweep no later than when the next heartbeat is due
+				nextSweepTime = min(nextSweepTime, lastHeartbeatTime + HEARTBEAT_INTERVAL);
+			}
+		}
+		
+		// Otherwise check if client has been idle for too long
+		else if(currentTime - client.second.lastActivityTime >= IDLE_TIMEOUT) {
+		
+			// Close client
+			closedClients.push_back(client.first);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Sweep no later than when the client's idle timeout expires
+			nextSweepTime = min(nextSweepTime, client.second.lastActivityTime + IDLE_TIMEOUT);
+		}
+	}
+	
+	// Go through all closed clients
+	for(const int socket : closedClients) {
+	
+		// Close client
+		closeClient(socket);
+	}
+}
+
+// Close client
+void HttpServer::closeClient(const int socket) {
+
+	// Check if client is an event stream
+	const unordered_map<int, Client>::iterator client = clients.find(socket);
+	if(client->second.isEventStream) {
+	
+		// Decrement number of event stream clients
+		numberOfEventStreamClients.fetch_sub(1, memory_order_relaxed);
+	}
+	
+	// Close client's socket
+	close(socket);
+	
+	// Remove client from the clients
+	clients.erase(client);
+	numberOfClients.fetch_sub(1, memory_order_relaxed);
+}
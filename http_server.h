@@ -0,0 +1,319 @@
+// Header guard
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+
+// Header files
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include "./metrics.h"
+#include <mutex>
+#include "./snapshot_writer.h"
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// HTTP server class (a single threaded non-blocking server for the snapshot files and a stream of peer events with peer queries answered on a separate thread so that they never stall the event loop)
+class HttpServer final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit HttpServer(const Metrics &metrics);
+		
+		// Destructor
+		~HttpServer();
+		
+		// Copy constructor
+		HttpServer(const HttpServer &other) = delete;
+		
+		// Copy assignment operator
+		HttpServer &operator=(const HttpServer &other) = delete;
+		
+		// Set peer query handler (called from the server's query thread with the query string of a request for the path and returns false if the query is invalid)
+		void setPeerQueryHandler(const string &path, const function<bool(const string_view &queryString, string &response)> &peerQueryHandler);
+		
+		// Start
+		void start(const char *address, const uint16_t port);
+		
+		// Publish snapshot
+		void publishSnapshot(const SnapshotWriter &snapshotWriter);
+		
+		// Publish event
+		void publishEvent(const string_view &type, const string_view &data);
+		
+		// Has event stream clients
+		bool hasEventStreamClients() const;
+		
+		// Get number of clients
+		size_t getNumberOfClients() const;
+		
+		// Get number of event stream clients
+		size_t getNumberOfEventStreamClients() const;
+		
+		// Get number of dropped events
+		uint64_t getNumberOfDroppedEvents() const;
+		
+	// Private
+	private:
+	
+		// Static files
+		static constexpr const array<const char *, 3> STATIC_FILES = {"./index.html", "./Globe.GL-2.44.1.min.js", "./earth.webp"};
+		
+		// Event stream path
+		static constexpr const char EVENT_STREAM_PATH[] = "/events";
+		
+		// Index path
+		static constexpr const char INDEX_PATH[] = "/index.html";
+		
+		// Metrics path
+		static constexpr const char METRICS_PATH[] = "/metrics";
+		
+		// Max number of clients
+		static const size_t MAX_NUMBER_OF_CLIENTS = 16384;
+		
+		// Max request size
+		static const size_t MAX_REQUEST_SIZE = 8 * 1024;
+		
+		// Max client output size (event stream clients that fall this far behind are disconnected)
+		static const size_t MAX_CLIENT_OUTPUT_SIZE = 1024 * 1024;
+		
+		// Max pending events size
+		static const size_t MAX_PENDING_EVENTS_SIZE = 16 * 1024 * 1024;
+		
+		// Max number of epoll events
+		static const int MAX_NUMBER_OF_EPOLL_EVENTS = 256;
+		
+		// Receive buffer size
+		static const size_t RECEIVE_BUFFER_SIZE = 4 * 1024;
+		
+		// Max number of pending peer queries (clients that query while this many are waiting are told to retry later)
+		static const size_t MAX_NUMBER_OF_PENDING_PEER_QUERIES = 64;
+		
+		// Idle timeout
+		static constexpr const chrono::seconds IDLE_TIMEOUT = 60s;
+		
+		// Heartbeat interval
+		static constexpr const chrono::seconds HEARTBEAT_INTERVAL = 15s;
+		
+		// Resource structure
+		struct Resource {
+		
+			// Content type
+			string contentType;
+			
+			// Data
+			shared_ptr<const string> data;
+			
+			// Entity tag
+			string entityTag;
+			
+			// Compressed data
+			shared_ptr<const string> compressedData;
+			
+			// Compressed entity tag
+			string compressedEntityTag;
+		};
+		
+		// Peer query structure
+		struct PeerQuery {
+		
+			// Socket
+			int socket;
+			
+			// Client ID (distinguishes the client that made the query from a later client that reused its socket)
+			uint64_t clientId;
+			
+			// Handler
+			const function<bool(const string_view &queryString, string &response)> *handler;
+			
+			// Query string
+			string queryString;
+			
+			// Is head
+			bool isHead;
+			
+			// Is valid
+			bool isValid;
+			
+			// Response
+			shared_ptr<string> response;
+		};
+		
+		// Client structure
+		struct Client {
+		
+			// ID
+			uint64_t id = 0;
+			
+			// Input
+			string input;
+			
+			// Output
+			string output;
+			
+			// Output offset
+			size_t outputOffset = 0;
+			
+			// Body owner
+			shared_ptr<const string> bodyOwner;
+			
+			// Body
+			string_view body;
+			
+			// Body offset
+			size_t bodyOffset = 0;
+			
+			// Is event stream
+			bool isEventStream = false;
+			
+			// Close after write
+			bool closeAfterWrite = false;
+			
+			// Events (what the client is being waited for)
+			uint32_t events = 0;
+			
+			// Waiting for peer query
+			bool waitingForPeerQuery = false;
+			
+			// Last activity time
+			chrono::steady_clock::time_point lastActivityTime;
+		};
+		
+		// Create resource
+		static shared_ptr<const Resource> createResource(const string &path, const shared_ptr<const string> &data, const shared_ptr<const string> &compressedData);
+		
+		// Get content type
+		static string getContentType(const string &path);
+		
+		// Get entity tag
+		static string getEntityTag(const string_view &data, const bool compressed);
+		
+		// Run
+		void run();
+		
+		// Accept clients
+		void acceptClients();
+		
+		// Receive
+		bool receive(const int socket, Client &client);
+		
+		// Handle requests
+		bool handleRequests(const int socket, Client &client);
+		
+		// Handle request
+		void handleRequest(const int socket, Client &client, const string_view &request);
+		
+		// Send
+		bool send(const int socket, Client &client);
+		
+		// Update events
+		bool updateEvents(const int socket, Client &client);
+		
+		// Broadcast events
+		void broadcastEvents();
+		
+		// Run peer queries
+		void runPeerQueries();
+		
+		// Finish peer queries
+		void finishPeerQueries();
+		
+		// Sweep
+		void sweep();
+		
+		// Close client
+		void closeClient(const int socket);
+		
+		// Metrics
+		const Metrics &metrics;
+		
+		// Peer query handlers by path
+		unordered_map<string, function<bool(const string_view &queryString, string &response)>> peerQueryHandlers;
+		
+		// Listening socket
+		int listeningSocket;
+		
+		// Epoll file
+		int epollFile;
+		
+		// Wake file
+		int wakeFile;
+		
+		// Resources
+		shared_ptr<const unordered_map<string, shared_ptr<const Resource>>> resources;
+		
+		// Resources lock
+		mutex resourcesLock;
+		
+		// Pending events
+		string pendingEvents;
+		
+		// Pending events lock
+		mutex pendingEventsLock;
+		
+		// Clients
+		unordered_map<int, Client> clients;
+		
+		// Next client ID
+		uint64_t nextClientId;
+		
+		// Pending peer queries
+		deque<PeerQuery> pendingPeerQueries;
+		
+		// Finished peer queries
+		vector<PeerQuery> finishedPeerQueries;
+		
+		// Peer queries lock
+		mutex peerQueriesLock;
+		
+		// Peer queries condition
+		condition_variable peerQueriesCondition;
+		
+		// Number of clients
+		atomic<size_t> numberOfClients;
+		
+		// Number of event stream clients
+		atomic<size_t> numberOfEventStreamClients;
+		
+		// Number of dropped events
+		atomic<uint64_t> numberOfDroppedEvents;
+		
+		// Number of dropped events at last snapshot
+		uint64_t numberOfDroppedEventsAtLastSnapshot;
+		
+		// Number of dropped events at snapshot before last
+		uint64_t numberOfDroppedEventsAtSnapshotBeforeLast;
+		
+		// Last heartbeat time
+		chrono::steady_clock::time_point lastHeartbeatTime;
+		
+		// Next sweep time (earliest idle timeout or heartbeat deadline)
+		chrono::steady_clock::time_point nextSweepTime;
+		
+		// Stopping
+		atomic<bool> stopping;
+		
+		// Worker
+		thread worker;
+		
+		// Peer query worker
+		thread peerQueryWorker;
+};
+
+
+#endif
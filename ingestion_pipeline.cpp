@@ -0,0 +1,317 @@
+// Header files
+#include <cstring>
+#include "./ingestion_pipeline.h"
+#include <vector>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+IngestionPipeline::IngestionPipeline(const GeolocationService &geolocationService, UserAgentTable &userAgentTable, PeerRegistry &recentPeers, mutex &recentPeersLock, Metrics &metrics, Logger &logger) :
+
+	// Set geolocation service to geolocation service
+	geolocationService(geolocationService),
+	
+	// Set user agent table to user agent table
+	userAgentTable(userAgentTable),
+	
+	// Set recent peers to recent peers
+	recentPeers(recentPeers),
+	
+	// Set recent peers lock to recent peers lock
+	recentPeersLock(recentPeersLock),
+	
+	// Set metrics to metrics
+	metrics(metrics),
+	
+	// Set logger to logger
+	logger(logger),
+	
+	// Set number of dropped peers to zero
+	numberOfDroppedPeers(0),
+	
+	// Set number of invalid peers to zero
+	numberOfInvalidPeers(0),
+	
+	// Set number of processed peers to zero
+	numberOfProcessedPeers(0),
+	
+	// Set worker waiting to false
+	workerWaiting(false),
+	
+	// Set wakeups to zero
+	wakeups(0),
+	
+	// Set stopping to false
+	stopping(false),
+	
+	// Create worker
+	worker(&IngestionPipeline::run, this)
+{
+}
+
+// Destructor
+IngestionPipeline::~IngestionPipeline() {
+
+	// Stop
+	stop();
+}
+
+// Stop
+void IngestionPipeline::stop() {
+
+	// Set stopping to true
+	stopping.store(true);
+	
+	// Wake worker
+	wakeups.fetch_add(1);
+	wakeups.notify_one();
+	
+	// Check if worker is running
+	if(worker.joinable()) {
+	
+		// Wait for worker to finish
+		worker.join();
+	}
+}
+
+// Add peer
+bool IngestionPipeline::addPeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const string &userAgent, const uint32_t protocolVersion, const uint64_t baseFee, const uint64_t totalDifficulty, const bool isInbound, const chrono::microseconds latency) {
+
+	// Check if peer identifier is too long
+	if(peerIdentifier.size() > PEER_IDENTIFIER_MAX_LENGTH) {
+	
+		// Increment number of invalid peers
+		numberOfInvalidPeers.fetch_add(1, memory_order_relaxed);
+		
+		// Return false
+		return false;
+	}
+	
+	// Create peer event
+	PeerEvent peerEvent;
+	memcpy(peerEvent.peerIdentifier, peerIdentifier.data(), peerIdentifier.size());
+	peerEvent.peerIdentifierLength = peerIdentifier.size();
+	peerEvent.userAgentLength = min(userAgent.size(), USER_AGENT_MAX_LENGTH);
+	memcpy(peerEvent.userAgent, userAgent.data(), peerEvent.userAgentLength);
+	peerEvent.userAgentTruncated = userAgent.size() > USER_AGENT_MAX_LENGTH;
+	peerEvent.isInbound = isInbound;
+	peerEvent.capabilities = capabilities;
+	peerEvent.protocolVersion = protocolVersion;
+	peerEvent.baseFee = baseFee;
+	peerEvent.totalDifficulty = totalDifficulty;
+	peerEvent.latency = latency;
+	
+	// Check if adding peer event to the queue failed
+	if(!queue.push(peerEvent)) {
+	
+		// Increment number of dropped peers
+		numberOfDroppedPeers.fetch_add(1, memory_order_relaxed);
+		
+		// Return false
+		return false;
+	}
+	
+	// Check if worker is waiting (the fence pairs with the worker's so that either the worker sees the peer event or this sees the worker waiting)
+	atomic_thread_fence(memory_order_seq_cst);
+	if(workerWaiting.load()) {
+	
+		// Wake worker
+		workerWaiting.store(false);
+		wakeups.fetch_add(1);
+		wakeups.notify_one();
+	}
+	
+	// Return true
+	return true;
+}
+
+// Get queue depth
+size_t IngestionPipeline::getQueueDepth() const {
+
+	// Return queue's size
+	return queue.size();
+}
+
+// Get number of dropped peers
+uint64_t IngestionPipeline::getNumberOfDroppedPeers() const {
+
+	// Return number of dropped peers
+	return numberOfDroppedPeers.load(memory_order_relaxed);
+}
+
+// Get number of invalid peers
+uint64_t IngestionPipeline::getNumberOfInvalidPeers() const {
+
+	// Return number of invalid peers
+	return numberOfInvalidPeers.load(memory_order_relaxed);
+}
+
+// Get number of processed peers
+uint64_t IngestionPipeline::getNumberOfProcessedPeers() const {
+
+	// Return number of processed peers
+	return numberOfProcessedPeers.load(memory_order_relaxed);
+}
+
+// Run
+void IngestionPipeline::run() {
+
+	// Initialize peer events
+	vector<PeerEvent> peerEvents(BATCH_SIZE);
+	
+	// Loop forever
+	while(true) {
+	
+		// Get if stopping before draining the queue so that no peer events are left behind
+		const uint32_t currentWakeups = wakeups.load();
+		const bool isStopping = stopping.load();
+		
+		// Go through a batch of peer events in the queue
+		size_t numberOfPeerEvents = 0;
+		while(numberOfPeerEvents < peerEvents.size() && queue.pop(peerEvents[numberOfPeerEvents])) {
+		
+			// Increment number of peer events
+			++numberOfPeerEvents;
+		}
+		
+		// Check if no peer events were in the queue
+		if(!numberOfPeerEvents) {
+		
+			// Check if stopping
+			if(isStopping) {
+			
+				// Break
+				break;
+			}
+			
+			// Set worker waiting to true
+			workerWaiting.store(true);
+			atomic_thread_fence(memory_order_seq_cst);
+			
+			// Check if queue is still empty and not stopping
+			if(!queue.size() && !stopping.load()) {
+			
+				// Wait until woken
+				wakeups.wait(currentWakeups);
+			}
+			
+			// Set worker waiting to false
+			workerWaiting.store(false);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Process peers
+			processPeers(peerEvents.data(), numberOfPeerEvents);
+		}
+	}
+}
+
+// Process peers
+void IngestionPipeline::processPeers(const PeerEvent *peerEvents, const size_t numberOfPeerEvents) {
+
+	// Initialize peer identifiers, user agent IDs, and geolocations
+	vector<string> peerIdentifiers(numberOfPeerEvents);
+	vector<uint16_t> userAgentIds(numberOfPeerEvents);
+	vector<Geolocation> geolocations(numberOfPeerEvents);
+	vector<bool> geolocated(numberOfPeerEvents, false);
+	
+	// Go through all peer events
+	for(size_t i = 0; i < numberOfPeerEvents; ++i) {
+	
+		// Get peer event's peer identifier
+		const PeerEvent &peerEvent = peerEvents[i];
+		peerIdentifiers[i].assign(peerEvent.peerIdentifier, peerEvent.peerIdentifierLength);
+		
+		// Get peer event's user agent ID
+		userAgentIds[i] = peerEvent.userAgentTruncated ? UserAgentTable::UNKNOWN_USER_AGENT_ID : userAgentTable.intern(string_view(peerEvent.userAgent, peerEvent.userAgentLength));
+		
+		// Try
+		try {
+		
+			// Geolocate the peer
+			const chrono::steady_clock::time_point geolocateStartTime = chrono::steady_clock::now();
+			geolocations[i] = geolocationService.geolocate(peerIdentifiers[i]);
+			metrics.geolocateDuration.observe(chrono::steady_clock::now() - geolocateStartTime);
+			
+			// Set geolocated to true
+			geolocated[i] = true;
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::PEER_UPDATE_FAILED, "Updating recent peers failed: ", error.what());
+		}
+		
+		// Catch errors
+		catch(...) {
+		
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::PEER_UPDATE_FAILED, "Updating recent peers failed");
+		}
+	}
+	
+	// Try
+	vector<bool> updated(numberOfPeerEvents, false);
+	try {
+	
+		// Lock recent peers
+		const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+		lock_guard lock(recentPeersLock);
+		metrics.recentPeersLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
+		
+		// Go through all peer events
+		for(size_t i = 0; i < numberOfPeerEvents; ++i) {
+		
+			// Check if peer was geolocated
+			if(geolocated[i]) {
+			
+				// Update peer in the recent peers and get if it wasn't rejected
+				updated[i] = recentPeers.updatePeer(peerIdentifiers[i], peerEvents[i].capabilities, userAgentIds[i], peerEvents[i].baseFee, move(geolocations[i]), peerEvents[i].isInbound, peerEvents[i].latency);
+			}
+		}
+		
+		// Set number of unique peers
+		metrics.numberOfUniquePeers.store(recentPeers.getPeers().size(), memory_order_relaxed);
+	}
+	
+	// Catch errors
+	catch(const exception &error) {
+	
+		// Log message
+		logger.log(Logger::Severity::ERROR, Logger::MessageType::PEER_UPDATE_FAILED, "Updating recent peers failed: ", error.what());
+		
+		// Return
+		return;
+	}
+	
+	// Catch errors
+	catch(...) {
+	
+		// Log message
+		logger.log(Logger::Severity::ERROR, Logger::MessageType::PEER_UPDATE_FAILED, "Updating recent peers failed");
+		
+		// Return
+		return;
+	}
+	
+	// Go through all peer events
+	for(size_t i = 0; i < numberOfPeerEvents; ++i) {
+	
+		// Check if peer was updated in the recent peers
+		if(updated[i]) {
+		
+			// Log message
+			logger.log(Logger::Severity::INFO, Logger::MessageType::PEER_DETECTED, "Detected ", peerEvents[i].isInbound ? "inbound" : "outbound", " peer ", peerIdentifiers[i]);
+			
+			// Increment number of processed peers
+			numberOfProcessedPeers.fetch_add(1, memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,157 @@
+// Header guard
+#ifndef INGESTION_PIPELINE_H
+#define INGESTION_PIPELINE_H
+
+
+// Header files
+#include <atomic>
+#include "./bounded_queue.h"
+#include <chrono>
+#include "./geolocation_service.h"
+#include "./logger.h"
+#include "./metrics.h"
+#include <mutex>
+#include "./node/mwc_validation_node.h"
+#include "./peer_registry.h"
+#include <string>
+#include <thread>
+#include "./user_agent.h"
+
+using namespace std;
+
+
+// Classes
+
+// Ingestion pipeline class
+class IngestionPipeline final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit IngestionPipeline(const GeolocationService &geolocationService, UserAgentTable &userAgentTable, PeerRegistry &recentPeers, mutex &recentPeersLock, Metrics &metrics, Logger &logger);
+		
+		// Destructor
+		~IngestionPipeline();
+		
+		// Stop (waits for the peers that are already queued to be added to the recent peers)
+		void stop();
+		
+		// Add peer
+		bool addPeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const string &userAgent, const uint32_t protocolVersion, const uint64_t baseFee, const uint64_t totalDifficulty, const bool isInbound, const chrono::microseconds latency);
+		
+		// Get queue depth
+		size_t getQueueDepth() const;
+		
+		// Get number of dropped peers
+		uint64_t getNumberOfDroppedPeers() const;
+		
+		// Get number of invalid peers
+		uint64_t getNumberOfInvalidPeers() const;
+		
+		// Get number of processed peers
+		uint64_t getNumberOfProcessedPeers() const;
+		
+	// Private
+	private:
+	
+		// Queue capacity
+		static const size_t QUEUE_CAPACITY = 4096;
+		
+		// Batch size
+		static const size_t BATCH_SIZE = 256;
+		
+		// Peer identifier max length
+		static const size_t PEER_IDENTIFIER_MAX_LENGTH = 127;
+		
+		// User agent max length
+		static const size_t USER_AGENT_MAX_LENGTH = 63;
+		
+		// Peer event structure
+		struct PeerEvent {
+		
+			// Peer identifier
+			char peerIdentifier[PEER_IDENTIFIER_MAX_LENGTH];
+			
+			// Peer identifier length
+			uint8_t peerIdentifierLength;
+			
+			// User agent
+			char userAgent[USER_AGENT_MAX_LENGTH];
+			
+			// User agent length
+			uint8_t userAgentLength;
+			
+			// User agent truncated
+			bool userAgentTruncated;
+			
+			// Is inbound
+			bool isInbound;
+			
+			// Capabilities
+			MwcValidationNode::Node::Capabilities capabilities;
+			
+			// Protocol version
+			uint32_t protocolVersion;
+			
+			// Base fee
+			uint64_t baseFee;
+			
+			// Total difficulty
+			uint64_t totalDifficulty;
+			
+			// Latency (zero if it wasn't measured)
+			chrono::microseconds latency;
+		};
+		
+		// Run
+		void run();
+		
+		// Process peers
+		void processPeers(const PeerEvent *peerEvents, const size_t numberOfPeerEvents);
+		
+		// Geolocation service
+		const GeolocationService &geolocationService;
+		
+		// User agent table
+		UserAgentTable &userAgentTable;
+		
+		// Recent peers
+		PeerRegistry &recentPeers;
+		
+		// Recent peers lock
+		mutex &recentPeersLock;
+		
+		// Metrics
+		Metrics &metrics;
+		
+		// Logger
+		Logger &logger;
+		
+		// Queue
+		BoundedQueue<PeerEvent, QUEUE_CAPACITY> queue;
+		
+		// Number of dropped peers
+		atomic<uint64_t> numberOfDroppedPeers;
+		
+		// Number of invalid peers
+		atomic<uint64_t> numberOfInvalidPeers;
+		
+		// Number of processed peers
+		atomic<uint64_t> numberOfProcessedPeers;
+		
+		// Worker waiting (set by the worker before it waits so that producers only wake it when it's waiting)
+		atomic<bool> workerWaiting;
+		
+		// Wakeups
+		atomic<uint32_t> wakeups;
+		
+		// Stopping
+		atomic<bool> stopping;
+		
+		// Worker
+		thread worker;
+};
+
+
+#endif
@@ -0,0 +1,223 @@
+// Header files
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include "./file_writer.h"
+#include "./json_serializer.h"
+#include <string>
+
+using namespace std;
+
+
+// Constants
+
+// Hex characters
+static const char HEX_CHARACTERS[] = "0123456789abcdef";
+
+// Escape table (zero if the character doesn't need escaping, the character to put after a backslash if it has a short escape, or 'u' if it needs a unicode escape)
+static constexpr const array<char, 256> ESCAPE_TABLE = []() -> array<char, 256> {
+
+	// Initialize escape table
+	array<char, 256> escapeTable = {};
+	
+	// Go through all control characters
+	for(size_t i = 0; i < 0x20; ++i) {
+	
+		// Set control character to use a unicode escape
+		escapeTable[i] = 'u';
+	}
+	
+	// Set characters that have short escapes
+	escapeTable['"'] = '"';
+	escapeTable['\\'] = '\\';
+	escapeTable['\b'] = 'b';
+	escapeTable['\f'] = 'f';
+	escapeTable['\n'] = 'n';
+	escapeTable['\r'] = 'r';
+	escapeTable['\t'] = 't';
+	
+	// Set delete character to use a unicode escape
+	escapeTable[0x7F] = 'u';
+	
+	// Return escape table
+	return escapeTable;
+}();
+
+
+// Supporting function implementation
+
+// Constructor
+JsonSerializer::JsonSerializer() :
+
+	// Create buffer
+	buffer(INITIAL_CAPACITY),
+	
+	// Set size to zero
+	size(0)
+{
+}
+
+// Clear
+void JsonSerializer::clear() {
+
+	// Set size to zero
+	size = 0;
+}
+
+// Append raw
+void JsonSerializer::appendRaw(const string_view &value) {
+
+	// Append value to the buffer
+	memcpy(reserve(value.size()), value.data(), value.size());
+	size += value.size();
+}
+
+// Append raw
+void JsonSerializer::appendRaw(const char value) {
+
+	// Append value to the buffer
+	*reserve(sizeof(value)) = value;
+	++size;
+}
+
+// Append string
+void JsonSerializer::appendString(const string_view &value) {
+
+	// Reserve space for the worst case where every character is unicode escaped
+	char *destination = reserve(sizeof('"') + value.size() * sizeof("\\u0000") + sizeof('"'));
+	char *current = destination;
+	
+	// Append opening quote
+	*current++ = '"';
+	
+	// Go through all characters in the value
+	for(const char character : value) {
+	
+		// Check if character doesn't need escaping
+		const char escape = ESCAPE_TABLE[static_cast<uint8_t>(character)];
+		if(!escape) {
+		
+			// Append character
+			*current++ = character;
+		}
+		
+		// Otherwise check if character uses a unicode escape
+		else if(escape == 'u') {
+		
+			// Append unicode escape
+			*current++ = '\\';
+			*current++ = 'u';
+			*current++ = '0';
+			*current++ = '0';
+			*current++ = HEX_CHARACTERS[static_cast<uint8_t>(character) >> 4];
+			*current++ = HEX_CHARACTERS[static_cast<uint8_t>(character) & 0x0F];
+		}
+		
+		// Otherwise
+		else {
+		
+			// Append short escape
+			*current++ = '\\';
+			*current++ = escape;
+		}
+	}
+	
+	// Append closing quote
+	*current++ = '"';
+	
+	// Update size
+	size += current - destination;
+}
+
+// Append string or null
+void JsonSerializer::appendStringOrNull(const string_view &value) {
+
+	// Check if value doesn't exist
+	if(value.empty()) {
+	
+		// Append null
+		appendRaw("null");
+	}
+	
+	// Otherwise
+	else {
+	
+		// Append value
+		appendString(value);
+	}
+}
+
+// Append unsigned integer
+void JsonSerializer::appendUnsignedInteger(const uint64_t value) {
+
+	// Append value to the buffer
+	char *destination = reserve(MAX_NUMBER_LENGTH);
+	size += to_chars(destination, destination + MAX_NUMBER_LENGTH, value).ptr - destination;
+}
+
+// Append quoted unsigned integer
+void JsonSerializer::appendQuotedUnsignedInteger(const uint64_t value) {
+
+	// Append quoted value to the buffer
+	appendRaw('"');
+	appendUnsignedInteger(value);
+	appendRaw('"');
+}
+
+// Append quoted fixed point or null
+void JsonSerializer::appendQuotedFixedPointOrNull(const double value) {
+
+	// Check if value isn't finite
+	if(!isfinite(value)) {
+	
+		// Append null
+		appendRaw("null");
+	}
+	
+	// Otherwise
+	else {
+	
+		// Append quoted value to the buffer
+		char *destination = reserve(sizeof('"') + MAX_NUMBER_LENGTH + sizeof('"'));
+		*destination = '"';
+		char *end = to_chars(destination + sizeof('"'), destination + sizeof('"') + MAX_NUMBER_LENGTH, value, chars_format::fixed, FIXED_POINT_PRECISION).ptr;
+		*end++ = '"';
+		size += end - destination;
+	}
+}
+
+// Get data
+const char *JsonSerializer::getData() const {
+
+	// Return buffer's data
+	return buffer.data();
+}
+
+// Get size
+size_t JsonSerializer::getSize() const {
+
+	// Return size
+	return size;
+}
+
+// Save
+void JsonSerializer::save(const char *location) const {
+
+	// Write buffer to the file
+	FileWriter::write(location, buffer.data(), size);
+}
+
+// Reserve
+char *JsonSerializer::reserve(const size_t length) {
+
+	// Check if buffer isn't large enough
+	if(size + length > buffer.size()) {
+	
+		// Grow buffer
+		buffer.resize(max(buffer.size() * 2, size + length));
+	}
+	
+	// Return end of the buffer
+	return &buffer[size];
+}
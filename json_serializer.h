@@ -0,0 +1,81 @@
+// Header guard
+#ifndef JSON_SERIALIZER_H
+#define JSON_SERIALIZER_H
+
+
+// Header files
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// JSON serializer class
+class JsonSerializer final {
+
+	// Public
+	public:
+	
+		// Constructor
+		JsonSerializer();
+		
+		// Clear
+		void clear();
+		
+		// Append raw
+		void appendRaw(const string_view &value);
+		
+		// Append raw
+		void appendRaw(const char value);
+		
+		// Append string
+		void appendString(const string_view &value);
+		
+		// Append string or null
+		void appendStringOrNull(const string_view &value);
+		
+		// Append unsigned integer
+		void appendUnsignedInteger(const uint64_t value);
+		
+		// Append quoted unsigned integer
+		void appendQuotedUnsignedInteger(const uint64_t value);
+		
+		// Append quoted fixed point or null
+		void appendQuotedFixedPointOrNull(const double value);
+		
+		// Get data
+		const char *getData() const;
+		
+		// Get size
+		size_t getSize() const;
+		
+		// Save
+		void save(const char *location) const;
+		
+	// Private
+	private:
+	
+		// Initial capacity
+		static const size_t INITIAL_CAPACITY = 64 * 1024;
+		
+		// Fixed point precision
+		static const int FIXED_POINT_PRECISION = 6;
+		
+		// Max number length
+		static const size_t MAX_NUMBER_LENGTH = 32;
+		
+		// Reserve
+		char *reserve(const size_t length);
+		
+		// Buffer
+		vector<char> buffer;
+		
+		// Size
+		size_t size;
+};
+
+
+#endif
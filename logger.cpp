@@ -0,0 +1,274 @@
+// Header files
+#include <iostream>
+#include "./logger.h"
+
+using namespace std;
+
+
+// Constants
+
+// Severity names
+static const char *SEVERITY_NAMES[] = {
+
+	// Debug
+	"DEBUG",
+	
+	// Info
+	"INFO",
+	
+	// Warning
+	"WARNING",
+	
+	// Error
+	"ERROR"
+};
+
+// Message type names
+static const char *MESSAGE_TYPE_NAMES[] = {
+
+	// General
+	"general",
+	
+	// Peer detected
+	"peer detected",
+	
+	// Peer update failed
+	"peer update failed",
+	
+	// Task failed
+	"task failed"
+};
+
+
+// Supporting function implementation
+
+// Constructor
+Logger::Logger(const Severity minimumSeverity) :
+
+	// Set minimum severity to minimum severity
+	minimumSeverity(minimumSeverity),
+	
+	// Set number of dropped messages to zero
+	numberOfDroppedMessages(0),
+	
+	// Set number of suppressed messages to zero
+	numberOfSuppressedMessages(0),
+	
+	// Set flusher waiting to false
+	flusherWaiting(false),
+	
+	// Set wakeups to zero
+	wakeups(0),
+	
+	// Set stopping to false
+	stopping(false)
+{
+
+	// Go through all rate limit states
+	for(RateLimitState &rateLimitState : rateLimitStates) {
+	
+		// Reset rate limit state
+		rateLimitState.second.store(0, memory_order_relaxed);
+		rateLimitState.count.store(0, memory_order_relaxed);
+		rateLimitState.numberOfSuppressedMessages.store(0, memory_order_relaxed);
+	}
+	
+	// Create flusher
+	flusher = thread(&Logger::run, this);
+}
+
+// Destructor
+Logger::~Logger() {
+
+	// Set stopping to true
+	stopping.store(true);
+	
+	// Wake flusher
+	wakeups.fetch_add(1);
+	wakeups.notify_one();
+	
+	// Check if flusher is running
+	if(flusher.joinable()) {
+	
+		// Wait for flusher to finish
+		flusher.join();
+	}
+}
+
+// Get number of dropped messages
+uint64_t Logger::getNumberOfDroppedMessages() const {
+
+	// Return number of dropped messages
+	return numberOfDroppedMessages.load(memory_order_relaxed);
+}
+
+// Get number of suppressed messages
+uint64_t Logger::getNumberOfSuppressedMessages() const {
+
+	// Return number of suppressed messages
+	return numberOfSuppressedMessages.load(memory_order_relaxed);
+}
+
+// Is allowed
+bool Logger::isAllowed(const MessageType messageType) {
+
+	// Check if message type isn't rate limited
+	const uint32_t rateLimit = RATE_LIMITS[static_cast<size_t>(messageType)];
+	if(rateLimit == UINT32_MAX) {
+	
+		// Return true
+		return true;
+	}
+	
+	// Check if a new second started
+	RateLimitState &rateLimitState = rateLimitStates[static_cast<size_t>(messageType)];
+	const uint64_t second = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	uint64_t currentSecond = rateLimitState.second.load(memory_order_relaxed);
+	if(currentSecond != second && rateLimitState.second.compare_exchange_strong(currentSecond, second, memory_order_relaxed)) {
+	
+		// Reset count for the new second
+		rateLimitState.count.store(0, memory_order_relaxed);
+	}
+	
+	// Check if message type exceeded its rate limit for this second
+	if(rateLimitState.count.fetch_add(1, memory_order_relaxed) >= rateLimit) {
+	
+		// Increment number of suppressed messages
+		rateLimitState.numberOfSuppressedMessages.fetch_add(1, memory_order_relaxed);
+		numberOfSuppressedMessages.fetch_add(1, memory_order_relaxed);
+		
+		// Return false
+		return false;
+	}
+	
+	// Return true
+	return true;
+}
+
+// Push
+void Logger::push(const Record &record) {
+
+	// Check if adding record to the queue failed
+	if(!queue.push(record)) {
+	
+		// Increment number of dropped messages
+		numberOfDroppedMessages.fetch_add(1, memory_order_relaxed);
+		
+		// Return
+		return;
+	}
+	
+	// Check if flusher is waiting (the fence pairs with the flusher's so that either the flusher sees the record or this sees the flusher waiting)
+	atomic_thread_fence(memory_order_seq_cst);
+	if(flusherWaiting.load()) {
+	
+		// Wake flusher
+		flusherWaiting.store(false);
+		wakeups.fetch_add(1);
+		wakeups.notify_one();
+	}
+}
+
+// Append part
+void Logger::appendPart(Record &record, const string_view &part) {
+
+	// Append as much of the part as fits to the record's message
+	const size_t length = min(part.size(), MAX_MESSAGE_LENGTH - record.messageLength);
+	memcpy(&record.message[record.messageLength], part.data(), length);
+	record.messageLength += length;
+}
+
+// Append part
+void Logger::appendPart(Record &record, const char *part) {
+
+	// Append part to the record's message
+	appendPart(record, string_view(part));
+}
+
+// Append part
+void Logger::appendPart(Record &record, const string &part) {
+
+	// Append part to the record's message
+	appendPart(record, string_view(part));
+}
+
+// Append part
+void Logger::appendPart(Record &record, const char part) {
+
+	// Append part to the record's message
+	appendPart(record, string_view(&part, sizeof(part)));
+}
+
+// Run
+void Logger::run() {
+
+	// Loop forever
+	string output;
+	Record record;
+	while(true) {
+	
+		// Get if stopping before draining the queue so that no records are left behind
+		const uint32_t currentWakeups = wakeups.load();
+		const bool isStopping = stopping.load();
+		
+		// Go through all records in the queue
+		output.clear();
+		while(queue.pop(record)) {
+		
+			// Write record to the output
+			writeRecord(output, record);
+		}
+		
+		// Go through all rate limit states
+		for(size_t i = 0; i < rateLimitStates.size(); ++i) {
+		
+			// Check if messages of the type were suppressed since the last time they were reported
+			const uint64_t numberOfSuppressedMessagesOfType = rateLimitStates[i].numberOfSuppressedMessages.exchange(0, memory_order_relaxed);
+			if(numberOfSuppressedMessagesOfType) {
+			
+				// Write number of suppressed messages to the output
+				output.append("[WARNING] Suppressed ").append(to_string(numberOfSuppressedMessagesOfType)).append(" ").append(MESSAGE_TYPE_NAMES[i]).append(" message(s)\n");
+			}
+		}
+		
+		// Check if there's output
+		if(!output.empty()) {
+		
+			// Write output to stdout
+			cout.write(output.data(), output.size());
+			cout.flush();
+		}
+		
+		// Otherwise check if stopping
+		else if(isStopping) {
+		
+			// Break
+			break;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Set flusher waiting to true
+			flusherWaiting.store(true);
+			atomic_thread_fence(memory_order_seq_cst);
+			
+			// Check if queue is still empty and not stopping
+			if(!queue.size() && !stopping.load()) {
+			
+				// Wait until woken
+				wakeups.wait(currentWakeups);
+			}
+			
+			// Set flusher waiting to false
+			flusherWaiting.store(false);
+		}
+	}
+}
+
+// Write record
+void Logger::writeRecord(string &output, const Record &record) {
+
+	// Append record's severity and message
+	output.append("[").append(SEVERITY_NAMES[static_cast<size_t>(record.severity)]).append("] ").append(record.message, record.messageLength).append("\n");
+}
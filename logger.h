@@ -0,0 +1,230 @@
+// Header guard
+#ifndef LOGGER_H
+#define LOGGER_H
+
+
+// Header files
+#include <array>
+#include <atomic>
+#include "./bounded_queue.h"
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+using namespace std;
+
+
+// Classes
+
+// Logger class (messages are formatted into fixed size records that are queued without locking and written to stdout by a background flusher so that logging never blocks the caller)
+class Logger final {
+
+	// Public
+	public:
+	
+		// Severity
+		enum class Severity : uint8_t {
+		
+			// Debug
+			DEBUG,
+			
+			// Info
+			INFO,
+			
+			// Warning
+			WARNING,
+			
+			// Error
+			ERROR
+		};
+		
+		// Message type (each type is rate limited separately)
+		enum class MessageType : uint8_t {
+		
+			// General
+			GENERAL,
+			
+			// Peer detected
+			PEER_DETECTED,
+			
+			// Peer update failed
+			PEER_UPDATE_FAILED,
+			
+			// Task failed
+			TASK_FAILED,
+			
+			// Number of message types
+			NUMBER_OF_MESSAGE_TYPES
+		};
+		
+		// Constructor
+		explicit Logger(const Severity minimumSeverity);
+		
+		// Destructor
+		~Logger();
+		
+		// Copy constructor
+		Logger(const Logger &other) = delete;
+		
+		// Copy assignment operator
+		Logger &operator=(const Logger &other) = delete;
+		
+		// Log (the parts are strings, characters, or integers that are concatenated into the message which is truncated if it's too long)
+		template<typename... Parts> void log(const Severity severity, const MessageType messageType, const Parts &...parts);
+		
+		// Get number of dropped messages (messages that were dropped since the queue was full)
+		uint64_t getNumberOfDroppedMessages() const;
+		
+		// Get number of suppressed messages (messages that were dropped since their type exceeded its rate limit)
+		uint64_t getNumberOfSuppressedMessages() const;
+		
+	// Private
+	private:
+	
+		// Queue capacity
+		static const size_t QUEUE_CAPACITY = 4096;
+		
+		// Max message length
+		static const size_t MAX_MESSAGE_LENGTH = 246;
+		
+		// Rate limits (max number of messages of each type per second)
+		static constexpr const array<uint32_t, static_cast<size_t>(MessageType::NUMBER_OF_MESSAGE_TYPES)> RATE_LIMITS = {
+		
+			// General
+			UINT32_MAX,
+			
+			// Peer detected
+			200,
+			
+			// Peer update failed
+			10,
+			
+			// Task failed
+			10
+		};
+		
+		// Record structure
+		struct Record {
+		
+			// Severity
+			Severity severity;
+			
+			// Message type
+			MessageType messageType;
+			
+			// Message length
+			uint8_t messageLength;
+			
+			// Message
+			char message[MAX_MESSAGE_LENGTH];
+		};
+		
+		// Rate limit state structure
+		struct RateLimitState {
+		
+			// Second (the second that the count is for)
+			atomic<uint64_t> second;
+			
+			// Count
+			atomic<uint32_t> count;
+			
+			// Number of suppressed messages (since the last time the flusher reported them)
+			atomic<uint64_t> numberOfSuppressedMessages;
+		};
+		
+		// Is allowed
+		bool isAllowed(const MessageType messageType);
+		
+		// Push
+		void push(const Record &record);
+		
+		// Append part
+		static void appendPart(Record &record, const string_view &part);
+		
+		// Append part
+		static void appendPart(Record &record, const char *part);
+		
+		// Append part
+		static void appendPart(Record &record, const string &part);
+		
+		// Append part
+		static void appendPart(Record &record, const char part);
+		
+		// Append part
+		template<typename Type> requires is_integral_v<Type> static void appendPart(Record &record, const Type part);
+		
+		// Run
+		void run();
+		
+		// Write record
+		static void writeRecord(string &output, const Record &record);
+		
+		// Minimum severity
+		const Severity minimumSeverity;
+		
+		// Queue
+		BoundedQueue<Record, QUEUE_CAPACITY> queue;
+		
+		// Rate limit states
+		array<RateLimitState, static_cast<size_t>(MessageType::NUMBER_OF_MESSAGE_TYPES)> rateLimitStates;
+		
+		// Number of dropped messages
+		atomic<uint64_t> numberOfDroppedMessages;
+		
+		// Number of suppressed messages
+		atomic<uint64_t> numberOfSuppressedMessages;
+		
+		// Flusher waiting (set by the flusher before it waits so that producers only wake it when it's waiting)
+		atomic<bool> flusherWaiting;
+		
+		// Wakeups
+		atomic<uint32_t> wakeups;
+		
+		// Stopping
+		atomic<bool> stopping;
+		
+		// Flusher
+		thread flusher;
+};
+
+
+// Supporting function implementation
+
+// Log
+template<typename... Parts> void Logger::log(const Severity severity, const MessageType messageType, const Parts &...parts) {
+
+	// Check if severity is less than the minimum severity or the message type exceeded its rate limit
+	if(severity < minimumSeverity || !isAllowed(messageType)) {
+	
+		// Return
+		return;
+	}
+	
+	// Create record
+	Record record;
+	record.severity = severity;
+	record.messageType = messageType;
+	record.messageLength = 0;
+	
+	// Append parts to the record's message
+	(appendPart(record, parts), ...);
+	
+	// Push record
+	push(record);
+}
+
+// Append part
+template<typename Type> requires is_integral_v<Type> void Logger::appendPart(Record &record, const Type part) {
+
+	// Append integer to the record's message
+	char number[24];
+	appendPart(record, string_view(number, to_chars(number, number + sizeof(number), part).ptr - number));
+}
+
+
+#endif
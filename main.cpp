@@ -1,15 +1,31 @@
 // Header files
 #include <arpa/inet.h>
-#include <filesystem>
-#include "git2.h"
+#include <array>
+#include <csignal>
+#include <cstring>
+#include "./geolocation_service.h"
+#include "./http_server.h"
 #include <ifaddrs.h>
+#include "./ingestion_pipeline.h"
 #include <iostream>
-#include "maxminddb.h"
+#include <list>
+#include "./logger.h"
 #include <memory>
+#include "./metrics.h"
 #include <net/if.h>
+#include <optional>
+#include <netinet/in.h>
+#include "./network_crawler.h"
 #include "./node/mwc_validation_node.h"
-#include <regex>
+#include "./peer_registry.h"
+#include "./peer_store.h"
+#include <pthread.h>
+#include "./recent_peers_uploader.h"
+#include "./scheduler.h"
+#include "./snapshot_writer.h"
 #include <termios.h>
+#include "./user_agent.h"
+#include <vector>
 
 using namespace std;
 
@@ -19,12 +35,6 @@ using namespace std;
 // IP geolocate database location
 static const char *IP_GEOLOCATE_DATABASE_LOCATION = "./ip_geolocate_database.mmdb";
 
-// Git repo refspecs
-static const char *GIT_REPO_REFSPECS = "refs/heads/master";
-
-// Git uploader name
-static const char *GIT_UPLOADER_NAME = TOSTRING(PROGRAM_NAME) " Automatic Updater";
-
 // Tor SOCKS proxy address
 static const char *TOR_SOCKS_PROXY_ADDRESS = "localhost";
 
@@ -40,6 +50,40 @@ static const uint16_t TOR_SOCKS_PROXY_PORT = 9050;
 	// Recent peers JSON location
 	static const char *RECENT_PEERS_JSON_LOCATION = "./floonet_peers.json";
 	
+	// Recent peers binary location
+	static const char *RECENT_PEERS_BINARY_LOCATION = "./floonet_peers.bin";
+	
+	// Recent peers aggregates location
+	static const char *RECENT_PEERS_AGGREGATES_LOCATION = "./floonet_peers_aggregates.json";
+	
+	// Recent peers state location
+	static const char *RECENT_PEERS_STATE_LOCATION = "./floonet_peers_state.log";
+	
+	// Recent peers history location
+	static const char *RECENT_PEERS_HISTORY_LOCATION = "./floonet_peers_history.json";
+	
+	// Recent peers history state location
+	static const char *RECENT_PEERS_HISTORY_STATE_LOCATION = "./floonet_peers_history_state.bin";
+	
+	// Check if uploading the other network's recent peers files
+	#ifdef UPLOAD_OTHER_NETWORK
+	
+		// Other network recent peers JSON location
+		static const char *OTHER_NETWORK_RECENT_PEERS_JSON_LOCATION = "./mainnet_peers.json";
+		
+		// Other network recent peers binary location
+		static const char *OTHER_NETWORK_RECENT_PEERS_BINARY_LOCATION = "./mainnet_peers.bin";
+		
+		// Other network recent peers aggregates location
+		static const char *OTHER_NETWORK_RECENT_PEERS_AGGREGATES_LOCATION = "./mainnet_peers_aggregates.json";
+		
+		// Other network recent peers history location
+		static const char *OTHER_NETWORK_RECENT_PEERS_HISTORY_LOCATION = "./mainnet_peers_history.json";
+	#endif
+	
+	// HTTP server port
+	static const uint16_t HTTP_SERVER_PORT = 8031;
+	
 // Otherwise
 #else
 
@@ -48,59 +92,101 @@ static const uint16_t TOR_SOCKS_PROXY_PORT = 9050;
 	
 	// Recent peers JSON location
 	static const char *RECENT_PEERS_JSON_LOCATION = "./mainnet_peers.json";
+	
+	// Recent peers binary location
+	static const char *RECENT_PEERS_BINARY_LOCATION = "./mainnet_peers.bin";
+	
+	// Recent peers aggregates location
+	static const char *RECENT_PEERS_AGGREGATES_LOCATION = "./mainnet_peers_aggregates.json";
+	
+	// Recent peers state location
+	static const char *RECENT_PEERS_STATE_LOCATION = "./mainnet_peers_state.log";
+	
+	// Recent peers history location
+	static const char *RECENT_PEERS_HISTORY_LOCATION = "./mainnet_peers_history.json";
+	
+	// Recent peers history state location
+	static const char *RECENT_PEERS_HISTORY_STATE_LOCATION = "./mainnet_peers_history_state.bin";
+	
+	// Check if uploading the other network's recent peers files
+	#ifdef UPLOAD_OTHER_NETWORK
+	
+		// Other network recent peers JSON location
+		static const char *OTHER_NETWORK_RECENT_PEERS_JSON_LOCATION = "./floonet_peers.json";
+		
+		// Other network recent peers binary location
+		static const char *OTHER_NETWORK_RECENT_PEERS_BINARY_LOCATION = "./floonet_peers.bin";
+		
+		// Other network recent peers aggregates location
+		static const char *OTHER_NETWORK_RECENT_PEERS_AGGREGATES_LOCATION = "./floonet_peers_aggregates.json";
+		
+		// Other network recent peers history location
+		static const char *OTHER_NETWORK_RECENT_PEERS_HISTORY_LOCATION = "./floonet_peers_history.json";
+	#endif
+	
+	// HTTP server port
+	static const uint16_t HTTP_SERVER_PORT = 8030;
 #endif
 
+// Recent peers liveness window
+static const chrono::hours RECENT_PEERS_LIVENESS_WINDOW = 168h;
+
+// Recent peers capacity (the max number of recent peers that are kept so that memory use stays bounded when flooded with handshakes)
+static const size_t RECENT_PEERS_CAPACITY = 100000;
+
 // Upload recent peers JSON file interval
 static const chrono::hours UPLOAD_RECENT_PEERS_JSON_FILE_INTERVAL = 168h;
 
-// Min longitude
-static const double MIN_LONGITUDE = -180;
+// Save recent peers JSON file interval
+static const chrono::minutes SAVE_RECENT_PEERS_JSON_FILE_INTERVAL = 1min;
 
-// Max longitude
-static const double MAX_LONGITUDE = 180;
+// Save recent peers history interval
+static const chrono::minutes SAVE_RECENT_PEERS_HISTORY_INTERVAL = 15min;
 
-// Min latitude
-static const double MIN_LATITUDE = -90;
+// Check IP geolocate database interval
+static const chrono::minutes CHECK_IP_GEOLOCATE_DATABASE_INTERVAL = 1min;
 
-// Max latitude
-static const double MAX_LATITUDE = 90;
+// Closing check interval (shutdown signals are handled as soon as they're received but the node closing on its own, which it has no callback for, is only noticed at this interval)
+static const chrono::seconds CLOSING_CHECK_INTERVAL = 60s;
 
-// Known user agent pattern
-static const regex KNOWN_USER_AGENT_PATTERN(R"(^(?:MW\/MWC |MWC Validation Node |MWC Pay |MWC Node Map |mwc-node-cpp\/|mwc-node-go\/)\d{1,3}\.\d{1,3}\.\d{1,3}$)");
+// Scheduler number of workers
+static const size_t SCHEDULER_NUMBER_OF_WORKERS = 2;
 
+// Log minimum severity
+static const Logger::Severity LOG_MINIMUM_SEVERITY = Logger::Severity::INFO;
 
-// Structures
+// Check if geolocation index is enabled
+#ifdef ENABLE_GEOLOCATION_INDEX
 
-// Geolocation structure
-struct Geolocation {
-
-	// Continent
-	string continent;
-	
-	// Country
-	string country;
+	// Use geolocation index
+	static const bool USE_GEOLOCATION_INDEX = true;
 	
-	// Subdivision
-	string subdivision;
-	
-	// City
-	string city;
-	
-	// Longitude
-	double longitude = NAN;
-	
-	// Latitude
-	double latitude = NAN;
-};
+// Otherwise
+#else
+
+	// Use geolocation index
+	static const bool USE_GEOLOCATION_INDEX = false;
+#endif
 
+// Check if crawler is enabled
+#ifdef ENABLE_CRAWLER
 
-// Function prototypes
+	// Crawler concurrency
+	static const size_t CRAWLER_CONCURRENCY = 32;
+#endif
 
-// Geolocate
-static Geolocation geolocate(const string &address);
+// Check if HTTP server is enabled
+#ifdef ENABLE_HTTP_SERVER
 
-// Upload recent peers JSON file
-static void uploadRecentPeersJsonFile(const char *accessToken);
+	// HTTP server address
+	static const char *HTTP_SERVER_ADDRESS = "::";
+	
+	// HTTP server peers path
+	static const char *HTTP_SERVER_PEERS_PATH = "/peers";
+	
+	// HTTP server history path
+	static const char *HTTP_SERVER_HISTORY_PATH = "/history";
+#endif
 
 
 // Main function
@@ -188,187 +274,370 @@ int main() {
 			cout << endl << "No access token provided. Never uploading recent peers JSON file" << endl;
 		}
 		
+		// Check if blocking shutdown signals failed so that they're waited for by this thread instead of interrupting whichever thread they're delivered to since threads created after this inherit the blocked signals
+		sigset_t shutdownSignals;
+		sigemptyset(&shutdownSignals);
+		sigaddset(&shutdownSignals, SIGINT);
+		sigaddset(&shutdownSignals, SIGTERM);
+		if(pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr)) {
+		
+			// Display message
+			cout << "Blocking shutdown signals failed" << endl;
+			
+			// Return failure
+			return EXIT_FAILURE;
+		}
+		
+		// Create logger
+		Logger logger(LOG_MINIMUM_SEVERITY);
+		
+		// Create recent peers snapshot writer
+		SnapshotWriter recentPeersSnapshotWriter(RECENT_PEERS_JSON_LOCATION, RECENT_PEERS_BINARY_LOCATION, RECENT_PEERS_AGGREGATES_LOCATION, RECENT_PEERS_HISTORY_LOCATION);
+		
+		// Create geolocation service
+		GeolocationService geolocationService(IP_GEOLOCATE_DATABASE_LOCATION, logger, USE_GEOLOCATION_INDEX);
+		
+		// Create user agent table
+		UserAgentTable userAgentTable;
+		
+		// Initialize recent peers
+		PeerRegistry recentPeers(userAgentTable, RECENT_PEERS_LIVENESS_WINDOW, RECENT_PEERS_CAPACITY);
+		
+		// Create recent peers store
+		PeerStore recentPeersStore(RECENT_PEERS_STATE_LOCATION, userAgentTable);
+		
+		// Create recent peers history
+		PeerHistory recentPeersHistory(RECENT_PEERS_HISTORY_STATE_LOCATION, userAgentTable);
+		
 		// Try
 		try {
 		
-			// Check if deleting recent peers JSON file failed
-			if(filesystem::exists(RECENT_PEERS_JSON_LOCATION) && !filesystem::remove(RECENT_PEERS_JSON_LOCATION)) {
+			// Load recent peers history
+			recentPeersHistory.load();
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Display message
+			cout << "Loading recent peers history failed: " << error.what() << endl;
 			
-				// Display message
-				cout << "Deleting recent peers JSON file failed" << endl;
-				
-				// Return failure
-				return EXIT_FAILURE;
-			}
+			// Return failure
+			return EXIT_FAILURE;
+		}
+		
+		// Set recent peers history
+		recentPeers.setHistory(&recentPeersHistory);
+		
+		// Try
+		try {
+		
+			// Restore recent peers from the recent peers store
+			const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+			const size_t numberOfRestoredPeers = recentPeersStore.load(recentPeers);
+			
+			// Display message
+			cout << "Restored " << numberOfRestoredPeers << " recent peer(s) in " << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime).count() << " ms" << endl;
 		}
 		
 		// Catch errors
-		catch(...) {
+		catch(const exception &error) {
 		
 			// Display message
-			cout << "Deleting recent peers JSON file failed" << endl;
+			cout << "Restoring recent peers failed: " << error.what() << endl;
 			
 			// Return failure
 			return EXIT_FAILURE;
 		}
 		
-		// Create node
-		MwcValidationNode::Node node;
+		// Initialize recent peers lock
+		mutex recentPeersLock;
 		
 		// Initialize recent peers JSON file lock
 		mutex recentPeersJsonFileLock;
 		
-		// Set node's on peer info callback
-		node.setOnPeerInfoCallback([&recentPeersJsonFileLock](MwcValidationNode::Node &node, const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const string &userAgent, const uint32_t protocolVersion, const uint64_t baseFee, const uint64_t totalDifficulty, const bool isInbound) -> void {
+		// Create metrics
+		Metrics metrics;
 		
-			// Try
-			try {
+		// Check if uploading the other network's recent peers files
+		#ifdef UPLOAD_OTHER_NETWORK
+		
+			// Set other network recent peers locations to the files saved by the other network's process
+			const array<string, SnapshotWriter::NUMBER_OF_FILES> otherNetworkRecentPeersFiles = SnapshotWriter::createLocations(OTHER_NETWORK_RECENT_PEERS_JSON_LOCATION, OTHER_NETWORK_RECENT_PEERS_BINARY_LOCATION, OTHER_NETWORK_RECENT_PEERS_AGGREGATES_LOCATION, OTHER_NETWORK_RECENT_PEERS_HISTORY_LOCATION);
+			vector<string> otherNetworkRecentPeersLocations(otherNetworkRecentPeersFiles.begin(), otherNetworkRecentPeersFiles.end());
 			
-				// Geolocate the peer
-				const Geolocation geolocation = geolocate(peerIdentifier);
-				
-				// Lock recent peers JSON file
-				lock_guard lock(recentPeersJsonFileLock);
-				
-				// Get if recent peers JSON file exists
-				const bool fileExists = filesystem::exists(RECENT_PEERS_JSON_LOCATION);
+			// Display message
+			cout << "Uploading the other network's recent peers JSON file along with this network's" << endl;
+			
+		// Otherwise
+		#else
+		
+			// Set other network recent peers locations to nothing
+			vector<string> otherNetworkRecentPeersLocations;
+		#endif
+		
+		// Create recent peers uploader
+		RecentPeersUploader recentPeersUploader(accessToken, RECENT_PEERS_JSON_LOCATION, RECENT_PEERS_BINARY_LOCATION, RECENT_PEERS_AGGREGATES_LOCATION, RECENT_PEERS_HISTORY_LOCATION, move(otherNetworkRecentPeersLocations), recentPeersJsonFileLock, metrics, logger);
+		
+		// Create HTTP server
+		HttpServer httpServer(metrics);
+		
+		// Check if HTTP server is enabled
+		#ifdef ENABLE_HTTP_SERVER
+		
+			// Set HTTP server peers query handler
+			httpServer.setPeerQueryHandler(HTTP_SERVER_PEERS_PATH, [&recentPeers, &recentPeersLock, &metrics](const string_view &queryString, string &response) -> bool {
+			
+				// Check if query is invalid
+				const optional<PeerIndex::Query> query = PeerIndex::parseQuery(queryString);
+				if(!query.has_value()) {
 				
-				// Set recent peers JSON file to throw an exception on error
-				ofstream fout;
-				fout.exceptions(ios::badbit | ios::failbit);
+					// Return false
+					return false;
+				}
 				
-				// Open recent peers JSON file
-				fout.open(RECENT_PEERS_JSON_LOCATION, ios::binary | ios::app);
+				// Serialize peers that match the query
+				JsonSerializer querySerializer;
+				{
+					const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+					lock_guard recentPeersGuard(recentPeersLock);
+					metrics.recentPeersLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
+					recentPeers.serializeQuery(querySerializer, *query);
+				}
 				
-				// Append peer's info to recent peers JSON file
-				fout << (fileExists ? ',' : '[') << endl << "{"
+				// Set response to the serialized peers
+				response.assign(querySerializer.getData(), querySerializer.getSize());
 				
-					// Address
-					"\"address\":" << quoted(peerIdentifier.ends_with(".onion") ? to_string(hash<string>{}(peerIdentifier)) + ".onion" : peerIdentifier) << ","
-					
-					// Capabilities
-					"\"capabilities\":\"" << static_cast<uint32_t>(capabilities) << "\","
-					
-					// User agent
-					"\"user_agent\":" << quoted(regex_match(userAgent, KNOWN_USER_AGENT_PATTERN) ? userAgent : "Unknown") << ","
-					
-					// Base fee
-					"\"base_fee\":\"" << baseFee << "\","
-					
-					// Continent
-					"\"continent\":";
-					
-					// Check if geolocation's continent doesn't exist
-					if(geolocation.continent.empty()) {
-					
-						// Append no continent to recent peers JSON file
-						fout << "null";
-					}
-					
-					// Otherwise
-					else {
-					
-						// Append continent to recent peers JSON file
-						fout << quoted(geolocation.continent);
-					}
-					
-					// Country
-					fout << ",\"country\":";
-					
-					// Check if geolocation's country doesn't exist
-					if(geolocation.country.empty()) {
-					
-						// Append no country to recent peers JSON file
-						fout << "null";
-					}
-					
-					// Otherwise
-					else {
-					
-						// Append country to recent peers JSON file
-						fout << quoted(geolocation.country);
-					}
-					
-					// Subdivision
-					fout << ",\"subdivision\":";
-					
-					// Check if geolocation's subdivision doesn't exist
-					if(geolocation.subdivision.empty()) {
-					
-						// Append no subdivision to recent peers JSON file
-						fout << "null";
-					}
-					
-					// Otherwise
-					else {
+				// Return true
+				return true;
+			});
+			
+			// Set HTTP server history query handler
+			httpServer.setPeerQueryHandler(HTTP_SERVER_HISTORY_PATH, [&recentPeersHistory, &recentPeersLock, &metrics](const string_view &queryString, string &response) -> bool {
+			
+				// Check if serializing the number of unique peers for the query failed
+				JsonSerializer querySerializer;
+				{
+					const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+					lock_guard recentPeersGuard(recentPeersLock);
+					metrics.recentPeersLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
+					if(!recentPeersHistory.serializeQuery(querySerializer, queryString)) {
 					
-						// Append subdivision to recent peers JSON file
-						fout << quoted(geolocation.subdivision);
+						// Return false
+						return false;
 					}
+				}
+				
+				// Set response to the serialized number of unique peers
+				response.assign(querySerializer.getData(), querySerializer.getSize());
+				
+				// Return true
+				return true;
+			});
+			
+			// Start HTTP server
+			httpServer.start(HTTP_SERVER_ADDRESS, HTTP_SERVER_PORT);
+			
+			// Display message
+			cout << "Serving recent peers and their changes over HTTP on port " << HTTP_SERVER_PORT << endl;
+			
+			// Set recent peers on peer changed callback
+			JsonSerializer peerChangeSerializer;
+			recentPeers.setOnPeerChangedCallback([&httpServer, &recentPeers, &peerChangeSerializer](const PeerRegistry::ChangeType changeType, const string &peerIdentifier, const PeerRegistry::Peer &peer) -> void {
+			
+				// Check if HTTP server has event stream clients
+				if(httpServer.hasEventStreamClients()) {
+				
+					// Check if peer expired
+					peerChangeSerializer.clear();
+					if(changeType == PeerRegistry::ChangeType::EXPIRED) {
 					
-					// City
-					fout << ",\"city\":";
-					
-					// Check if geolocation's city doesn't exist
-					if(geolocation.city.empty()) {
-					
-						// Append no city to recent peers JSON file
-						fout << "null";
+						// Serialize peer's address
+						peerChangeSerializer.appendRaw("{\"address\":");
+						peerChangeSerializer.appendString(PeerRegistry::getPublishedAddress(peerIdentifier));
+						peerChangeSerializer.appendRaw('}');
 					}
 					
 					// Otherwise
 					else {
 					
-						// Append city to recent peers JSON file
-						fout << quoted(geolocation.city);
+						// Serialize peer
+						recentPeers.serializePeer(peerChangeSerializer, peerIdentifier, peer);
 					}
 					
-					// Longitude
-					fout << ",\"longitude\":" << (!isnan(geolocation.longitude) ? '"' + to_string(geolocation.longitude) + '"' : "null") << ","
+					// Publish peer change event
+					httpServer.publishEvent((changeType == PeerRegistry::ChangeType::ADDED) ? "add" : ((changeType == PeerRegistry::ChangeType::UPDATED) ? "update" : "expire"), string_view(peerChangeSerializer.getData(), peerChangeSerializer.getSize()));
+				}
+			});
+		#endif
+		
+		// Create ingestion pipeline
+		IngestionPipeline ingestionPipeline(geolocationService, userAgentTable, recentPeers, recentPeersLock, metrics, logger);
+		
+		// Create network crawler
+		NetworkCrawler networkCrawler(ingestionPipeline, metrics);
+		
+		// Add ingestion pipeline's metrics
+		metrics.addGauge("ingestion_queue_depth", "Number of peers waiting to be ingested", [&ingestionPipeline]() -> double {
+		
+			// Return ingestion pipeline's queue depth
+			return ingestionPipeline.getQueueDepth();
+		});
+		metrics.addCounter("ingestion_dropped_peers_total", "Peers dropped since the ingestion queue was full", [&ingestionPipeline]() -> uint64_t {
+		
+			// Return ingestion pipeline's number of dropped peers
+			return ingestionPipeline.getNumberOfDroppedPeers();
+		});
+		metrics.addCounter("ingestion_invalid_peers_total", "Peers rejected by the ingestion pipeline", [&ingestionPipeline]() -> uint64_t {
+		
+			// Return ingestion pipeline's number of invalid peers
+			return ingestionPipeline.getNumberOfInvalidPeers();
+		});
+		metrics.addCounter("ingestion_processed_peers_total", "Peers added to the recent peers", [&ingestionPipeline]() -> uint64_t {
+		
+			// Return ingestion pipeline's number of processed peers
+			return ingestionPipeline.getNumberOfProcessedPeers();
+		});
+		
+		// Add recent peers' metrics
+		metrics.addGauge("recent_peers_capacity", "Max number of recent peers that are kept", [&recentPeers]() -> double {
+		
+			// Return recent peers' capacity
+			return recentPeers.getCapacity();
+		});
+		metrics.addCounter("recent_peers_evicted_total", "Recent peers evicted to make room for new peers", [&recentPeers]() -> uint64_t {
+		
+			// Return recent peers' number of evicted peers
+			return recentPeers.getNumberOfEvictedPeers();
+		});
+		metrics.addCounter("recent_peers_rejected_total", "New peers rejected since their subnet reached its quota", [&recentPeers]() -> uint64_t {
+		
+			// Return recent peers' number of rejected peers
+			return recentPeers.getNumberOfRejectedPeers();
+		});
+		
+		// Add logger's metrics
+		metrics.addCounter("log_dropped_messages_total", "Log messages dropped since the log queue was full", [&logger]() -> uint64_t {
+		
+			// Return logger's number of dropped messages
+			return logger.getNumberOfDroppedMessages();
+		});
+		metrics.addCounter("log_suppressed_messages_total", "Log messages suppressed by rate limiting", [&logger]() -> uint64_t {
+		
+			// Return logger's number of suppressed messages
+			return logger.getNumberOfSuppressedMessages();
+		});
+		
+		// Check if HTTP server is enabled
+		#ifdef ENABLE_HTTP_SERVER
+		
+			// Add HTTP server's metrics
+			metrics.addGauge("http_clients", "Number of connected HTTP clients", [&httpServer]() -> double {
+			
+				// Return HTTP server's number of clients
+				return httpServer.getNumberOfClients();
+			});
+			metrics.addGauge("http_event_stream_clients", "Number of HTTP clients following peer events", [&httpServer]() -> double {
+			
+				// Return HTTP server's number of event stream clients
+				return httpServer.getNumberOfEventStreamClients();
+			});
+			metrics.addCounter("http_dropped_events_total", "Peer events dropped since too many were pending", [&httpServer]() -> uint64_t {
+			
+				// Return HTTP server's number of dropped events
+				return httpServer.getNumberOfDroppedEvents();
+			});
+		#endif
+		
+		// Check if crawler is enabled
+		#ifdef ENABLE_CRAWLER
+		
+			// Check if genesis block hash is overridden at compile time
+			#ifdef GENESIS_BLOCK_HASH
+			
+				// Check if parsing the overridden genesis block hash failed
+				const optional<array<uint8_t, 32>> genesisBlockHash = PeerProtocol::parseGenesisBlockHash(GENESIS_BLOCK_HASH);
+				if(!genesisBlockHash.has_value()) {
+				
+					// Display message
+					cout << "Genesis block hash is invalid" << endl;
 					
-					// Latitude
-					"\"latitude\":" << (!isnan(geolocation.latitude) ? '"' + to_string(geolocation.latitude) + '"' : "null") <<
-				"}";
+					// Return failure
+					return EXIT_FAILURE;
+				}
 				
-				// Close recent peers JSON file
-				fout.close();
-			}
+				// Start network crawler with the overridden genesis block hash
+				networkCrawler.start(genesisBlockHash.value(), CRAWLER_CONCURRENCY);
+				
+			// Otherwise
+			#else
 			
-			// Catch errors
-			catch(const exception &error) {
+				// Start network crawler with the genesis block hash of the network that the node was built for so that it follows floonet being enabled
+				array<uint8_t, 32> genesisBlockHash;
+				memcpy(genesisBlockHash.data(), MwcValidationNode::Consensus::GENESIS_BLOCK_HEADER.getBlockHash().data(), genesisBlockHash.size());
+				networkCrawler.start(genesisBlockHash, CRAWLER_CONCURRENCY);
+			#endif
 			
-				// Display message
-				cout << "Updating recent peers JSON file failed: " << error.what() << endl;
-				
-				// Return
-				return;
-			}
+			// Add network crawler's metrics
+			metrics.addGauge("crawler_known_addresses", "Number of addresses known to the crawler", [&networkCrawler]() -> double {
 			
-			// Catch errors
-			catch(...) {
+				// Return network crawler's number of known addresses
+				return networkCrawler.getNumberOfKnownAddresses();
+			});
+			metrics.addCounter("crawler_successful_probes_total", "Crawler probes that completed a handshake", [&networkCrawler]() -> uint64_t {
 			
-				// Display message
-				cout << "Updating recent peers JSON file failed" << endl;
+				// Return network crawler's number of successful probes
+				return networkCrawler.getNumberOfSuccessfulProbes();
+			});
+			metrics.addCounter("crawler_failed_probes_total", "Crawler probes that failed", [&networkCrawler]() -> uint64_t {
+			
+				// Return network crawler's number of failed probes
+				return networkCrawler.getNumberOfFailedProbes();
+			});
+			
+			// Display message
+			cout << "Crawler will probe peer addresses using " << CRAWLER_CONCURRENCY << " connections" << endl;
+			
+			// Lock recent peers
+			{
+				lock_guard recentPeersGuard(recentPeersLock);
+				
+				// Go through all recent peers
+				for(const pair<const string, PeerRegistry::Peer> &peer : recentPeers.getPeers()) {
 				
-				// Return
-				return;
+					// Add peer's address to the network crawler so that crawling resumes from the restored peers
+					networkCrawler.addAddress(peer.first);
+				}
 			}
 			
-			// Display message
-			cout << "Detected " << (isInbound ? "inbound" : "outbound") << " peer " << peerIdentifier << endl;
-		});
-		
-		// Set node's on peer healthy callback
-		node.setOnPeerHealthyCallback([](MwcValidationNode::Node &node, const string &peerIdentifier) -> bool {
-		
-			// Return false to disconnect from peer
-			return false;
-		});
+			// Check if crawler seeds are provided
+			#ifdef CRAWLER_SEEDS
+			
+				// Go through all crawler seeds
+				const string crawlerSeeds = CRAWLER_SEEDS;
+				for(size_t seedStart = 0; seedStart < crawlerSeeds.size();) {
+				
+					// Get seed's end
+					size_t seedEnd = crawlerSeeds.find(',', seedStart);
+					if(seedEnd == string::npos) {
+					
+						// Set seed's end to the end of the crawler seeds
+						seedEnd = crawlerSeeds.size();
+					}
+					
+					// Add seed to the network crawler
+					networkCrawler.addSeed(crawlerSeeds.substr(seedStart, seedEnd - seedStart));
+					
+					// Set next seed's start to after the seed
+					seedStart = seedEnd + sizeof(',');
+				}
+			#endif
+		#endif
 		
 		// Check if getting network interface addresses failed
 		ifaddrs *networkInterfaceAddresses;
 		if(getifaddrs(&networkInterfaceAddresses)) {
-			
+		
 			// Display message
 			cout << "Getting network interface addresses failed" << endl;
 			
@@ -412,12 +681,23 @@ int main() {
 		#endif
 		
 		// Go through all network interface addresses
-		bool networkInterfaceFound = false;
+		vector<string> listeningAddresses;
 		for(const ifaddrs *networkInterfaceAddress = networkInterfaceAddresses; networkInterfaceAddress; networkInterfaceAddress = networkInterfaceAddress->ifa_next) {
 		
 			// Check if network interface isn't lookback and its address exists
 			if(!(networkInterfaceAddress->ifa_flags & IFF_LOOPBACK) && networkInterfaceAddress->ifa_addr) {
 			
+				// Check if only listening on specific network interfaces
+				#ifdef LISTENING_INTERFACES
+				
+					// Check if network interface isn't one of the listening interfaces
+					if(string("," LISTENING_INTERFACES ",").find(string(",") + networkInterfaceAddress->ifa_name + ',') == string::npos) {
+					
+						// Continue
+						continue;
+					}
+				#endif
+				
 				// Check if network interface address is an IPv4 address
 				if(networkInterfaceAddress->ifa_addr->sa_family == AF_INET) {
 				
@@ -425,45 +705,38 @@ int main() {
 					char ipAddress[INET_ADDRSTRLEN];
 					if(inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in *>(networkInterfaceAddress->ifa_addr)->sin_addr, ipAddress, sizeof(ipAddress))) {
 					
-						// Display message
-						cout << "Node will listen at " << ipAddress << ':' << LISTENING_PORT << endl;
-						
-						// Start node listening on the IP address
-						node.start(TOR_SOCKS_PROXY_ADDRESS, TOR_SOCKS_PROXY_PORT, nullptr, MwcValidationNode::Node::DEFAULT_BASE_FEE, ipAddress, LISTENING_PORT, MwcValidationNode::Node::Capabilities::NONE);
-						
-						// Set network interface found to true
-						networkInterfaceFound = true;
-						
-						// Break
-						break;
+						// Add IP address to the listening addresses
+						listeningAddresses.emplace_back(ipAddress);
 					}
 				}
 				
-				// Otherwise check if network interface address is an IPv6 address
-				else if(networkInterfaceAddress->ifa_addr->sa_family == AF_INET6) {
+				// Otherwise check if network interface address is an IPv6 address that isn't link-local since those can't be listened at without a scope
+				else if(networkInterfaceAddress->ifa_addr->sa_family == AF_INET6 && !IN6_IS_ADDR_LINKLOCAL(&reinterpret_cast<const sockaddr_in6 *>(networkInterfaceAddress->ifa_addr)->sin6_addr)) {
 				
 					// Check if getting the network interface address's IP address was successful
 					char ipAddress[INET6_ADDRSTRLEN];
 					if(inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6 *>(networkInterfaceAddress->ifa_addr)->sin6_addr, ipAddress, sizeof(ipAddress))) {
 					
-						// Display message
-						cout << "Node will listen at [" << ipAddress << "]:" << LISTENING_PORT << endl;
-						
-						// Start node listening on the IP address
-						node.start(TOR_SOCKS_PROXY_ADDRESS, TOR_SOCKS_PROXY_PORT, nullptr, MwcValidationNode::Node::DEFAULT_BASE_FEE, ipAddress, LISTENING_PORT, MwcValidationNode::Node::Capabilities::NONE);
-						
-						// Set network interface found to true
-						networkInterfaceFound = true;
-						
+						// Add IP address to the listening addresses
+						listeningAddresses.emplace_back(ipAddress);
+					}
+				}
+				
+				// Check if not listening on all network interfaces
+				#ifndef LISTEN_ON_ALL_INTERFACES
+				
+					// Check if a listening address was found
+					if(!listeningAddresses.empty()) {
+					
 						// Break
 						break;
 					}
-				}
+				#endif
 			}
 		}
 		
 		// Check if no network interface was found
-		if(!networkInterfaceFound) {
+		if(listeningAddresses.empty()) {
 		
 			// Display message
 			cout << "No network interface found for the node to listen at" << endl;
@@ -472,443 +745,376 @@ int main() {
 			return EXIT_FAILURE;
 		}
 		
-		// Set last upload recent peers JSON file time to now
-		chrono::time_point lastUploadRecentPeersJsonFileTime = chrono::steady_clock::now();
+		// Check if getting the CPUs that this thread can run on failed
+		cpu_set_t savedCpus;
+		if(pthread_getaffinity_np(pthread_self(), sizeof(savedCpus), &savedCpus)) {
 		
-		// Loop while not closing
-		while(!MwcValidationNode::Common::isClosing()) {
+			// Display message
+			cout << "Getting CPUs failed" << endl;
+			
+			// Return failure
+			return EXIT_FAILURE;
+		}
+		
+		// Go through all CPUs that this thread can run on
+		vector<int> cpus;
+		for(int i = 0; i < CPU_SETSIZE; ++i) {
+		
+			// Check if this thread can run on the CPU
+			if(CPU_ISSET(i, &savedCpus)) {
+			
+				// Add CPU to the list of CPUs
+				cpus.push_back(i);
+			}
+		}
 		
-			// Check if access token exists and time to upload peers
-			if(!accessToken.empty() && chrono::steady_clock::now() - lastUploadRecentPeersJsonFileTime >= UPLOAD_RECENT_PEERS_JSON_FILE_INTERVAL) {
+		// Initialize nodes
+		list<MwcValidationNode::Node> nodes;
+		
+		// Go through all listening addresses
+		for(size_t i = 0; i < listeningAddresses.size(); ++i) {
+		
+			// Create node
+			MwcValidationNode::Node &node = nodes.emplace_back();
 			
-				// Set error occurred to false
-				bool errorOccurred = false;
+			// Set node's on peer info callback
+			node.setOnPeerInfoCallback([&ingestionPipeline, &networkCrawler, &metrics](MwcValidationNode::Node &node, const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const string &userAgent, const uint32_t protocolVersion, const uint64_t baseFee, const uint64_t totalDifficulty, const bool isInbound) -> void {
+			
+				// Increment number of handshakes
+				const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+				(isInbound ? metrics.numberOfInboundHandshakes : metrics.numberOfOutboundHandshakes).fetch_add(1, memory_order_relaxed);
 				
-				// Try
-				try {
+				// Add peer to the ingestion pipeline
+				ingestionPipeline.addPeer(peerIdentifier, capabilities, userAgent, protocolVersion, baseFee, totalDifficulty, isInbound, chrono::microseconds::zero());
 				
-					// Lock recent peers JSON file
-					lock_guard lock(recentPeersJsonFileLock);
+				// Check if peer is outbound
+				if(!isInbound) {
+				
+					// Add peer's address to the network crawler since it's listening at it
+					networkCrawler.addAddress(peerIdentifier);
+				}
+				
+				// Observe peer info callback duration
+				metrics.peerInfoCallbackDuration.observe(chrono::steady_clock::now() - startTime);
+			});
+			
+			// Set node's on peer healthy callback
+			node.setOnPeerHealthyCallback([](MwcValidationNode::Node &node, const string &peerIdentifier) -> bool {
+			
+				// Return false to disconnect from peer
+				return false;
+			});
+			
+			// Check if pinning this thread to the node's CPU failed so that the node's threads are created pinned to it
+			const int cpu = cpus.empty() ? 0 : cpus[i % cpus.size()];
+			cpu_set_t nodeCpus;
+			CPU_ZERO(&nodeCpus);
+			CPU_SET(cpu, &nodeCpus);
+			if(listeningAddresses.size() > 1 && pthread_setaffinity_np(pthread_self(), sizeof(nodeCpus), &nodeCpus)) {
+			
+				// Display message
+				cout << "Pinning node to CPU " << cpu << " failed" << endl;
+				
+				// Return failure
+				return EXIT_FAILURE;
+			}
+			
+			// Check if listening address is an IPv6 address
+			if(listeningAddresses[i].find(':') != string::npos) {
+			
+				// Display message
+				cout << "Node will listen at [" << listeningAddresses[i] << "]:" << LISTENING_PORT;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Display message
+				cout << "Node will listen at " << listeningAddresses[i] << ':' << LISTENING_PORT;
+			}
+			
+			// Check if there's multiple nodes
+			if(listeningAddresses.size() > 1) {
+			
+				// Display message
+				cout << " using CPU " << cpu;
+			}
+			
+			// Display message
+			cout << endl;
+			
+			// Start node listening on the IP address
+			node.start(TOR_SOCKS_PROXY_ADDRESS, TOR_SOCKS_PROXY_PORT, nullptr, MwcValidationNode::Node::DEFAULT_BASE_FEE, listeningAddresses[i].c_str(), LISTENING_PORT, MwcValidationNode::Node::Capabilities::NONE);
+		}
+		
+		// Check if restoring the CPUs that this thread can run on failed
+		if(listeningAddresses.size() > 1 && pthread_setaffinity_np(pthread_self(), sizeof(savedCpus), &savedCpus)) {
+		
+			// Display message
+			cout << "Restoring CPUs failed" << endl;
+			
+			// Return failure
+			return EXIT_FAILURE;
+		}
+		
+		// Create scheduler
+		Scheduler scheduler(metrics, logger, SCHEDULER_NUMBER_OF_WORKERS);
+		
+		// Check if access token exists
+		if(!accessToken.empty()) {
+		
+			// Schedule uploading recent peers JSON file
+			scheduler.schedulePeriodic("upload recent peers JSON file", UPLOAD_RECENT_PEERS_JSON_FILE_INTERVAL, [&recentPeersUploader, &logger]() -> void {
+			
+				// Check if starting to upload the last saved recent peers files failed
+				if(!recentPeersUploader.upload()) {
+				
+					// Log message
+					logger.log(Logger::Severity::WARNING, Logger::MessageType::GENERAL, "Uploading recent peers JSON file failed: Previous upload is still in progress");
+				}
+			});
+		}
+		
+		// Schedule saving recent peers JSON file
+		uint64_t lastNumberOfDroppedPeers = 0;
+		scheduler.schedulePeriodic("save recent peers JSON file", SAVE_RECENT_PEERS_JSON_FILE_INTERVAL, [&]() -> void {
+		
+			// Try
+			try {
+			
+				// Lock recent peers
+				bool recentPeersSerialized = false;
+				{
+					const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+					lock_guard recentPeersGuard(recentPeersLock);
+					metrics.recentPeersLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
+					const chrono::steady_clock::time_point serializeStartTime = chrono::steady_clock::now();
 					
-					// Try
-					try {
+					// Expire recent peers that haven't been seen within the liveness window
+					recentPeers.expirePeers();
+					metrics.numberOfUniquePeers.store(recentPeers.getPeers().size(), memory_order_relaxed);
 					
-						// Get if recent peers JSON file exists
-						const bool fileExists = filesystem::exists(RECENT_PEERS_JSON_LOCATION);
-						
-						// Set recent peers JSON file to throw an exception on error
-						ofstream fout;
-						fout.exceptions(ios::badbit | ios::failbit);
-						
-						// Open recent peers JSON file
-						fout.open(RECENT_PEERS_JSON_LOCATION, ios::binary | ios::app);
-						
-						// Append end of peers to recent peers JSON file
-						fout << (fileExists ? "" : "[") << endl << ']';
-						
-						// Close recent peers JSON file
-						fout.close();
-						
-						// Upload recent peers JSON file
-						uploadRecentPeersJsonFile(accessToken.c_str());
-					}
+					// Serialize recent peers that were seen since the last save for the recent peers store
+					recentPeersStore.serialize(recentPeers);
 					
-					// Catch errors
-					catch(const exception &error) {
+					// Check if recent peers changed
+					if(recentPeers.isChanged()) {
 					
-						// Display message
-						cout << "Uploading recent peers JSON file failed: " << error.what() << endl;
+						// Serialize recent peers
+						recentPeersSnapshotWriter.serialize(recentPeers);
 						
-						// Set error occurred to true
-						errorOccurred = true;
+						// Set recent peers serialized to true
+						recentPeersSerialized = true;
 					}
 					
-					// Catch errors
-					catch(...) {
+					// Observe serialize duration
+					metrics.serializeDuration.observe(chrono::steady_clock::now() - serializeStartTime);
+				}
+				
+				// Check if recent peers were serialized
+				if(recentPeersSerialized) {
+				
+					// Compress serialized recent peers
+					const chrono::steady_clock::time_point saveStartTime = chrono::steady_clock::now();
+					recentPeersSnapshotWriter.compress();
 					
-						// Display message
-						cout << "Uploading recent peers JSON file failed" << endl;
-						
-						// Set error occurred to true
-						errorOccurred = true;
-					}
+					// Check if HTTP server is enabled
+					#ifdef ENABLE_HTTP_SERVER
 					
-					// Try
-					try {
+						// Publish serialized recent peers to HTTP clients
+						httpServer.publishSnapshot(recentPeersSnapshotWriter);
+					#endif
 					
-						// Check if deleting recent peers JSON file failed
-						if(filesystem::exists(RECENT_PEERS_JSON_LOCATION) && !filesystem::remove(RECENT_PEERS_JSON_LOCATION)) {
-						
-							// Display message
-							cout << "Deleting recent peers JSON file failed" << endl;
-							
-							// Return failure
-							return EXIT_FAILURE;
-						}
-					}
+					// Lock recent peers JSON file
+					const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+					lock_guard recentPeersJsonFileGuard(recentPeersJsonFileLock);
+					const chrono::steady_clock::time_point lockEndTime = chrono::steady_clock::now();
+					metrics.recentPeersFileLockWaitDuration.observe(lockEndTime - lockStartTime);
 					
-					// Catch errors
-					catch(...) {
+					// Save serialized recent peers to the recent peers JSON file and its binary and compressed copies
+					recentPeersSnapshotWriter.save();
 					
-						// Display message
-						cout << "Deleting recent peers JSON file failed" << endl;
-						
-						// Return failure
-						return EXIT_FAILURE;
-					}
+					// Observe save duration without the time spent waiting for the lock
+					metrics.saveDuration.observe(chrono::steady_clock::now() - saveStartTime - (lockEndTime - lockStartTime));
 				}
+			}
+			
+			// Catch errors
+			catch(const exception &error) {
+			
+				// Log message
+				logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers JSON file failed: ", error.what());
+			}
+			
+			// Catch errors
+			catch(...) {
+			
+				// Log message
+				logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers JSON file failed");
+			}
+			
+			// Try
+			try {
+			
+				// Save serialized recent peers to the recent peers store
+				recentPeersStore.save();
+			}
+			
+			// Catch errors
+			catch(const exception &error) {
+			
+				// Log message
+				logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers state failed: ", error.what());
+			}
+			
+			// Check if the ingestion pipeline dropped peers since the last save
+			const uint64_t numberOfDroppedPeers = ingestionPipeline.getNumberOfDroppedPeers();
+			if(numberOfDroppedPeers != lastNumberOfDroppedPeers) {
+			
+				// Log message
+				logger.log(Logger::Severity::WARNING, Logger::MessageType::GENERAL, "Ingestion pipeline dropped ", numberOfDroppedPeers - lastNumberOfDroppedPeers, " peer(s) with a queue depth of ", ingestionPipeline.getQueueDepth());
 				
-				// Catch errors
-				catch(...) {
-				
-					// Display message
-					cout << "Uploading recent peers JSON file failed" << endl;
-					
-					// Set error occurred to true
-					errorOccurred = true;
-				}
+				// Set last number of dropped peers to the number of dropped peers
+				lastNumberOfDroppedPeers = numberOfDroppedPeers;
+			}
+		});
+		
+		// Schedule saving recent peers history
+		scheduler.schedulePeriodic("save recent peers history", SAVE_RECENT_PEERS_HISTORY_INTERVAL, [&recentPeersHistory, &recentPeersLock, &metrics, &logger]() -> void {
+		
+			// Lock recent peers
+			{
+				const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+				lock_guard recentPeersGuard(recentPeersLock);
+				metrics.recentPeersLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
 				
-				// Check if an error didn't occur
-				if(!errorOccurred) {
+				// Serialize recent peers history
+				recentPeersHistory.serialize();
+			}
+			
+			// Try
+			try {
+			
+				// Save serialized recent peers history
+				recentPeersHistory.save();
+			}
+			
+			// Catch errors
+			catch(const exception &error) {
+			
+				// Log message
+				logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers history failed: ", error.what());
+			}
+		});
+		
+		// Schedule checking IP geolocate database
+		scheduler.schedulePeriodic("check IP geolocate database", CHECK_IP_GEOLOCATE_DATABASE_INTERVAL, [&geolocationService, &logger]() -> void {
+		
+			// Check if IP geolocate database is being reloaded
+			if(geolocationService.reloadIfChanged()) {
+			
+				// Log message
+				logger.log(Logger::Severity::INFO, Logger::MessageType::GENERAL, "Reloading IP geolocate database");
+			}
+		});
+		
+		// Loop while not closing
+		const timespec closingCheckInterval = {
+		
+			// Seconds
+			.tv_sec = CLOSING_CHECK_INTERVAL.count()
+		};
+		while(!MwcValidationNode::Common::isClosing()) {
+		
+			// Check if a shutdown signal was received before the closing check interval elapsed
+			const int signal = sigtimedwait(&shutdownSignals, nullptr, &closingCheckInterval);
+			if(signal > 0) {
+			
+				// Check if unblocking shutdown signals failed
+				if(pthread_sigmask(SIG_UNBLOCK, &shutdownSignals, nullptr)) {
 				
 					// Display message
-					cout << "Successfully uploading recent peers JSON file" << endl;
+					cout << "Unblocking shutdown signals failed" << endl;
+					
+					// Return failure
+					return EXIT_FAILURE;
 				}
 				
-				// Set last upload recent peers JSON file time to now
-				lastUploadRecentPeersJsonFileTime = chrono::steady_clock::now();
+				// Raise the signal again now that it's unblocked so that it's handled the same way it would have been without waiting for it
+				raise(signal);
 			}
-			
-			// Sleep
-			this_thread::sleep_for(1s);
 		}
-	}
-	
-	// Catch errors
-	catch(const exception &error) {
-	
-		// Display message
-		cout << "Unexpected error occurred: " << error.what() << endl;
-		
-		// Return failure
-		return EXIT_FAILURE;
-	}
-	
-	// Catch errors
-	catch(...) {
-	
-		// Display message
-		cout << "Unexpected error occurred" << endl;
-		
-		// Return failure
-		return EXIT_FAILURE;
-	}
-	
-	// Return failure is an error occurred otherwise return success
-	return MwcValidationNode::Common::errorOccurred() ? EXIT_FAILURE : EXIT_SUCCESS;
-}
-
-
-// Supporting function implementation
-
-// Geolocate
-Geolocation geolocate(const string &address) {
-
-	// Initialize geolocation
-	Geolocation geolocation;
-	
-	// Initialize IP address
-	sockaddr_storage ipAddress;
-	
-	// Check if address is an IPv6 address and port
-	if(address.starts_with('[') && address.contains(']')) {
-	
-		// Get address without port
-		const string addressWithoutPort = address.substr(sizeof('['), address.find(']') - sizeof('['));
 		
-		// Check if parsing the address without port as an IPv6 address was successful
-		if(inet_pton(AF_INET6, addressWithoutPort.c_str(), &reinterpret_cast<sockaddr_in6 *>(&ipAddress)->sin6_addr) == 1) {
+		// Stop nodes and network crawler so that no more peers are found
+		nodes.clear();
+		networkCrawler.stop();
 		
-			// Set IP address's family to IPv6
-			ipAddress.ss_family = AF_INET6;
-		}
+		// Stop ingestion pipeline after it adds the peers that are already queued to the recent peers
+		ingestionPipeline.stop();
 		
-		// Otherwise
-		else {
+		// Stop scheduler so that no tasks are running while the recent peers are saved for the last time
+		scheduler.stop();
 		
-			// Return geolocation
-			return geolocation;
+		// Lock recent peers
+		{
+			lock_guard recentPeersGuard(recentPeersLock);
+			
+			// Serialize recent peers that were seen since the last save for the recent peers store
+			recentPeersStore.serialize(recentPeers);
+			
+			// Serialize recent peers history
+			recentPeersHistory.serialize();
 		}
-	}
-	
-	// Otherwise check if address is an IPv4 address and port
-	else if(address.contains(':')) {
-	
-		// Get address without port
-		const string addressWithoutPort = address.substr(0, address.find(':'));
 		
-		// Check if parsing the address without port as an IPv4 address was successful
-		if(inet_pton(AF_INET, addressWithoutPort.c_str(), &reinterpret_cast<sockaddr_in *>(&ipAddress)->sin_addr) == 1) {
+		// Try
+		try {
 		
-			// Set IP address's family to IPv4
-			ipAddress.ss_family = AF_INET;
+			// Save serialized recent peers to the recent peers store so that they're restored after restarting
+			recentPeersStore.save();
 		}
 		
-		// Otherwise
-		else {
+		// Catch errors
+		catch(const exception &error) {
 		
-			// Return geolocation
-			return geolocation;
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers state failed: ", error.what());
 		}
-	}
-	
-	// Otherwise
-	else {
-	
-		// Return geolocation
-		return geolocation;
-	}
-	
-	// Check if opening the IP geolocate database failed
-	MMDB_s ipGeolocateDatabase;
-	if(MMDB_open(IP_GEOLOCATE_DATABASE_LOCATION, MMDB_MODE_MMAP, &ipGeolocateDatabase) != MMDB_SUCCESS) {
-	
-		// Throw exception
-		throw runtime_error("Opening the IP geolocate database failed");
-	}
-	
-	// Automatically close the IP geolocate database when done
-	const unique_ptr<MMDB_s, decltype(&MMDB_close)> addressInfoUniquePointer(&ipGeolocateDatabase, MMDB_close);
-	
-	// Check if looking up the IP address in the IP geolocate database failed
-	int error;
-	MMDB_lookup_result_s ipGeolocateResult = MMDB_lookup_sockaddr(&ipGeolocateDatabase, reinterpret_cast<const sockaddr *>(&ipAddress), &error);
-	if(error != MMDB_SUCCESS) {
-	
-		// Throw exception
-		throw runtime_error("Looking up the IP address in the IP geolocate database failed");
-	}
-	
-	// Check if IP address doesn't exist in the IP geolocate database
-	if(!ipGeolocateResult.found_entry) {
-	
-		// Return geolocation
-		return geolocation;
-	}
-	
-	// Check if getting the IP geolocate result's continent was successful
-	MMDB_entry_data_s ipGeolocateEntryData;
-	if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "continent", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
-	
-		// Set geolocation's continent to the result
-		geolocation.continent = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
-	}
-	
-	// Check if getting the IP geolocate result's country was successful
-	if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "country", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
-	
-		// Set geolocation's country to the result
-		geolocation.country = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
-	}
-	
-	// Check if getting the IP geolocate result's subdivision was successful
-	if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "subdivisions", "0", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
-	
-		// Set geolocation's subdivision to the result
-		geolocation.subdivision = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
-	}
-	
-	// Check if getting the IP geolocate result's city was successful
-	if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "city", "names", "en", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_UTF8_STRING && MwcValidationNode::Common::isUtf8(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.data_size)) {
-	
-		// Set geolocation's city to the result
-		geolocation.city = string(ipGeolocateEntryData.utf8_string, ipGeolocateEntryData.utf8_string + ipGeolocateEntryData.data_size);
-	}
-	
-	// Check if getting the IP geolocate result's longitude was successful
-	if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "location", "longitude", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_DOUBLE && isfinite(ipGeolocateEntryData.double_value) && ipGeolocateEntryData.double_value >= MIN_LONGITUDE && ipGeolocateEntryData.double_value <= MAX_LONGITUDE) {
-	
-		// Set geolocation's longitude to the result
-		geolocation.longitude = ipGeolocateEntryData.double_value;
 		
-		// Check if getting the IP geolocate result's latitude failed
-		if(MMDB_get_value(&ipGeolocateResult.entry, &ipGeolocateEntryData, "location", "latitude", nullptr) == MMDB_SUCCESS && ipGeolocateEntryData.has_data && ipGeolocateEntryData.type == MMDB_DATA_TYPE_DOUBLE && isfinite(ipGeolocateEntryData.double_value) && ipGeolocateEntryData.double_value >= MIN_LATITUDE && ipGeolocateEntryData.double_value <= MAX_LATITUDE) {
+		// Try
+		try {
 		
-			// Set geolocation's latitude to the result
-			geolocation.latitude = ipGeolocateEntryData.double_value;
+			// Save serialized recent peers history so that it continues after restarting
+			recentPeersHistory.save();
 		}
 		
-		// Otherwise
-		else {
+		// Catch errors
+		catch(const exception &error) {
 		
-			// Reset geolocation's longitude
-			geolocation.longitude = NAN;
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Saving recent peers history failed: ", error.what());
 		}
 	}
 	
-	// Return geolocation
-	return geolocation;
-}
-
-// Upload recent peers JSON file
-void uploadRecentPeersJsonFile(const char *accessToken) {
-
-	// Check if initializing Git failed
-	const int initializeGitResult = git_libgit2_init();
-	if(initializeGitResult < 0) {
-	
-		// Throw exception
-		throw runtime_error("Initializing Git failed");
-	}
-	
-	// Automatically shutdown Git when done
-	const unique_ptr<int, void(*)(int *)> initializeGitResultUniquePointer(const_cast<int *>(&initializeGitResult), [](int *initializeGitResultPointer) {
-	
-		// Shutdown Git
-		git_libgit2_shutdown();
-	});
-	
-	// Check if opening repo failed
-	git_repository *repo;
-	if(git_repository_open(&repo, "./") < 0) {
-	
-		// Throw exception
-		throw runtime_error("Opening repo failed");
-	}
-	
-	// Automatically free repo when done
-	const unique_ptr<git_repository, decltype(&git_repository_free)> repoUniquePointer(repo, git_repository_free);
-	
-	// Check if getting repo's index failed
-	git_index *index;
-	if(git_repository_index(&index, repo) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting repo's index failed");
-	}
-	
-	// Automatically free index when done
-	const unique_ptr<git_index, decltype(&git_index_free)> indexUniquePointer(index, git_index_free);
-	
-	// Check if changing index to update recent peers JSON file failed
-	if(git_index_add_bypath(index, &RECENT_PEERS_JSON_LOCATION[sizeof("./") - sizeof('\0')]) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Changing index to update recent peers JSON file failed");
-	}
-	
-	// Check if saving index failed
-	if(git_index_write(index) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Saving index failed");
-	}
-	
-	// Check if getting tree ID from the index failed
-	git_oid treeId;
-	if(git_index_write_tree(&treeId, index) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting tree ID from the index failed");
-	}
-	
-	// Check if getting tree with the tree ID failed
-	git_tree *tree;
-	if(git_tree_lookup(&tree, repo, &treeId) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting tree with the tree ID failed");
-	}
-	
-	// Automatically free tree when done
-	const unique_ptr<git_tree, decltype(&git_tree_free)> treeUniquePointer(tree, git_tree_free);
-	
-	// Check if creating signature failed
-	git_signature *signature;
-	if(git_signature_now(&signature, GIT_UPLOADER_NAME, "unknown") < 0) {
-	
-		// Throw exception
-		throw runtime_error("Creating signature failed");
-	}
-	
-	// Automatically free signature when done
-	const unique_ptr<git_signature, decltype(&git_signature_free)> signatureUniquePointer(signature, git_signature_free);
-	
-	// Check if getting repo's head ID failed
-	git_oid headId;
-	if(git_reference_name_to_id(&headId, repo, "HEAD") < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting repo's head ID failed");
-	}
-	
-	// Check if getting head commit failed
-	git_commit *headCommit;
-	if(git_commit_lookup(&headCommit, repo, &headId) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting head commit failed");
-	}
-	
-	// Automatically free head commit when done
-	const unique_ptr<git_commit, decltype(&git_commit_free)> headCommitUniquePointer(headCommit, git_commit_free);
-	
-	// Check if creating commit for the tree failed
-	git_oid commitId;
-	if(git_commit_create(&commitId, repo, "HEAD", signature, signature, "UTF-8", (string("Automatically updated ") + &RECENT_PEERS_JSON_LOCATION[sizeof("./") - sizeof('\0')]).c_str(), tree, 1, const_cast<const git_commit **>(&headCommit)) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Creating commit for the tree failed");
-	}
-	
-	// Check if getting repo's remote failed
-	git_remote *remote;
-	if(git_remote_lookup(&remote, repo, "origin") < 0) {
-	
-		// Throw exception
-		throw runtime_error("Getting repo's remote failed");
-	}
-	
-	// Automatically free remote when done
-	const unique_ptr<git_remote, decltype(&git_remote_free)> remoteUniquePointer(remote, git_remote_free);
-	
-	// Set refspecs
-	const git_strarray refspecs = {
+	// Catch errors
+	catch(const exception &error) {
 	
-		// Strings
-		const_cast<char **>(&GIT_REPO_REFSPECS),
+		// Display message
+		cout << "Unexpected error occurred: " << error.what() << endl;
 		
-		// Count
-		1
-	};
+		// Return failure
+		return EXIT_FAILURE;
+	}
 	
-	// Set push options
-	git_push_options pushOptions = GIT_PUSH_OPTIONS_INIT;
-	pushOptions.callbacks.payload = const_cast<char *>(accessToken);
-	pushOptions.callbacks.credentials = [](git_credential **out, const char *url, const char *usernameFromUrl, unsigned int allowedTypes, void *payload) -> int {
+	// Catch errors
+	catch(...) {
 	
-		// Check if plain text credentials is allowed
-		if(allowedTypes & GIT_CREDENTIAL_USERPASS_PLAINTEXT) {
-		
-			// Get access token from payload
-			const char *accessToken = reinterpret_cast<const char *>(payload);
-			
-			// Return plain text credentials
-			return git_credential_userpass_plaintext_new(out, GIT_UPLOADER_NAME, accessToken);
-		}
-		
-		// Otherwise
-		else {
+		// Display message
+		cout << "Unexpected error occurred" << endl;
 		
-			// Return error
-			return -1;
-		}
-	};
-	
-	// Check if pushing changes to remote failed
-	if(git_remote_push(remote, &refspecs, &pushOptions) < 0) {
-	
-		// Throw exception
-		throw runtime_error("Pushing changes to remote failed");
+		// Return failure
+		return EXIT_FAILURE;
 	}
+	
+	// Return failure is an error occurred otherwise return success
+	return MwcValidationNode::Common::errorOccurred() ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,238 @@
+// Header files
+#include <bit>
+#include <charconv>
+#include "./metrics.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Latency histogram constructor
+LatencyHistogram::LatencyHistogram() :
+
+	// Set sum to zero
+	sum(0)
+{
+
+	// Go through all buckets
+	for(atomic<uint64_t> &bucket : buckets) {
+	
+		// Set bucket to zero
+		bucket.store(0, memory_order_relaxed);
+	}
+}
+
+// Latency histogram observe
+void LatencyHistogram::observe(const chrono::steady_clock::duration &duration) {
+
+	// Get duration in nanoseconds and whole microseconds rounded up
+	const uint64_t nanoseconds = max<int64_t>(chrono::duration_cast<chrono::nanoseconds>(duration).count(), 0);
+	const uint64_t microseconds = (nanoseconds + 999) / 1000;
+	
+	// Increment the bucket whose upper bound is the smallest power of two microseconds that isn't less than the duration
+	buckets[min<size_t>((microseconds <= 1) ? 0 : bit_width(microseconds - 1), NUMBER_OF_BUCKETS)].fetch_add(1, memory_order_relaxed);
+	
+	// Add duration to the sum
+	sum.fetch_add(nanoseconds, memory_order_relaxed);
+}
+
+// Latency histogram serialize
+void LatencyHistogram::serialize(string &output, const string_view &name, const string_view &labels) const {
+
+	// Go through all buckets
+	uint64_t count = 0;
+	char number[32];
+	for(size_t i = 0; i <= NUMBER_OF_BUCKETS; ++i) {
+	
+		// Append bucket's cumulative count with its upper bound in seconds
+		count += buckets[i].load(memory_order_relaxed);
+		output.append(name).append("_bucket{").append(labels).append(labels.empty() ? "le=\"" : ",le=\"");
+		if(i == NUMBER_OF_BUCKETS) {
+		
+			// Append infinite upper bound
+			output.append("+Inf");
+		}
+		else {
+		
+			// Append upper bound
+			output.append(number, to_chars(number, number + sizeof(number), static_cast<double>(UINT64_C(1) << i) / 1000000).ptr);
+		}
+		output.append("\"} ").append(to_string(count)).append("\n");
+	}
+	
+	// Append sum in seconds
+	output.append(name).append("_sum");
+	if(!labels.empty()) {
+	
+		// Append labels
+		output.append("{").append(labels).append("}");
+	}
+	output.append(" ").append(number, to_chars(number, number + sizeof(number), static_cast<double>(sum.load(memory_order_relaxed)) / 1000000000).ptr).append("\n");
+	
+	// Append count
+	output.append(name).append("_count");
+	if(!labels.empty()) {
+	
+		// Append labels
+		output.append("{").append(labels).append("}");
+	}
+	output.append(" ").append(to_string(count)).append("\n");
+}
+
+// Constructor
+Metrics::Metrics() :
+
+	// Set number of inbound handshakes to zero
+	numberOfInboundHandshakes(0),
+	
+	// Set number of outbound handshakes to zero
+	numberOfOutboundHandshakes(0),
+	
+	// Set number of successful uploads to zero
+	numberOfSuccessfulUploads(0),
+	
+	// Set number of skipped uploads to zero
+	numberOfSkippedUploads(0),
+	
+	// Set number of failed uploads to zero
+	numberOfFailedUploads(0),
+	
+	// Set number of unique peers to zero
+	numberOfUniquePeers(0)
+{
+}
+
+// Add gauge
+void Metrics::addGauge(const char *name, const char *help, const function<double()> &value) {
+
+	// Lock
+	lock_guard guard(callbackMetricsLock);
+	
+	// Add gauge to the callback metrics
+	callbackMetrics.push_back({
+	
+		// Name
+		.name = name,
+		
+		// Help
+		.help = help,
+		
+		// Gauge value
+		.gaugeValue = value
+	});
+}
+
+// Add counter
+void Metrics::addCounter(const char *name, const char *help, const function<uint64_t()> &value) {
+
+	// Lock
+	lock_guard guard(callbackMetricsLock);
+	
+	// Add counter to the callback metrics
+	callbackMetrics.push_back({
+	
+		// Name
+		.name = name,
+		
+		// Help
+		.help = help,
+		
+		// Counter value
+		.counterValue = value
+	});
+}
+
+// Serialize
+string Metrics::serialize() const {
+
+	// Histogram metric structure
+	struct HistogramMetric {
+	
+		// Name
+		const char *name;
+		
+		// Help
+		const char *help;
+		
+		// Histogram
+		const LatencyHistogram &histogram;
+	};
+	
+	// Go through all histograms
+	string output;
+	const HistogramMetric histograms[] = {
+		{"peer_info_callback_duration_seconds", "Time spent in a node's peer info callback", peerInfoCallbackDuration},
+		{"geolocate_duration_seconds", "Time spent geolocating a peer", geolocateDuration},
+		{"serialize_duration_seconds", "Time spent serializing recent peers while holding their lock", serializeDuration},
+		{"save_duration_seconds", "Time spent compressing and writing recent peers files", saveDuration},
+		{"recent_peers_file_lock_wait_duration_seconds", "Time spent waiting for the recent peers file lock", recentPeersFileLockWaitDuration},
+		{"recent_peers_lock_wait_duration_seconds", "Time spent waiting for the recent peers lock", recentPeersLockWaitDuration},
+		{"upload_duration_seconds", "Time spent saving, committing, and pushing recent peers files", uploadDuration},
+		{"scheduler_task_duration_seconds", "Time spent running scheduled tasks", schedulerTaskDuration},
+		{"scheduler_task_lag_seconds", "Time between a scheduled task's deadline and when it started running", schedulerTaskLag},
+		{"crawler_connect_duration_seconds", "Time the crawler spent connecting to a peer", crawlerConnectDuration},
+		{"crawler_handshake_duration_seconds", "Time between the crawler sending a hand message and receiving the peer's shake message", crawlerHandshakeDuration},
+		{"crawler_peer_info_duration_seconds", "Time between the crawler starting to connect to a peer and getting the peer's info", crawlerPeerInfoDuration}
+	};
+	for(const HistogramMetric &histogram : histograms) {
+	
+		// Append histogram
+		const string name = string(NAME_PREFIX) + histogram.name;
+		appendHeader(output, name, histogram.help, "histogram");
+		histogram.histogram.serialize(output, name, "");
+	}
+	
+	// Append handshakes
+	const string handshakesName = string(NAME_PREFIX) + "handshakes_total";
+	appendHeader(output, handshakesName, "Completed handshakes by direction", "counter");
+	output.append(handshakesName).append("{direction=\"inbound\"} ").append(to_string(numberOfInboundHandshakes.load(memory_order_relaxed))).append("\n");
+	output.append(handshakesName).append("{direction=\"outbound\"} ").append(to_string(numberOfOutboundHandshakes.load(memory_order_relaxed))).append("\n");
+	
+	// Append uploads
+	const string uploadsName = string(NAME_PREFIX) + "uploads_total";
+	appendHeader(output, uploadsName, "Uploads by outcome", "counter");
+	output.append(uploadsName).append("{outcome=\"success\"} ").append(to_string(numberOfSuccessfulUploads.load(memory_order_relaxed))).append("\n");
+	output.append(uploadsName).append("{outcome=\"skipped\"} ").append(to_string(numberOfSkippedUploads.load(memory_order_relaxed))).append("\n");
+	output.append(uploadsName).append("{outcome=\"failure\"} ").append(to_string(numberOfFailedUploads.load(memory_order_relaxed))).append("\n");
+	
+	// Append unique peers
+	const string uniquePeersName = string(NAME_PREFIX) + "unique_peers";
+	appendHeader(output, uniquePeersName, "Number of recent peers", "gauge");
+	output.append(uniquePeersName).append(" ").append(to_string(numberOfUniquePeers.load(memory_order_relaxed))).append("\n");
+	
+	// Lock
+	lock_guard guard(callbackMetricsLock);
+	
+	// Go through all callback metrics
+	char number[32];
+	for(const CallbackMetric &callbackMetric : callbackMetrics) {
+	
+		// Check if callback metric is a gauge
+		const string name = string(NAME_PREFIX) + callbackMetric.name;
+		if(callbackMetric.gaugeValue) {
+		
+			// Append gauge
+			appendHeader(output, name, callbackMetric.help, "gauge");
+			output.append(name).append(" ").append(number, to_chars(number, number + sizeof(number), callbackMetric.gaugeValue()).ptr).append("\n");
+		}
+		
+		// Otherwise
+		else {
+		
+			// Append counter
+			appendHeader(output, name, callbackMetric.help, "counter");
+			output.append(name).append(" ").append(to_string(callbackMetric.counterValue())).append("\n");
+		}
+	}
+	
+	// Return output
+	return output;
+}
+
+// Append header
+void Metrics::appendHeader(string &output, const string_view &name, const string_view &help, const string_view &type) {
+
+	// Append help and type
+	output.append("# HELP ").append(name).append(" ").append(help).append("\n# TYPE ").append(name).append(" ").append(type).append("\n");
+}
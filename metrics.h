@@ -0,0 +1,167 @@
+// Header guard
+#ifndef METRICS_H
+#define METRICS_H
+
+
+// Header files
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Latency histogram class (lock-free histogram with power of two microsecond buckets)
+class LatencyHistogram final {
+
+	// Public
+	public:
+	
+		// Constructor
+		LatencyHistogram();
+		
+		// Copy constructor
+		LatencyHistogram(const LatencyHistogram &other) = delete;
+		
+		// Copy assignment operator
+		LatencyHistogram &operator=(const LatencyHistogram &other) = delete;
+		
+		// Observe
+		void observe(const chrono::steady_clock::duration &duration);
+		
+		// Serialize
+		void serialize(string &output, const string_view &name, const string_view &labels) const;
+		
+	// Private
+	private:
+	
+		// Number of buckets (the last finite bucket's upper bound is about 67 seconds)
+		static constexpr const size_t NUMBER_OF_BUCKETS = 27;
+		
+		// Buckets (not cumulative with an extra bucket for durations that are larger than the last bucket's upper bound)
+		array<atomic<uint64_t>, NUMBER_OF_BUCKETS + 1> buckets;
+		
+		// Sum in nanoseconds
+		atomic<uint64_t> sum;
+};
+
+// Metrics class (counters and histograms that are cheap to record from any thread and can be exported in the Prometheus text format)
+class Metrics final {
+
+	// Public
+	public:
+	
+		// Constructor
+		Metrics();
+		
+		// Copy constructor
+		Metrics(const Metrics &other) = delete;
+		
+		// Copy assignment operator
+		Metrics &operator=(const Metrics &other) = delete;
+		
+		// Add gauge (the value is read when the metrics are serialized)
+		void addGauge(const char *name, const char *help, const function<double()> &value);
+		
+		// Add counter (the value is read when the metrics are serialized)
+		void addCounter(const char *name, const char *help, const function<uint64_t()> &value);
+		
+		// Serialize
+		string serialize() const;
+		
+		// Peer info callback duration
+		LatencyHistogram peerInfoCallbackDuration;
+		
+		// Geolocate duration
+		LatencyHistogram geolocateDuration;
+		
+		// Serialize duration
+		LatencyHistogram serializeDuration;
+		
+		// Save duration
+		LatencyHistogram saveDuration;
+		
+		// Recent peers file lock wait duration
+		LatencyHistogram recentPeersFileLockWaitDuration;
+		
+		// Recent peers lock wait duration
+		LatencyHistogram recentPeersLockWaitDuration;
+		
+		// Upload duration
+		LatencyHistogram uploadDuration;
+		
+		// Scheduler task duration
+		LatencyHistogram schedulerTaskDuration;
+		
+		// Scheduler task lag
+		LatencyHistogram schedulerTaskLag;
+		
+		// Crawler connect duration
+		LatencyHistogram crawlerConnectDuration;
+		
+		// Crawler handshake duration
+		LatencyHistogram crawlerHandshakeDuration;
+		
+		// Crawler peer info duration
+		LatencyHistogram crawlerPeerInfoDuration;
+		
+		// Number of inbound handshakes
+		atomic<uint64_t> numberOfInboundHandshakes;
+		
+		// Number of outbound handshakes
+		atomic<uint64_t> numberOfOutboundHandshakes;
+		
+		// Number of successful uploads
+		atomic<uint64_t> numberOfSuccessfulUploads;
+		
+		// Number of skipped uploads
+		atomic<uint64_t> numberOfSkippedUploads;
+		
+		// Number of failed uploads
+		atomic<uint64_t> numberOfFailedUploads;
+		
+		// Number of unique peers
+		atomic<uint64_t> numberOfUniquePeers;
+		
+	// Private
+	private:
+	
+		// Name prefix
+		static constexpr const char NAME_PREFIX[] = "mwc_node_map_";
+		
+		// Callback metric structure
+		struct CallbackMetric {
+		
+			// Name
+			const char *name;
+			
+			// Help
+			const char *help;
+			
+			// Gauge value
+			function<double()> gaugeValue;
+			
+			// Counter value
+			function<uint64_t()> counterValue;
+		};
+		
+		// Append header
+		static void appendHeader(string &output, const string_view &name, const string_view &help, const string_view &type);
+		
+		// Callback metrics
+		vector<CallbackMetric> callbackMetrics;
+		
+		// Callback metrics lock
+		mutable mutex callbackMetricsLock;
+};
+
+
+#endif
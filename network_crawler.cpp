@@ -0,0 +1,717 @@
+// Header files
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include "./network_crawler.h"
+#include <poll.h>
+#include <random>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+NetworkCrawler::NetworkCrawler(IngestionPipeline &ingestionPipeline, Metrics &metrics) :
+
+	// Set ingestion pipeline to ingestion pipeline
+	ingestionPipeline(ingestionPipeline),
+	
+	// Set metrics to metrics
+	metrics(metrics),
+	
+	// Set number of successful probes to zero
+	numberOfSuccessfulProbes(0),
+	
+	// Set number of failed probes to zero
+	numberOfFailedProbes(0),
+	
+	// Set started to false
+	started(false),
+	
+	// Set stopping to false
+	stopping(false)
+{
+}
+
+// Destructor
+NetworkCrawler::~NetworkCrawler() {
+
+	// Stop
+	stop();
+}
+
+// Stop
+void NetworkCrawler::stop() {
+
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Set stopping to true
+		stopping.store(true);
+	}
+	
+	// Notify workers
+	condition.notify_all();
+	
+	// Go through all workers
+	for(thread &worker : workers) {
+	
+		// Check if worker is running
+		if(worker.joinable()) {
+		
+			// Wait for worker to finish
+			worker.join();
+		}
+	}
+}
+
+// Start
+void NetworkCrawler::start(const array<uint8_t, 32> &genesisBlockHash, const size_t concurrency) {
+
+	// Set genesis block hash
+	this->genesisBlockHash = genesisBlockHash;
+	
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Set started to true
+		started = true;
+	}
+	
+	// Go through all workers
+	for(size_t i = 0; i < concurrency; ++i) {
+	
+		// Create worker
+		workers.emplace_back(&NetworkCrawler::run, this);
+	}
+}
+
+// Add address
+void NetworkCrawler::addAddress(const string &address) {
+
+	// Lock
+	lock_guard guard(lock);
+	
+	// Check if started
+	if(started) {
+	
+		// Queue address
+		queueAddress(address, false);
+	}
+}
+
+// Add seed
+void NetworkCrawler::addSeed(const string &address) {
+
+	// Lock
+	lock_guard guard(lock);
+	
+	// Check if started
+	if(started) {
+	
+		// Check if loopback seeds are allowed
+		#ifdef CRAWLER_LOOPBACK_SEEDS
+		
+			// Queue address and allow it to be loopback so that stand-in peers on loopback can be crawled
+			queueAddress(address, true);
+			
+		// Otherwise
+		#else
+		
+			// Queue address
+			queueAddress(address, false);
+		#endif
+	}
+}
+
+// Get number of known addresses
+size_t NetworkCrawler::getNumberOfKnownAddresses() {
+
+	// Lock
+	lock_guard guard(lock);
+	
+	// Return number of known addresses
+	return knownAddresses.size();
+}
+
+// Get number of successful probes
+uint64_t NetworkCrawler::getNumberOfSuccessfulProbes() const {
+
+	// Return number of successful probes
+	return numberOfSuccessfulProbes.load(memory_order_relaxed);
+}
+
+// Get number of failed probes
+uint64_t NetworkCrawler::getNumberOfFailedProbes() const {
+
+	// Return number of failed probes
+	return numberOfFailedProbes.load(memory_order_relaxed);
+}
+
+// Parse address
+bool NetworkCrawler::parseAddress(const string &address, sockaddr_storage &socketAddress, socklen_t &socketAddressLength) {
+
+	// Check if address doesn't have a port
+	const size_t portSeparator = address.rfind(':');
+	if(portSeparator == string::npos) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if parsing port failed
+	char *end;
+	const unsigned long port = strtoul(&address[portSeparator + sizeof(':')], &end, 10);
+	if(*end || !port || port > UINT16_MAX) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if address is an IPv6 address
+	socketAddress = {};
+	if(address.starts_with('[') && portSeparator && address[portSeparator - sizeof(']')] == ']') {
+	
+		// Check if parsing the IPv6 address failed
+		sockaddr_in6 &ipv6SocketAddress = reinterpret_cast<sockaddr_in6 &>(socketAddress);
+		if(inet_pton(AF_INET6, address.substr(sizeof('['), portSeparator - sizeof('[') - sizeof(']')).c_str(), &ipv6SocketAddress.sin6_addr) != 1) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set IPv6 socket address's family and port
+		ipv6SocketAddress.sin6_family = AF_INET6;
+		ipv6SocketAddress.sin6_port = htons(port);
+		socketAddressLength = sizeof(ipv6SocketAddress);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Check if parsing the IPv4 address failed
+		sockaddr_in &ipv4SocketAddress = reinterpret_cast<sockaddr_in &>(socketAddress);
+		if(inet_pton(AF_INET, address.substr(0, portSeparator).c_str(), &ipv4SocketAddress.sin_addr) != 1) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set IPv4 socket address's family and port
+		ipv4SocketAddress.sin_family = AF_INET;
+		ipv4SocketAddress.sin_port = htons(port);
+		socketAddressLength = sizeof(ipv4SocketAddress);
+	}
+	
+	// Return true
+	return true;
+}
+
+// Is globally routable
+bool NetworkCrawler::isGloballyRoutable(const sockaddr_storage &socketAddress) {
+
+	// Check if address is an IPv6 address
+	uint32_t ipv4Address;
+	if(socketAddress.ss_family == AF_INET6) {
+	
+		// Check if address isn't an IPv4-mapped IPv6 address
+		const in6_addr &ipv6Address = reinterpret_cast<const sockaddr_in6 &>(socketAddress).sin6_addr;
+		if(!IN6_IS_ADDR_V4MAPPED(&ipv6Address)) {
+		
+			// Return if address isn't unspecified, loopback, IPv4-compatible, link local, site local, unique local, multicast, or documentation
+			return !IN6_IS_ADDR_UNSPECIFIED(&ipv6Address) && !IN6_IS_ADDR_LOOPBACK(&ipv6Address) && !IN6_IS_ADDR_V4COMPAT(&ipv6Address) && !IN6_IS_ADDR_LINKLOCAL(&ipv6Address) && !IN6_IS_ADDR_SITELOCAL(&ipv6Address) && (ipv6Address.s6_addr[0] & 0xFE) != 0xFC && !IN6_IS_ADDR_MULTICAST(&ipv6Address) && !(ipv6Address.s6_addr[0] == 0x20 && ipv6Address.s6_addr[1] == 0x01 && ipv6Address.s6_addr[2] == 0x0D && ipv6Address.s6_addr[3] == 0xB8);
+		}
+		
+		// Get mapped IPv4 address
+		memcpy(&ipv4Address, &ipv6Address.s6_addr[sizeof(ipv6Address.s6_addr) - sizeof(ipv4Address)], sizeof(ipv4Address));
+	}
+	
+	// Otherwise
+	else {
+	
+		// Get IPv4 address
+		ipv4Address = reinterpret_cast<const sockaddr_in &>(socketAddress).sin_addr.s_addr;
+	}
+	
+	// Go through all non-globally routable IPv4 networks
+	ipv4Address = ntohl(ipv4Address);
+	for(const pair<uint32_t, uint8_t> &network : NON_GLOBALLY_ROUTABLE_IPV4_NETWORKS) {
+	
+		// Check if IPv4 address is in the network
+		if((ipv4Address ^ network.first) >> (32 - network.second) == 0) {
+		
+			// Return false
+			return false;
+		}
+	}
+	
+	// Return true
+	return true;
+}
+
+// Is loopback
+bool NetworkCrawler::isLoopback(const sockaddr_storage &socketAddress) {
+
+	// Check if address is an IPv6 address
+	if(socketAddress.ss_family == AF_INET6) {
+	
+		// Return if address is loopback or an IPv4-mapped loopback address
+		const in6_addr &ipv6Address = reinterpret_cast<const sockaddr_in6 &>(socketAddress).sin6_addr;
+		return IN6_IS_ADDR_LOOPBACK(&ipv6Address) || (IN6_IS_ADDR_V4MAPPED(&ipv6Address) && ipv6Address.s6_addr[sizeof(ipv6Address.s6_addr) - sizeof(uint32_t)] == IN_LOOPBACKNET);
+	}
+	
+	// Return if address is loopback
+	return (ntohl(reinterpret_cast<const sockaddr_in &>(socketAddress).sin_addr.s_addr) >> IN_CLASSA_NSHIFT) == IN_LOOPBACKNET;
+}
+
+// Queue address
+void NetworkCrawler::queueAddress(const string &address, const bool allowLoopback) {
+
+	// Check if parsing the address failed, which includes onion addresses since the crawler doesn't use Tor, or the address isn't globally routable and isn't an allowed loopback address so that peers can't make the crawler connect to services on private networks
+	sockaddr_storage socketAddress;
+	socklen_t socketAddressLength;
+	if(!parseAddress(address, socketAddress, socketAddressLength) || (!isGloballyRoutable(socketAddress) && !(allowLoopback && isLoopback(socketAddress)))) {
+	
+		// Return
+		return;
+	}
+	
+	// Check if there's too many known addresses or the address is already known
+	if(knownAddresses.size() >= MAX_NUMBER_OF_KNOWN_ADDRESSES || !knownAddresses.emplace(address, AddressState{
+	
+		// Number of consecutive failures
+		.numberOfConsecutiveFailures = 0
+		
+	}).second) {
+	
+		// Return
+		return;
+	}
+	
+	// Add address to the end of the frontier so that addresses are probed breadth first
+	frontier.push_back(address);
+	
+	// Notify a worker
+	condition.notify_one();
+}
+
+// Run
+void NetworkCrawler::run() {
+
+	// Loop forever
+	unique_lock guard(lock);
+	while(true) {
+	
+		// Loop while the frontier is empty and not stopping
+		while(frontier.empty() && !stopping.load()) {
+		
+			// Check if a scheduled probe is due
+			if(!scheduledProbes.empty() && scheduledProbes.top().first <= chrono::steady_clock::now()) {
+			
+				// Move scheduled probe to the frontier
+				frontier.push_back(scheduledProbes.top().second);
+				scheduledProbes.pop();
+			}
+			
+			// Otherwise check if a probe is scheduled
+			else if(!scheduledProbes.empty()) {
+			
+				// Wait until the scheduled probe is due or notified
+				const chrono::steady_clock::time_point due = scheduledProbes.top().first;
+				condition.wait_until(guard, due);
+			}
+			
+			// Otherwise
+			else {
+			
+				// Wait until notified
+				condition.wait(guard);
+			}
+		}
+		
+		// Check if stopping
+		if(stopping.load()) {
+		
+			// Break
+			break;
+		}
+		
+		// Get address from the start of the frontier
+		const string address = move(frontier.front());
+		frontier.pop_front();
+		
+		// Unlock while probing
+		guard.unlock();
+		
+		// Probe address
+		vector<string> peerAddresses;
+		const bool probeSuccessful = probe(address, peerAddresses);
+		
+		// Check if loopback seeds are allowed
+		#ifdef CRAWLER_LOOPBACK_SEEDS
+		
+			// Get if the address is loopback since only stand-in peers on loopback can advertise loopback addresses
+			sockaddr_storage socketAddress;
+			socklen_t socketAddressLength;
+			const bool allowLoopback = parseAddress(address, socketAddress, socketAddressLength) && isLoopback(socketAddress);
+			
+		// Otherwise
+		#else
+		
+			// Don't allow loopback addresses
+			const bool allowLoopback = false;
+		#endif
+		
+		// Lock
+		guard.lock();
+		
+		// Go through all of the peer addresses that the address advertised
+		for(const string &peerAddress : peerAddresses) {
+		
+			// Queue peer address
+			queueAddress(peerAddress, allowLoopback);
+		}
+		
+		// Check if address is no longer known
+		unordered_map<string, AddressState>::iterator addressState = knownAddresses.find(address);
+		if(addressState == knownAddresses.end()) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if probe was successful
+		if(probeSuccessful) {
+		
+			// Increment number of successful probes
+			numberOfSuccessfulProbes.fetch_add(1, memory_order_relaxed);
+			
+			// Reset address's number of consecutive failures and schedule it to be probed again
+			addressState->second.numberOfConsecutiveFailures = 0;
+			scheduledProbes.emplace(chrono::steady_clock::now() + REPROBE_INTERVAL, address);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Increment number of failed probes
+			numberOfFailedProbes.fetch_add(1, memory_order_relaxed);
+			
+			// Check if address failed too many times in a row
+			if(++addressState->second.numberOfConsecutiveFailures >= MAX_NUMBER_OF_CONSECUTIVE_FAILURES) {
+			
+				// Forget address so that it can be learned again later
+				knownAddresses.erase(addressState);
+			}
+			
+			// Otherwise
+			else {
+			
+				// Schedule address to be probed again after a backoff that doubles with each consecutive failure
+				scheduledProbes.emplace(chrono::steady_clock::now() + min<chrono::steady_clock::duration>(INITIAL_BACKOFF * (1 << (addressState->second.numberOfConsecutiveFailures - 1)), MAX_BACKOFF), address);
+			}
+		}
+		
+		// Notify a worker since the next scheduled probe may have changed
+		condition.notify_one();
+	}
+}
+
+// Probe
+bool NetworkCrawler::probe(const string &address, vector<string> &peerAddresses) {
+
+	// Check if connecting to the address failed
+	const chrono::steady_clock::time_point connectStartTime = chrono::steady_clock::now();
+	const int socket = connect(address);
+	if(socket == -1) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Observe connect duration
+	metrics.crawlerConnectDuration.observe(chrono::steady_clock::now() - connectStartTime);
+	
+	// Automatically close socket when done
+	const unique_ptr<const int, void(*)(const int *)> socketUniquePointer(&socket, [](const int *socket) {
+	
+		// Close socket
+		close(*socket);
+	});
+	
+	// Check if sending hand message failed
+	const vector<uint8_t> handMessage = PeerProtocol::createHandMessage(address, mt19937_64(random_device()())(), genesisBlockHash);
+	const chrono::steady_clock::time_point handshakeStartTime = chrono::steady_clock::now();
+	const chrono::steady_clock::time_point deadline = handshakeStartTime + PROBE_TIMEOUT;
+	if(!send(socket, handMessage, deadline)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if receiving shake message failed
+	vector<uint8_t> payload;
+	if(!receiveMessage(socket, PeerProtocol::MessageType::SHAKE, payload, deadline)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Get handshake's round trip time
+	const chrono::steady_clock::time_point handshakeEndTime = chrono::steady_clock::now();
+	const chrono::steady_clock::duration handshakeDuration = handshakeEndTime - handshakeStartTime;
+	
+	// Check if parsing shake failed or the peer is on a different network
+	const optional<PeerProtocol::Handshake> shake = PeerProtocol::parseHandshake(PeerProtocol::MessageType::SHAKE, payload);
+	if(!shake.has_value() || shake.value().genesisBlockHash != genesisBlockHash) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Observe handshake and peer info durations
+	metrics.crawlerHandshakeDuration.observe(handshakeDuration);
+	metrics.crawlerPeerInfoDuration.observe(handshakeEndTime - connectStartTime);
+	
+	// Add peer to the ingestion pipeline with the handshake's round trip time as its latency without letting it be zero since that means it wasn't measured
+	ingestionPipeline.addPeer(address, shake.value().capabilities, shake.value().userAgent, shake.value().protocolVersion, shake.value().baseFee, shake.value().totalDifficulty, false, max(chrono::duration_cast<chrono::microseconds>(handshakeDuration), chrono::microseconds(1)));
+	
+	// Check if requesting and receiving peer addresses was successful
+	if(send(socket, PeerProtocol::createGetPeerAddressesMessage(), deadline) && receiveMessage(socket, PeerProtocol::MessageType::PEER_ADDRESSES, payload, deadline)) {
+	
+		// Check if parsing peer addresses was successful
+		optional<vector<string>> parsedPeerAddresses = PeerProtocol::parsePeerAddresses(payload);
+		if(parsedPeerAddresses.has_value()) {
+		
+			// Set peer addresses
+			peerAddresses = move(parsedPeerAddresses.value());
+		}
+	}
+	
+	// Return true
+	return true;
+}
+
+// Connect
+int NetworkCrawler::connect(const string &address) const {
+
+	// Check if parsing the address failed
+	sockaddr_storage socketAddress;
+	socklen_t socketAddressLength;
+	if(!parseAddress(address, socketAddress, socketAddressLength)) {
+	
+		// Return error
+		return -1;
+	}
+	
+	// Check if creating non-blocking socket failed
+	const int socket = ::socket(socketAddress.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(socket == -1) {
+	
+		// Return error
+		return -1;
+	}
+	
+	// Check if connecting failed
+	if(::connect(socket, reinterpret_cast<const sockaddr *>(&socketAddress), socketAddressLength) && errno != EINPROGRESS) {
+	
+		// Close socket
+		close(socket);
+		
+		// Return error
+		return -1;
+	}
+	
+	// Loop until connected or the connect timeout has elapsed
+	const chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + CONNECT_TIMEOUT;
+	while(true) {
+	
+		// Check if stopping or the connect timeout has elapsed
+		if(stopping.load() || chrono::steady_clock::now() >= deadline) {
+		
+			// Close socket
+			close(socket);
+			
+			// Return error
+			return -1;
+		}
+		
+		// Check if socket is connected
+		pollfd pollInfo = {socket, POLLOUT, 0};
+		const int pollResult = poll(&pollInfo, 1, POLL_INTERVAL.count());
+		if(pollResult > 0) {
+		
+			// Break
+			break;
+		}
+		
+		// Otherwise check if polling failed
+		else if(pollResult == -1 && errno != EINTR) {
+		
+			// Close socket
+			close(socket);
+			
+			// Return error
+			return -1;
+		}
+	}
+	
+	// Check if connecting failed
+	int error;
+	socklen_t errorLength = sizeof(error);
+	if(getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &errorLength) || error) {
+	
+		// Close socket
+		close(socket);
+		
+		// Return error
+		return -1;
+	}
+	
+	// Return socket
+	return socket;
+}
+
+// Send
+bool NetworkCrawler::send(const int socket, const vector<uint8_t> &data, const chrono::steady_clock::time_point deadline) const {
+
+	// Loop until all data is sent
+	size_t offset = 0;
+	while(offset != data.size()) {
+	
+		// Check if stopping or the deadline has elapsed
+		if(stopping.load() || chrono::steady_clock::now() >= deadline) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Check if socket can be written to
+		pollfd pollInfo = {socket, POLLOUT, 0};
+		const int pollResult = poll(&pollInfo, 1, POLL_INTERVAL.count());
+		if(pollResult > 0) {
+		
+			// Check if sending data failed
+			const ssize_t numberOfBytesSent = ::send(socket, &data[offset], data.size() - offset, MSG_NOSIGNAL);
+			if(numberOfBytesSent == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Check if data was sent
+			if(numberOfBytesSent > 0) {
+			
+				// Update offset
+				offset += numberOfBytesSent;
+			}
+		}
+		
+		// Otherwise check if polling failed
+		else if(pollResult == -1 && errno != EINTR) {
+		
+			// Return false
+			return false;
+		}
+	}
+	
+	// Return true
+	return true;
+}
+
+// Receive
+bool NetworkCrawler::receive(const int socket, uint8_t *data, const size_t length, const chrono::steady_clock::time_point deadline) const {
+
+	// Loop until all data is received
+	size_t offset = 0;
+	while(offset != length) {
+	
+		// Check if stopping or the deadline has elapsed
+		if(stopping.load() || chrono::steady_clock::now() >= deadline) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Check if socket can be read from
+		pollfd pollInfo = {socket, POLLIN, 0};
+		const int pollResult = poll(&pollInfo, 1, POLL_INTERVAL.count());
+		if(pollResult > 0) {
+		
+			// Check if receiving data failed or the connection was closed
+			const ssize_t numberOfBytesReceived = recv(socket, &data[offset], length - offset, 0);
+			if(!numberOfBytesReceived || (numberOfBytesReceived == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Check if data was received
+			if(numberOfBytesReceived > 0) {
+			
+				// Update offset
+				offset += numberOfBytesReceived;
+			}
+		}
+		
+		// Otherwise check if polling failed
+		else if(pollResult == -1 && errno != EINTR) {
+		
+			// Return false
+			return false;
+		}
+	}
+	
+	// Return true
+	return true;
+}
+
+// Receive message
+bool NetworkCrawler::receiveMessage(const int socket, const PeerProtocol::MessageType type, vector<uint8_t> &payload, const chrono::steady_clock::time_point deadline) const {
+
+	// Go through all received messages until one with the type is received
+	for(size_t i = 0; i <= MAX_NUMBER_OF_IGNORED_MESSAGES; ++i) {
+	
+		// Check if receiving message header failed
+		uint8_t messageHeaderData[PeerProtocol::MESSAGE_HEADER_SIZE];
+		if(!receive(socket, messageHeaderData, sizeof(messageHeaderData), deadline)) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Check if parsing message header failed
+		const optional<PeerProtocol::MessageHeader> messageHeader = PeerProtocol::parseMessageHeader(messageHeaderData);
+		if(!messageHeader.has_value()) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Check if receiving message's payload failed
+		payload.resize(messageHeader.value().length);
+		if(!receive(socket, payload.data(), payload.size(), deadline)) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Check if message has the type
+		if(messageHeader.value().type == type) {
+		
+			// Return true
+			return true;
+		}
+	}
+	
+	// Return false
+	return false;
+}
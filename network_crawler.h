@@ -0,0 +1,180 @@
+// Header guard
+#ifndef NETWORK_CRAWLER_H
+#define NETWORK_CRAWLER_H
+
+
+// Header files
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include "./ingestion_pipeline.h"
+#include "./metrics.h"
+#include <mutex>
+#include <optional>
+#include "./peer_protocol.h"
+#include <queue>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Network crawler class (actively probes known peer addresses breadth first and learns new ones from the peers that it probes)
+class NetworkCrawler final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit NetworkCrawler(IngestionPipeline &ingestionPipeline, Metrics &metrics);
+		
+		// Destructor
+		~NetworkCrawler();
+		
+		// Start
+		void start(const array<uint8_t, 32> &genesisBlockHash, const size_t concurrency);
+		
+		// Stop
+		void stop();
+		
+		// Add address
+		void addAddress(const string &address);
+		
+		// Add seed (an address that the crawler was explicitly told to start from)
+		void addSeed(const string &address);
+		
+		// Get number of known addresses
+		size_t getNumberOfKnownAddresses();
+		
+		// Get number of successful probes
+		uint64_t getNumberOfSuccessfulProbes() const;
+		
+		// Get number of failed probes
+		uint64_t getNumberOfFailedProbes() const;
+		
+	// Private
+	private:
+	
+		// Address state structure
+		struct AddressState {
+		
+			// Number of consecutive failures
+			uint32_t numberOfConsecutiveFailures;
+		};
+		
+		// Scheduled probe type
+		typedef pair<chrono::steady_clock::time_point, string> ScheduledProbe;
+		
+		// Max number of known addresses
+		static const size_t MAX_NUMBER_OF_KNOWN_ADDRESSES = 100000;
+		
+		// Max number of consecutive failures
+		static const uint32_t MAX_NUMBER_OF_CONSECUTIVE_FAILURES = 8;
+		
+		// Reprobe interval
+		static constexpr const chrono::hours REPROBE_INTERVAL = 1h;
+		
+		// Initial backoff
+		static constexpr const chrono::minutes INITIAL_BACKOFF = 1min;
+		
+		// Max backoff
+		static constexpr const chrono::hours MAX_BACKOFF = 6h;
+		
+		// Connect timeout
+		static constexpr const chrono::seconds CONNECT_TIMEOUT = 5s;
+		
+		// Probe timeout
+		static constexpr const chrono::seconds PROBE_TIMEOUT = 15s;
+		
+		// Poll interval
+		static constexpr const chrono::milliseconds POLL_INTERVAL = 250ms;
+		
+		// Max number of ignored messages
+		static const size_t MAX_NUMBER_OF_IGNORED_MESSAGES = 16;
+		
+		// Non-globally routable IPv4 networks and their prefix lengths (this network, private, shared, loopback, link local, private, protocol assignments, documentation, private, benchmarking, documentation, documentation, and multicast, reserved, and broadcast)
+		static constexpr const array<pair<uint32_t, uint8_t>, 13> NON_GLOBALLY_ROUTABLE_IPV4_NETWORKS = {{
+			{0x00000000, 8}, {0x0A000000, 8}, {0x64400000, 10}, {0x7F000000, 8}, {0xA9FE0000, 16}, {0xAC100000, 12}, {0xC0000000, 24}, {0xC0000200, 24}, {0xC0A80000, 16}, {0xC6120000, 15}, {0xC6336400, 24}, {0xCB007100, 24}, {0xE0000000, 3}
+		}};
+		
+		// Parse address
+		static bool parseAddress(const string &address, sockaddr_storage &socketAddress, socklen_t &socketAddressLength);
+		
+		// Is globally routable
+		static bool isGloballyRoutable(const sockaddr_storage &socketAddress);
+		
+		// Is loopback
+		static bool isLoopback(const sockaddr_storage &socketAddress);
+		
+		// Queue address
+		void queueAddress(const string &address, const bool allowLoopback);
+		
+		// Run
+		void run();
+		
+		// Probe
+		bool probe(const string &address, vector<string> &peerAddresses);
+		
+		// Connect
+		int connect(const string &address) const;
+		
+		// Send
+		bool send(const int socket, const vector<uint8_t> &data, const chrono::steady_clock::time_point deadline) const;
+		
+		// Receive
+		bool receive(const int socket, uint8_t *data, const size_t length, const chrono::steady_clock::time_point deadline) const;
+		
+		// Receive message
+		bool receiveMessage(const int socket, const PeerProtocol::MessageType type, vector<uint8_t> &payload, const chrono::steady_clock::time_point deadline) const;
+		
+		// Ingestion pipeline
+		IngestionPipeline &ingestionPipeline;
+		
+		// Metrics
+		Metrics &metrics;
+		
+		// Genesis block hash
+		array<uint8_t, 32> genesisBlockHash;
+		
+		// Known addresses
+		unordered_map<string, AddressState> knownAddresses;
+		
+		// Frontier
+		deque<string> frontier;
+		
+		// Scheduled probes
+		priority_queue<ScheduledProbe, vector<ScheduledProbe>, greater<ScheduledProbe>> scheduledProbes;
+		
+		// Number of successful probes
+		atomic<uint64_t> numberOfSuccessfulProbes;
+		
+		// Number of failed probes
+		atomic<uint64_t> numberOfFailedProbes;
+		
+		// Lock
+		mutex lock;
+		
+		// Condition
+		condition_variable condition;
+		
+		// Started
+		bool started;
+		
+		// Stopping
+		atomic<bool> stopping;
+		
+		// Workers
+		vector<thread> workers;
+};
+
+
+#endif
@@ -0,0 +1,359 @@
+// Header files
+#include <algorithm>
+#include "./peer_aggregates.h"
+#include "./peer_registry.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Add peer
+void PeerAggregates::addPeer(const string &peerIdentifier, const uint16_t userAgentId, const Geolocation &geolocation, const chrono::microseconds latency) {
+
+	// Check if peer is a Tor peer
+	if(peerIdentifier.ends_with(".onion")) {
+	
+		// Increment number of Tor peers
+		++numberOfTorPeers;
+	}
+	
+	// Check if peer has a country
+	if(!geolocation.country.empty()) {
+	
+		// Increment country's count
+		++countries[geolocation.country];
+	}
+	
+	// Check if peer has a continent and its latency was measured
+	if(!geolocation.continent.empty() && latency != chrono::microseconds::zero()) {
+	
+		// Increment the count of the continent's latency histogram bucket that the latency is in
+		++continentLatencies[geolocation.continent][getLatencyHistogramBucket(latency)];
+	}
+	
+	// Check if peer is located
+	if(isLocated(geolocation)) {
+	
+		// Increment number of located peers
+		++numberOfLocatedPeers;
+		
+		// Check if location cell doesn't exist
+		LocationCell &locationCell = locationCells[getKey(geolocation.longitude, geolocation.latitude, 1 / FIXED_POINT_SCALE)];
+		if(locationCell.peers.empty()) {
+		
+			// Set location cell's longitude, latitude, and location
+			locationCell.longitude = geolocation.longitude;
+			locationCell.latitude = geolocation.latitude;
+			locationCell.location.clear();
+			for(const string *locationField : {&geolocation.continent, &geolocation.country, &geolocation.subdivision, &geolocation.city}) {
+			
+				// Check if location field exists
+				if(!locationField->empty()) {
+				
+					// Append location field to the location
+					locationCell.location.append(locationCell.location.empty() ? "" : ", ").append(*locationField);
+				}
+			}
+		}
+		
+		// Add peer to the location cell
+		locationCell.peers[peerIdentifier] = {
+		
+			// User agent ID
+			.userAgentId = userAgentId,
+			
+			// Latency
+			.latency = latency
+		};
+		
+		// Go through all grid resolutions
+		for(size_t i = 0; i < GRID_RESOLUTIONS.size(); ++i) {
+		
+			// Add peer to the grid cell
+			updateCell(gridCells[i], geolocation, latency, GRID_RESOLUTIONS[i], true);
+		}
+	}
+}
+
+// Remove peer
+void PeerAggregates::removePeer(const string &peerIdentifier, const Geolocation &geolocation, const chrono::microseconds latency) {
+
+	// Check if peer is a Tor peer
+	if(peerIdentifier.ends_with(".onion")) {
+	
+		// Decrement number of Tor peers
+		--numberOfTorPeers;
+	}
+	
+	// Check if peer has a country
+	if(!geolocation.country.empty()) {
+	
+		// Check if country doesn't have any other peers
+		unordered_map<string, uint64_t>::iterator country = countries.find(geolocation.country);
+		if(!--country->second) {
+		
+			// Remove country
+			countries.erase(country);
+		}
+	}
+	
+	// Check if peer has a continent and its latency was measured
+	if(!geolocation.continent.empty() && latency != chrono::microseconds::zero()) {
+	
+		// Check if continent doesn't have any other measured peers
+		unordered_map<string, LatencyBuckets>::iterator continentLatency = continentLatencies.find(geolocation.continent);
+		--continentLatency->second[getLatencyHistogramBucket(latency)];
+		if(all_of(continentLatency->second.cbegin(), continentLatency->second.cend(), [](const uint64_t count) -> bool {
+		
+			// Return if count is zero
+			return !count;
+		})) {
+		
+			// Remove continent's latencies
+			continentLatencies.erase(continentLatency);
+		}
+	}
+	
+	// Check if peer is located
+	if(isLocated(geolocation)) {
+	
+		// Decrement number of located peers
+		--numberOfLocatedPeers;
+		
+		// Remove peer from the location cell
+		unordered_map<uint64_t, LocationCell>::iterator locationCell = locationCells.find(getKey(geolocation.longitude, geolocation.latitude, 1 / FIXED_POINT_SCALE));
+		locationCell->second.peers.erase(peerIdentifier);
+		
+		// Check if location cell doesn't have any other peers
+		if(locationCell->second.peers.empty()) {
+		
+			// Remove location cell
+			locationCells.erase(locationCell);
+		}
+		
+		// Go through all grid resolutions
+		for(size_t i = 0; i < GRID_RESOLUTIONS.size(); ++i) {
+		
+			// Remove peer from the grid cell
+			updateCell(gridCells[i], geolocation, latency, GRID_RESOLUTIONS[i], false);
+		}
+	}
+}
+
+// Clear
+void PeerAggregates::clear() {
+
+	// Reset aggregates
+	*this = PeerAggregates();
+}
+
+// Serialize
+void PeerAggregates::serialize(JsonSerializer &serializer, const UserAgentTable &userAgentTable) const {
+
+	// Number of located peers
+	serializer.appendRaw("{\"located_peers\":");
+	serializer.appendQuotedUnsignedInteger(numberOfLocatedPeers);
+	
+	// Number of Tor peers
+	serializer.appendRaw(",\"tor_peers\":");
+	serializer.appendQuotedUnsignedInteger(numberOfTorPeers);
+	
+	// Countries
+	serializer.appendRaw(",\"countries\":[");
+	bool firstCountry = true;
+	for(const pair<const string, uint64_t> &country : countries) {
+	
+		// Append country
+		serializer.appendRaw(firstCountry ? "{\"country\":" : ",{\"country\":");
+		serializer.appendString(country.first);
+		serializer.appendRaw(",\"count\":");
+		serializer.appendQuotedUnsignedInteger(country.second);
+		serializer.appendRaw('}');
+		
+		// Set first country to false
+		firstCountry = false;
+	}
+	
+	// Continent latencies
+	serializer.appendRaw("],\"continent_latencies\":[");
+	bool firstContinentLatency = true;
+	for(const pair<const string, LatencyBuckets> &continentLatency : continentLatencies) {
+	
+		// Append continent
+		serializer.appendRaw(firstContinentLatency ? "{\"continent\":" : ",{\"continent\":");
+		serializer.appendString(continentLatency.first);
+		serializer.appendRaw(",\"latencies\":[");
+		
+		// Go through all of the continent's latency histogram buckets
+		for(size_t i = 0; i < continentLatency.second.size(); ++i) {
+		
+			// Append bucket's upper bound in seconds or null if it doesn't have one and its count
+			serializer.appendRaw(i ? ",{\"max\":" : "{\"max\":");
+			serializer.appendQuotedFixedPointOrNull((i < LATENCY_HISTOGRAM_BOUNDS.size()) ? chrono::duration<double>(LATENCY_HISTOGRAM_BOUNDS[i]).count() : NAN);
+			serializer.appendRaw(",\"count\":");
+			serializer.appendQuotedUnsignedInteger(continentLatency.second[i]);
+			serializer.appendRaw('}');
+		}
+		
+		// Append end of continent
+		serializer.appendRaw("]}");
+		
+		// Set first continent latency to false
+		firstContinentLatency = false;
+	}
+	
+	// Locations
+	serializer.appendRaw("],\"locations\":[");
+	bool firstLocationCell = true;
+	for(const pair<const uint64_t, LocationCell> &locationCell : locationCells) {
+	
+		// Append location cell
+		serializer.appendRaw(firstLocationCell ? "\n{\"longitude\":" : ",\n{\"longitude\":");
+		serializer.appendQuotedFixedPointOrNull(locationCell.second.longitude);
+		serializer.appendRaw(",\"latitude\":");
+		serializer.appendQuotedFixedPointOrNull(locationCell.second.latitude);
+		serializer.appendRaw(",\"location\":");
+		serializer.appendString(locationCell.second.location);
+		serializer.appendRaw(",\"peers\":[");
+		
+		// Go through all of the location cell's peers
+		bool firstPeer = true;
+		for(const pair<const string_view, LocationPeer> &peer : locationCell.second.peers) {
+		
+			// Append peer
+			serializer.appendRaw(firstPeer ? "{\"address\":" : ",{\"address\":");
+			serializer.appendString(PeerRegistry::getPublishedAddress(peer.first));
+			serializer.appendRaw(",\"user_agent\":");
+			serializer.appendString(userAgentTable.getName(peer.second.userAgentId));
+			serializer.appendRaw(",\"latency\":");
+			serializer.appendQuotedFixedPointOrNull(PeerRegistry::getLatencyInSeconds(peer.second.latency));
+			serializer.appendRaw('}');
+			
+			// Set first peer to false
+			firstPeer = false;
+		}
+		
+		// Append end of location cell
+		serializer.appendRaw("]}");
+		
+		// Set first location cell to false
+		firstLocationCell = false;
+	}
+	
+	// Grids
+	serializer.appendRaw("\n],\"grids\":[");
+	for(size_t i = 0; i < GRID_RESOLUTIONS.size(); ++i) {
+	
+		// Append grid
+		serializer.appendRaw(i ? ",\n{\"resolution\":" : "\n{\"resolution\":");
+		serializer.appendQuotedFixedPointOrNull(GRID_RESOLUTIONS[i]);
+		serializer.appendRaw(",\"cells\":");
+		serializeCells(serializer, gridCells[i]);
+		serializer.appendRaw('}');
+	}
+	
+	// Append end of aggregates
+	serializer.appendRaw("\n]}");
+}
+
+// Is located
+bool PeerAggregates::isLocated(const Geolocation &geolocation) {
+
+	// Return if geolocation has a longitude and latitude
+	return isfinite(geolocation.longitude) && isfinite(geolocation.latitude);
+}
+
+// Get key
+uint64_t PeerAggregates::getKey(const double longitude, const double latitude, const double resolution) {
+
+	// Return the longitude and latitude rounded to the resolution packed into a key
+	return (static_cast<uint64_t>(static_cast<uint32_t>(static_cast<int32_t>(lround(longitude / resolution)))) << 32) | static_cast<uint32_t>(static_cast<int32_t>(lround(latitude / resolution)));
+}
+
+// Update cell
+void PeerAggregates::updateCell(unordered_map<uint64_t, Cell> &cells, const Geolocation &geolocation, const chrono::microseconds latency, const double resolution, const bool add) {
+
+	// Check if adding to the cell
+	const uint64_t key = getKey(geolocation.longitude, geolocation.latitude, resolution);
+	if(add) {
+	
+		// Add location to the cell
+		Cell &cell = cells[key];
+		++cell.count;
+		cell.longitudeSum += geolocation.longitude;
+		cell.latitudeSum += geolocation.latitude;
+		
+		// Check if latency was measured
+		if(latency != chrono::microseconds::zero()) {
+		
+			// Add latency to the cell
+			++cell.numberOfMeasuredPeers;
+			cell.latencySum += latency.count();
+		}
+	}
+	
+	// Otherwise
+	else {
+	
+		// Check if cell doesn't have any other locations
+		unordered_map<uint64_t, Cell>::iterator cell = cells.find(key);
+		if(!--cell->second.count) {
+		
+			// Remove cell
+			cells.erase(cell);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Remove location from the cell
+			cell->second.longitudeSum -= geolocation.longitude;
+			cell->second.latitudeSum -= geolocation.latitude;
+			
+			// Check if latency was measured
+			if(latency != chrono::microseconds::zero()) {
+			
+				// Remove latency from the cell
+				--cell->second.numberOfMeasuredPeers;
+				cell->second.latencySum -= latency.count();
+			}
+		}
+	}
+}
+
+// Serialize cells
+void PeerAggregates::serializeCells(JsonSerializer &serializer, const unordered_map<uint64_t, Cell> &cells) {
+
+	// Go through all cells
+	serializer.appendRaw('[');
+	bool firstCell = true;
+	for(const pair<const uint64_t, Cell> &cell : cells) {
+	
+		// Append cell with its average location
+		serializer.appendRaw(firstCell ? "{\"longitude\":" : ",{\"longitude\":");
+		serializer.appendQuotedFixedPointOrNull(cell.second.longitudeSum / cell.second.count);
+		serializer.appendRaw(",\"latitude\":");
+		serializer.appendQuotedFixedPointOrNull(cell.second.latitudeSum / cell.second.count);
+		serializer.appendRaw(",\"count\":");
+		serializer.appendQuotedUnsignedInteger(cell.second.count);
+		
+		// Append cell's average latency or null if none of its peers' latencies were measured
+		serializer.appendRaw(",\"latency\":");
+		serializer.appendQuotedFixedPointOrNull(cell.second.numberOfMeasuredPeers ? static_cast<double>(cell.second.latencySum) / cell.second.numberOfMeasuredPeers / 1000000 : NAN);
+		serializer.appendRaw('}');
+		
+		// Set first cell to false
+		firstCell = false;
+	}
+	
+	// Append end of cells
+	serializer.appendRaw(']');
+}
+
+// Get latency histogram bucket
+size_t PeerAggregates::getLatencyHistogramBucket(const chrono::microseconds latency) {
+
+	// Return the index of the first bucket whose upper bound isn't less than the latency or the last bucket if there isn't one
+	return lower_bound(LATENCY_HISTOGRAM_BOUNDS.cbegin(), LATENCY_HISTOGRAM_BOUNDS.cend(), latency) - LATENCY_HISTOGRAM_BOUNDS.cbegin();
+}
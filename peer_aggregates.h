@@ -0,0 +1,135 @@
+// Header guard
+#ifndef PEER_AGGREGATES_H
+#define PEER_AGGREGATES_H
+
+
+// Header files
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "./geolocation.h"
+#include "./json_serializer.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "./user_agent.h"
+
+using namespace std;
+
+
+// Classes
+
+// Peer aggregates class (incrementally maintained counts that the map renders without having to go through every peer)
+class PeerAggregates final {
+
+	// Public
+	public:
+	
+		// Add peer (the latency is zero if it wasn't measured)
+		void addPeer(const string &peerIdentifier, const uint16_t userAgentId, const Geolocation &geolocation, const chrono::microseconds latency);
+		
+		// Remove peer
+		void removePeer(const string &peerIdentifier, const Geolocation &geolocation, const chrono::microseconds latency);
+		
+		// Clear
+		void clear();
+		
+		// Serialize
+		void serialize(JsonSerializer &serializer, const UserAgentTable &userAgentTable) const;
+		
+	// Private
+	private:
+	
+		// Grid resolutions in degrees (the first one matches the one degree cells that the map draws rings for)
+		static constexpr const array<double, 2> GRID_RESOLUTIONS = {1, 5};
+		
+		// Fixed point scale
+		static constexpr const double FIXED_POINT_SCALE = 1000000;
+		
+		// Latency histogram bounds (the upper bound of each continent latency histogram bucket except for the last one which has no upper bound)
+		static constexpr const array<chrono::milliseconds, 7> LATENCY_HISTOGRAM_BOUNDS = {chrono::milliseconds(25), chrono::milliseconds(50), chrono::milliseconds(100), chrono::milliseconds(200), chrono::milliseconds(400), chrono::milliseconds(800), chrono::milliseconds(1600)};
+		
+		// Latency buckets type
+		typedef array<uint64_t, LATENCY_HISTOGRAM_BOUNDS.size() + 1> LatencyBuckets;
+		
+		// Cell structure
+		struct Cell {
+		
+			// Count
+			uint64_t count = 0;
+			
+			// Longitude sum
+			double longitudeSum = 0;
+			
+			// Latitude sum
+			double latitudeSum = 0;
+			
+			// Number of measured peers (peers whose latency was measured)
+			uint64_t numberOfMeasuredPeers = 0;
+			
+			// Latency sum in microseconds
+			uint64_t latencySum = 0;
+		};
+		
+		// Location peer structure
+		struct LocationPeer {
+		
+			// User agent ID
+			uint16_t userAgentId;
+			
+			// Latency
+			chrono::microseconds latency;
+		};
+		
+		// Location cell structure
+		struct LocationCell {
+		
+			// Longitude
+			double longitude;
+			
+			// Latitude
+			double latitude;
+			
+			// Location
+			string location;
+			
+			// Peers by peer identifier (views of the peer registry's keys which stay valid until the peer is removed)
+			unordered_map<string_view, LocationPeer> peers;
+		};
+		
+		// Is located
+		static bool isLocated(const Geolocation &geolocation);
+		
+		// Get key
+		static uint64_t getKey(const double longitude, const double latitude, const double resolution);
+		
+		// Update cell
+		static void updateCell(unordered_map<uint64_t, Cell> &cells, const Geolocation &geolocation, const chrono::microseconds latency, const double resolution, const bool add);
+		
+		// Get latency histogram bucket
+		static size_t getLatencyHistogramBucket(const chrono::microseconds latency);
+		
+		// Serialize cells
+		static void serializeCells(JsonSerializer &serializer, const unordered_map<uint64_t, Cell> &cells);
+		
+		// Number of located peers
+		uint64_t numberOfLocatedPeers = 0;
+		
+		// Number of Tor peers
+		uint64_t numberOfTorPeers = 0;
+		
+		// Countries
+		unordered_map<string, uint64_t> countries;
+		
+		// Continent latencies (histograms of the measured latencies of each continent's peers)
+		unordered_map<string, LatencyBuckets> continentLatencies;
+		
+		// Location cells
+		unordered_map<uint64_t, LocationCell> locationCells;
+		
+		// Grid cells
+		array<unordered_map<uint64_t, Cell>, GRID_RESOLUTIONS.size()> gridCells;
+};
+
+
+#endif
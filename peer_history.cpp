@@ -0,0 +1,955 @@
+// Header files
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include "./file_writer.h"
+#include "./peer_history.h"
+#include <stdexcept>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+PeerHistory::PeerHistory(const char *location, const UserAgentTable &userAgentTable) :
+
+	// Set location to location
+	location(location),
+	
+	// Set user agent table to user agent table
+	userAgentTable(userAgentTable),
+	
+	// Set number of new peers to zero
+	numberOfNewPeers(0),
+	
+	// Set changed to false
+	changed(false)
+{
+}
+
+// Load
+void PeerHistory::load() {
+
+	// Check if file doesn't exist
+	if(!filesystem::exists(location)) {
+	
+		// Return
+		return;
+	}
+	
+	// Check if opening file failed
+	ifstream file(location, ios::binary);
+	if(!file) {
+	
+		// Throw exception
+		throw runtime_error("Opening peer history failed");
+	}
+	
+	// Check if reading file failed
+	const string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	if(file.bad()) {
+	
+		// Throw exception
+		throw runtime_error("Reading peer history failed");
+	}
+	
+	// Check if file's header is invalid
+	const uint8_t *current = reinterpret_cast<const uint8_t *>(contents.data());
+	const uint8_t *end = current + contents.size();
+	if(contents.size() < sizeof(MAGIC) - sizeof('\0') + sizeof(VERSION) || memcmp(current, MAGIC, sizeof(MAGIC) - sizeof('\0')) || current[sizeof(MAGIC) - sizeof('\0')] != VERSION) {
+	
+		// Throw exception
+		throw runtime_error("Peer history is invalid");
+	}
+	current += sizeof(MAGIC) - sizeof('\0') + sizeof(VERSION);
+	
+	// Check if reading number of strings failed
+	uint64_t numberOfStrings;
+	if(!BinarySerializer::readVarint(current, end, numberOfStrings) || numberOfStrings > static_cast<uint64_t>(end - current)) {
+	
+		// Throw exception
+		throw runtime_error("Peer history is invalid");
+	}
+	
+	// Go through all strings
+	string value;
+	for(uint64_t i = 0; i < numberOfStrings; ++i) {
+	
+		// Check if reading string failed or it's a duplicate
+		if(!BinarySerializer::readString(current, end, value) || !stringIds.emplace(value, i).second) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		
+		// Append string to the strings
+		strings.push_back(move(value));
+	}
+	
+	// Check if reading number of peers failed
+	uint64_t numberOfPeers;
+	if(!BinarySerializer::readVarint(current, end, numberOfPeers) || numberOfPeers > static_cast<uint64_t>(end - current)) {
+	
+		// Throw exception
+		throw runtime_error("Peer history is invalid");
+	}
+	
+	// Go through all peers
+	for(uint64_t i = 0; i < numberOfPeers; ++i) {
+	
+		// Check if reading peer's identifier failed
+		if(!BinarySerializer::readString(current, end, value)) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		
+		// Check if peer isn't in any period
+		if(value.empty()) {
+		
+			// Append empty peer identifier and attributes
+			peerIdentifiers.emplace_back();
+			latestAttributes.emplace_back();
+		}
+		
+		// Otherwise
+		else {
+		
+			// Check if reading peer's attributes failed or it's a duplicate
+			Attributes attributes;
+			const pair<unordered_map<string, uint32_t>::iterator, bool> stableId = stableIds.emplace(value, i);
+			if(!readAttributes(current, end, attributes) || !stableId.second) {
+			
+				// Throw exception
+				throw runtime_error("Peer history is invalid");
+			}
+			
+			// Append peer's identifier and attributes
+			peerIdentifiers.push_back(stableId.first->first);
+			latestAttributes.push_back(attributes);
+		}
+	}
+	
+	// Check if reading number of periods failed
+	uint64_t numberOfPeriods;
+	if(!BinarySerializer::readVarint(current, end, numberOfPeriods) || numberOfPeriods > static_cast<uint64_t>(end - current)) {
+	
+		// Throw exception
+		throw runtime_error("Peer history is invalid");
+	}
+	
+	// Go through all periods
+	for(uint64_t i = 0; i < numberOfPeriods; ++i) {
+	
+		// Check if reading period's days failed or the period overlaps the previous period
+		uint64_t firstDay;
+		uint64_t numberOfDays;
+		if(!BinarySerializer::readVarint(current, end, firstDay) || !BinarySerializer::readVarint(current, end, numberOfDays) || !numberOfDays || firstDay > UINT64_MAX - numberOfDays || (!periods.empty() && firstDay < periods.back().firstDay + periods.back().numberOfDays)) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		
+		// Check if reading period's peers failed or they aren't all known
+		uint64_t peersSize;
+		if(!BinarySerializer::readVarint(current, end, peersSize) || peersSize > static_cast<uint64_t>(end - current)) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		Bitmap peers(roaring_bitmap_portable_deserialize_safe(reinterpret_cast<const char *>(current), peersSize), roaring_bitmap_free);
+		if(!peers || !roaring_bitmap_internal_validate(peers.get(), nullptr) || (!roaring_bitmap_is_empty(peers.get()) && roaring_bitmap_maximum(peers.get()) >= peerIdentifiers.size())) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		current += peersSize;
+		
+		// Add period
+		Period &period = periods.emplace_back(Period{
+		
+			// First day
+			.firstDay = firstDay,
+			
+			// Number of days
+			.numberOfDays = numberOfDays,
+			
+			// Peers
+			.peers = move(peers)
+		});
+		
+		// Check if reading number of changes failed
+		uint64_t numberOfChanges;
+		if(!BinarySerializer::readVarint(current, end, numberOfChanges) || numberOfChanges > static_cast<uint64_t>(end - current)) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+		
+		// Go through all changes
+		uint64_t stableId = 0;
+		for(uint64_t j = 0; j < numberOfChanges; ++j) {
+		
+			// Check if reading change failed or its stable ID isn't after the previous change's stable ID
+			uint64_t stableIdDelta;
+			Attributes attributes;
+			if(!BinarySerializer::readVarint(current, end, stableIdDelta) || (j && !stableIdDelta) || stableIdDelta >= peerIdentifiers.size() - stableId || !readAttributes(current, end, attributes)) {
+			
+				// Throw exception
+				throw runtime_error("Peer history is invalid");
+			}
+			
+			// Add change
+			stableId += stableIdDelta;
+			period.changes.emplace_hint(period.changes.end(), stableId, attributes);
+		}
+		
+		// Check if reading counts failed
+		if(!readCounts(current, end, period.versions) || !readCounts(current, end, period.continents) || !readCounts(current, end, period.countries)) {
+		
+			// Throw exception
+			throw runtime_error("Peer history is invalid");
+		}
+	}
+	
+	// Check if file has extra data
+	if(current != end) {
+	
+		// Throw exception
+		throw runtime_error("Peer history is invalid");
+	}
+	
+	// Go through all periods before the last period
+	uint64_t firstNewStableId = 0;
+	for(size_t i = 0; i + 1 < periods.size(); ++i) {
+	
+		// Check if period has peers
+		if(!roaring_bitmap_is_empty(periods[i].peers.get())) {
+		
+			// Update first new stable ID to after the period's peers
+			firstNewStableId = max(firstNewStableId, static_cast<uint64_t>(roaring_bitmap_maximum(periods[i].peers.get())) + 1);
+		}
+	}
+	
+	// Set number of new peers to the number of stable IDs after the earlier periods' peers since stable IDs are given in order
+	numberOfNewPeers = peerIdentifiers.size() - firstNewStableId;
+}
+
+// Add peer
+void PeerHistory::addPeer(const string &peerIdentifier, const chrono::system_clock::time_point &time, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation) {
+
+	// Check if the day is after the current period
+	const uint64_t day = getDay(time);
+	if(periods.empty() || day >= periods.back().firstDay + periods.back().numberOfDays) {
+	
+		// Start a period for the day
+		startPeriod(day);
+	}
+	
+	// Otherwise check if the day is before the current period
+	else if(day < periods.back().firstDay) {
+	
+		// Return
+		return;
+	}
+	
+	// Check if peer doesn't have a stable ID
+	unordered_map<string, uint32_t>::iterator stableId = stableIds.find(peerIdentifier);
+	const bool isNewPeer = stableId == stableIds.end();
+	if(isNewPeer) {
+	
+		// Check if too many new peers were seen in the current period
+		if(numberOfNewPeers >= MAX_NUMBER_OF_NEW_PEERS_PER_DAY) {
+		
+			// Return
+			return;
+		}
+		
+		// Check if there's too many peers
+		if(peerIdentifiers.size() == UINT32_MAX) {
+		
+			// Throw exception
+			throw runtime_error("Peer history has too many peers");
+		}
+		
+		// Give peer the next stable ID
+		stableId = stableIds.emplace(peerIdentifier, peerIdentifiers.size()).first;
+		++numberOfNewPeers;
+	}
+	const uint32_t id = stableId->second;
+	
+	// Get peer's attributes while reusing the string IDs of its latest attributes when they didn't change
+	const Attributes attributes = {
+	
+		// Version ID
+		.versionId = getVersionId(userAgentId),
+		
+		// Continent ID
+		.continentId = getStringId(geolocation.continent, isNewPeer ? UINT32_MAX : latestAttributes[id].continentId),
+		
+		// Country ID
+		.countryId = getStringId(geolocation.country, isNewPeer ? UINT32_MAX : latestAttributes[id].countryId),
+		
+		// Capabilities
+		.capabilities = static_cast<uint32_t>(capabilities),
+		
+		// Base fee
+		.baseFee = baseFee
+	};
+	
+	// Check if peer is new
+	if(isNewPeer) {
+	
+		// Append peer's identifier and attributes
+		peerIdentifiers.push_back(stableId->first);
+		latestAttributes.push_back(attributes);
+	}
+	
+	// Check if peer wasn't already seen in the current period
+	Period &period = periods.back();
+	const bool isAttributesChanged = isNewPeer || latestAttributes[id] != attributes;
+	if(roaring_bitmap_add_checked(period.peers.get(), id)) {
+	
+		// Add peer's attributes to the period's counts
+		updateCounts(period, attributes, true);
+	}
+	
+	// Otherwise check if peer's attributes changed
+	else if(isAttributesChanged) {
+	
+		// Replace peer's latest attributes with its attributes in the period's counts
+		updateCounts(period, latestAttributes[id], false);
+		updateCounts(period, attributes, true);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Return
+		return;
+	}
+	
+	// Check if peer's attributes changed
+	if(isAttributesChanged) {
+	
+		// Record peer's attributes in the period's changes and set its latest attributes
+		period.changes.insert_or_assign(id, attributes);
+		latestAttributes[id] = attributes;
+	}
+	
+	// Set changed to true
+	changed = true;
+}
+
+// Get number of unique peers
+uint64_t PeerHistory::getNumberOfUniquePeers(const uint64_t day) const {
+
+	// Check if no period starts at or before the day
+	deque<Period>::const_iterator period = upper_bound(periods.begin(), periods.end(), day, [](const uint64_t day, const Period &period) -> bool {
+	
+		// Return if the day is before the period
+		return day < period.firstDay;
+	});
+	if(period == periods.begin()) {
+	
+		// Return zero
+		return 0;
+	}
+	
+	// Check if the day is after the last period that starts at or before it
+	--period;
+	if(day >= period->firstDay + period->numberOfDays) {
+	
+		// Return zero
+		return 0;
+	}
+	
+	// Return number of peers in the period
+	return roaring_bitmap_get_cardinality(period->peers.get());
+}
+
+// Get number of unique peers
+uint64_t PeerHistory::getNumberOfUniquePeers(const uint64_t firstDay, const uint64_t lastDay) const {
+
+	// Go through all periods
+	vector<const roaring_bitmap_t *> bitmaps;
+	for(const Period &period : periods) {
+	
+		// Check if period overlaps the days
+		if(period.firstDay <= lastDay && period.firstDay + period.numberOfDays > firstDay) {
+		
+			// Append period's peers to the bitmaps
+			bitmaps.push_back(period.peers.get());
+		}
+	}
+	
+	// Check if no periods overlap the days
+	if(bitmaps.empty()) {
+	
+		// Return zero
+		return 0;
+	}
+	
+	// Check if getting the union of the periods' peers failed
+	const Bitmap peers(roaring_bitmap_or_many(bitmaps.size(), bitmaps.data()), roaring_bitmap_free);
+	if(!peers) {
+	
+		// Throw exception
+		throw runtime_error("Creating bitmap failed");
+	}
+	
+	// Return number of peers in the union
+	return roaring_bitmap_get_cardinality(peers.get());
+}
+
+// Serialize query
+bool PeerHistory::serializeQuery(JsonSerializer &serializer, const string_view &queryString) const {
+
+	// Go through all of the query string's parameters
+	optional<uint64_t> fromTime;
+	optional<uint64_t> toTime;
+	for(size_t parameterStart = 0; parameterStart < queryString.size();) {
+	
+		// Get parameter
+		const size_t parameterEnd = min(queryString.find('&', parameterStart), queryString.size());
+		const string_view parameter = queryString.substr(parameterStart, parameterEnd - parameterStart);
+		parameterStart = parameterEnd + sizeof('&');
+		
+		// Check if parameter is empty
+		if(parameter.empty()) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if parameter isn't a time or its value isn't a number
+		const size_t nameEnd = parameter.find('=');
+		const string_view name = parameter.substr(0, nameEnd);
+		const string value((nameEnd == string_view::npos) ? string_view() : parameter.substr(nameEnd + sizeof('=')));
+		char *end;
+		errno = 0;
+		const unsigned long long time = strtoull(value.c_str(), &end, 10);
+		if((name != "from" && name != "to") || value.empty() || *end != '\0' || value[0] < '0' || value[0] > '9' || errno == ERANGE) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set from or to time
+		((name == "from") ? fromTime : toTime) = time;
+	}
+	
+	// Check if from time isn't provided or it's after the to time
+	const uint64_t firstDay = fromTime.has_value() ? getDay(chrono::system_clock::time_point(chrono::seconds(*fromTime))) : 0;
+	const uint64_t lastDay = toTime.has_value() ? getDay(chrono::system_clock::time_point(chrono::seconds(*toTime))) : firstDay;
+	if(!fromTime.has_value() || firstDay > lastDay) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Append number of unique peers
+	serializer.appendRaw("{\"peers\":");
+	serializer.appendQuotedUnsignedInteger(getNumberOfUniquePeers(firstDay, lastDay));
+	serializer.appendRaw('}');
+	
+	// Return true
+	return true;
+}
+
+// Serialize
+void PeerHistory::serialize(JsonSerializer &serializer) const {
+
+	// Append start of periods
+	serializer.appendRaw("{\"periods\":[");
+	
+	// Go through all periods
+	bool firstPeriod = true;
+	for(const Period &period : periods) {
+	
+		// Time
+		serializer.appendRaw(firstPeriod ? "\n{\"time\":" : ",\n{\"time\":");
+		serializer.appendQuotedUnsignedInteger(chrono::duration_cast<chrono::seconds>(chrono::days(period.firstDay)).count());
+		
+		// Number of days
+		serializer.appendRaw(",\"days\":");
+		serializer.appendQuotedUnsignedInteger(period.numberOfDays);
+		
+		// Number of peers
+		serializer.appendRaw(",\"peers\":");
+		serializer.appendQuotedUnsignedInteger(roaring_bitmap_get_cardinality(period.peers.get()));
+		
+		// Number of countries
+		serializer.appendRaw(",\"countries\":");
+		serializer.appendQuotedUnsignedInteger(period.countries.size());
+		
+		// Versions and continents
+		serializeCounts(serializer, "versions", period.versions);
+		serializeCounts(serializer, "continents", period.continents);
+		serializer.appendRaw('}');
+		
+		// Set first period to false
+		firstPeriod = false;
+	}
+	
+	// Append end of periods
+	serializer.appendRaw("\n]}");
+}
+
+// Serialize
+void PeerHistory::serialize() {
+
+	// Check if not changed since the last serialize
+	if(!changed) {
+	
+		// Return
+		return;
+	}
+	
+	// Append magic and version
+	serializer.clear();
+	serializer.appendRaw(string_view(MAGIC, sizeof(MAGIC) - sizeof('\0')));
+	serializer.appendRaw(string_view(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION)));
+	
+	// Append strings
+	serializer.appendVarint(strings.size());
+	for(const string &value : strings) {
+	
+		// Append string
+		serializer.appendString(value);
+	}
+	
+	// Append peers
+	serializer.appendVarint(peerIdentifiers.size());
+	for(size_t i = 0; i < peerIdentifiers.size(); ++i) {
+	
+		// Append peer's identifier
+		serializer.appendString(peerIdentifiers[i]);
+		
+		// Check if peer is in a period
+		if(!peerIdentifiers[i].empty()) {
+		
+			// Append peer's latest attributes
+			appendAttributes(serializer, latestAttributes[i]);
+		}
+	}
+	
+	// Append periods
+	serializer.appendVarint(periods.size());
+	string peers;
+	for(const Period &period : periods) {
+	
+		// Append period's days
+		serializer.appendVarint(period.firstDay);
+		serializer.appendVarint(period.numberOfDays);
+		
+		// Append period's peers using run containers where they're smaller
+		roaring_bitmap_run_optimize(period.peers.get());
+		peers.resize(roaring_bitmap_portable_size_in_bytes(period.peers.get()));
+		roaring_bitmap_portable_serialize(period.peers.get(), peers.data());
+		serializer.appendVarint(peers.size());
+		serializer.appendRaw(peers);
+		
+		// Append period's changes with each stable ID as the difference from the previous one
+		serializer.appendVarint(period.changes.size());
+		uint32_t previousStableId = 0;
+		for(const pair<const uint32_t, Attributes> &change : period.changes) {
+		
+			// Append change
+			serializer.appendVarint(change.first - previousStableId);
+			appendAttributes(serializer, change.second);
+			previousStableId = change.first;
+		}
+		
+		// Append period's counts
+		for(const unordered_map<uint32_t, uint64_t> *counts : {&period.versions, &period.continents, &period.countries}) {
+		
+			// Append counts
+			serializer.appendVarint(counts->size());
+			for(const pair<const uint32_t, uint64_t> &count : *counts) {
+			
+				// Append count
+				serializer.appendVarint(count.first);
+				serializer.appendVarint(count.second);
+			}
+		}
+	}
+	
+	// Set changed to false
+	changed = false;
+}
+
+// Save
+void PeerHistory::save() {
+
+	// Check if nothing was serialized since the last save
+	if(!serializer.getSize()) {
+	
+		// Return
+		return;
+	}
+	
+	// Write serialized history to the file
+	FileWriter::write(location, serializer.getData(), serializer.getSize());
+	
+	// Clear serializer
+	serializer.clear();
+}
+
+// Get day
+uint64_t PeerHistory::getDay(const chrono::system_clock::time_point &time) {
+
+	// Return number of days since the epoch
+	return chrono::floor<chrono::days>(time).time_since_epoch().count();
+}
+
+// Create bitmap
+PeerHistory::Bitmap PeerHistory::createBitmap() {
+
+	// Check if creating bitmap failed
+	Bitmap bitmap(roaring_bitmap_create(), roaring_bitmap_free);
+	if(!bitmap) {
+	
+		// Throw exception
+		throw runtime_error("Creating bitmap failed");
+	}
+	
+	// Return bitmap
+	return bitmap;
+}
+
+// Start period
+void PeerHistory::startPeriod(const uint64_t day) {
+
+	// Check if a period exists
+	if(!periods.empty()) {
+	
+		// Use run containers for the previous period's peers where they're smaller since it won't change anymore
+		roaring_bitmap_run_optimize(periods.back().peers.get());
+	}
+	
+	// Set number of new peers to zero
+	numberOfNewPeers = 0;
+	
+	// Add period for the day
+	periods.push_back(Period{
+	
+		// First day
+		.firstDay = day,
+		
+		// Number of days
+		.numberOfDays = 1,
+		
+		// Peers
+		.peers = createBitmap()
+	});
+	
+	// Downsample old periods
+	downsample();
+}
+
+// Downsample
+void PeerHistory::downsample() {
+
+	// Get number of daily periods which are always after the weekly periods
+	size_t numberOfDailyPeriods = 0;
+	for(deque<Period>::const_reverse_iterator period = periods.crbegin(); period != periods.crend() && period->numberOfDays == 1; ++period) {
+	
+		// Increment number of daily periods
+		++numberOfDailyPeriods;
+	}
+	
+	// Loop while there's too many daily periods
+	while(numberOfDailyPeriods > MAX_NUMBER_OF_DAILY_PERIODS) {
+	
+		// Make the oldest daily period cover its week
+		const size_t index = periods.size() - numberOfDailyPeriods;
+		periods[index].firstDay -= periods[index].firstDay % DAYS_PER_WEEK;
+		periods[index].numberOfDays = DAYS_PER_WEEK;
+		--numberOfDailyPeriods;
+		
+		// Loop while the next daily period is in the same week so that the weekly period doesn't overlap any daily periods
+		while(index + 1 < periods.size() && periods[index + 1].firstDay < periods[index].firstDay + DAYS_PER_WEEK) {
+		
+			// Add daily period's peers and changes to the weekly period
+			Period &weeklyPeriod = periods[index];
+			Period &dailyPeriod = periods[index + 1];
+			roaring_bitmap_or_inplace(weeklyPeriod.peers.get(), dailyPeriod.peers.get());
+			for(pair<const uint32_t, Attributes> &change : dailyPeriod.changes) {
+			
+				// Add change to the weekly period replacing any earlier change for the same peer
+				weeklyPeriod.changes.insert_or_assign(change.first, change.second);
+			}
+			
+			// Set weekly period's counts to the daily period's counts so that a week has the breakdown of its last day
+			weeklyPeriod.versions = move(dailyPeriod.versions);
+			weeklyPeriod.continents = move(dailyPeriod.continents);
+			weeklyPeriod.countries = move(dailyPeriod.countries);
+			
+			// Remove daily period
+			periods.erase(periods.begin() + index + 1);
+			--numberOfDailyPeriods;
+		}
+		
+		// Optimize weekly period's peers
+		roaring_bitmap_run_optimize(periods[index].peers.get());
+	}
+	
+	// Check if there's too many periods
+	if(periods.size() > MAX_NUMBER_OF_PERIODS) {
+	
+		// Remove oldest periods
+		periods.erase(periods.begin(), periods.end() - MAX_NUMBER_OF_PERIODS);
+		
+		// Check if getting peers that are still in a period failed
+		vector<const roaring_bitmap_t *> bitmaps;
+		for(const Period &period : periods) {
+		
+			// Append period's peers to the bitmaps
+			bitmaps.push_back(period.peers.get());
+		}
+		const Bitmap remainingPeers(roaring_bitmap_or_many(bitmaps.size(), bitmaps.data()), roaring_bitmap_free);
+		if(!remainingPeers) {
+		
+			// Throw exception
+			throw runtime_error("Creating bitmap failed");
+		}
+		
+		// Go through all peers
+		vector<uint32_t> newStableIds(peerIdentifiers.size(), UINT32_MAX);
+		vector<string_view> newPeerIdentifiers;
+		vector<Attributes> newLatestAttributes;
+		for(uint32_t i = 0; i < peerIdentifiers.size(); ++i) {
+		
+			// Check if peer is still in a period
+			if(!peerIdentifiers[i].empty() && roaring_bitmap_contains(remainingPeers.get(), i)) {
+			
+				// Give peer the next new stable ID so that stable IDs stay in the order that peers were first seen
+				newStableIds[i] = newPeerIdentifiers.size();
+				stableIds.find(string(peerIdentifiers[i]))->second = newStableIds[i];
+				newPeerIdentifiers.push_back(peerIdentifiers[i]);
+				newLatestAttributes.push_back(latestAttributes[i]);
+			}
+			
+			// Otherwise check if peer has an identifier
+			else if(!peerIdentifiers[i].empty()) {
+			
+				// Remove peer's stable ID
+				stableIds.erase(string(peerIdentifiers[i]));
+			}
+		}
+		
+		// Go through all periods
+		vector<uint32_t> periodStableIds;
+		for(Period &period : periods) {
+		
+			// Go through all of the period's peers
+			periodStableIds.resize(roaring_bitmap_get_cardinality(period.peers.get()));
+			roaring_bitmap_to_uint32_array(period.peers.get(), periodStableIds.data());
+			size_t numberOfPeriodStableIds = 0;
+			for(const uint32_t stableId : periodStableIds) {
+			
+				// Check if peer is still in a period
+				if(newStableIds[stableId] != UINT32_MAX) {
+				
+					// Replace peer's stable ID with its new stable ID
+					periodStableIds[numberOfPeriodStableIds++] = newStableIds[stableId];
+				}
+			}
+			
+			// Replace period's peers with their new stable IDs
+			Bitmap peers = createBitmap();
+			roaring_bitmap_add_many(peers.get(), numberOfPeriodStableIds, periodStableIds.data());
+			roaring_bitmap_run_optimize(peers.get());
+			period.peers = move(peers);
+			
+			// Go through all of the period's changes
+			map<uint32_t, Attributes> changes;
+			for(const pair<const uint32_t, Attributes> &change : period.changes) {
+			
+				// Check if change's peer is still in a period
+				if(newStableIds[change.first] != UINT32_MAX) {
+				
+					// Add change with its peer's new stable ID which keeps the changes in order
+					changes.emplace_hint(changes.end(), newStableIds[change.first], change.second);
+				}
+			}
+			
+			// Replace period's changes
+			period.changes = move(changes);
+		}
+		
+		// Set peer identifiers and latest attributes to the remaining peers' so that the removed peers' stable IDs are reused
+		peerIdentifiers = move(newPeerIdentifiers);
+		latestAttributes = move(newLatestAttributes);
+	}
+}
+
+// Get version ID
+uint32_t PeerHistory::getVersionId(const uint16_t userAgentId) {
+
+	// Check if user agent's version ID already exists
+	const unordered_map<uint16_t, uint32_t>::const_iterator versionId = versionIds.find(userAgentId);
+	if(versionId != versionIds.end()) {
+	
+		// Return version ID
+		return versionId->second;
+	}
+	
+	// Get user agent's version as its implementation with its major and minor versions or an unknown version if it wasn't matched
+	const optional<UserAgent> &userAgent = userAgentTable.getUserAgent(userAgentId);
+	const string version = userAgent.has_value() ? string(UserAgentMatcher::IMPLEMENTATION_NAMES[userAgent->implementation]) + to_string(userAgent->majorVersion) + '.' + to_string(userAgent->minorVersion) : "Unknown";
+	
+	// Return version's ID
+	return versionIds.emplace(userAgentId, getStringId(version, UINT32_MAX)).first->second;
+}
+
+// Get string ID
+uint32_t PeerHistory::getStringId(const string &value, const uint32_t previousStringId) {
+
+	// Check if value is the previous string
+	if(previousStringId < strings.size() && strings[previousStringId] == value) {
+	
+		// Return previous string ID
+		return previousStringId;
+	}
+	
+	// Check if string already exists
+	const unordered_map<string, uint32_t>::const_iterator stringId = stringIds.find(value);
+	if(stringId != stringIds.end()) {
+	
+		// Return string ID
+		return stringId->second;
+	}
+	
+	// Add string
+	strings.push_back(value);
+	
+	// Return string ID
+	return stringIds.emplace(value, strings.size() - 1).first->second;
+}
+
+// Update counts
+void PeerHistory::updateCounts(Period &period, const Attributes &attributes, const bool add) {
+
+	// Update version, continent, and country counts
+	updateCount(period.versions, attributes.versionId, add);
+	updateCount(period.continents, attributes.continentId, add);
+	updateCount(period.countries, attributes.countryId, add);
+}
+
+// Update count
+void PeerHistory::updateCount(unordered_map<uint32_t, uint64_t> &counts, const uint32_t stringId, const bool add) {
+
+	// Check if adding
+	if(add) {
+	
+		// Increment count
+		++counts[stringId];
+	}
+	
+	// Otherwise check if count is now zero
+	else if(!--counts[stringId]) {
+	
+		// Remove count
+		counts.erase(stringId);
+	}
+}
+
+// Serialize counts
+void PeerHistory::serializeCounts(JsonSerializer &serializer, const char *name, const unordered_map<uint32_t, uint64_t> &counts) const {
+
+	// Append start of counts
+	serializer.appendRaw(",\"");
+	serializer.appendRaw(name);
+	serializer.appendRaw("\":[");
+	
+	// Go through all counts
+	bool firstCount = true;
+	for(const pair<const uint32_t, uint64_t> &count : counts) {
+	
+		// Append count
+		serializer.appendRaw(firstCount ? "{\"name\":" : ",{\"name\":");
+		serializer.appendStringOrNull(strings[count.first]);
+		serializer.appendRaw(",\"count\":");
+		serializer.appendQuotedUnsignedInteger(count.second);
+		serializer.appendRaw('}');
+		
+		// Set first count to false
+		firstCount = false;
+	}
+	
+	// Append end of counts
+	serializer.appendRaw(']');
+}
+
+// Append attributes
+void PeerHistory::appendAttributes(BinarySerializer &serializer, const Attributes &attributes) {
+
+	// Append version, continent, country, capabilities, and base fee
+	serializer.appendVarint(attributes.versionId);
+	serializer.appendVarint(attributes.continentId);
+	serializer.appendVarint(attributes.countryId);
+	serializer.appendVarint(attributes.capabilities);
+	serializer.appendVarint(attributes.baseFee);
+}
+
+// Read attributes
+bool PeerHistory::readAttributes(const uint8_t *&current, const uint8_t *end, Attributes &attributes) const {
+
+	// Check if reading attributes failed or their strings don't exist
+	uint64_t versionId;
+	uint64_t continentId;
+	uint64_t countryId;
+	uint64_t capabilities;
+	if(!BinarySerializer::readVarint(current, end, versionId) || !BinarySerializer::readVarint(current, end, continentId) || !BinarySerializer::readVarint(current, end, countryId) || !BinarySerializer::readVarint(current, end, capabilities) || !BinarySerializer::readVarint(current, end, attributes.baseFee) || versionId >= strings.size() || continentId >= strings.size() || countryId >= strings.size() || capabilities > UINT32_MAX) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Set attributes
+	attributes.versionId = versionId;
+	attributes.continentId = continentId;
+	attributes.countryId = countryId;
+	attributes.capabilities = capabilities;
+	
+	// Return true
+	return true;
+}
+
+// Read counts
+bool PeerHistory::readCounts(const uint8_t *&current, const uint8_t *end, unordered_map<uint32_t, uint64_t> &counts) const {
+
+	// Check if reading number of counts failed
+	uint64_t numberOfCounts;
+	if(!BinarySerializer::readVarint(current, end, numberOfCounts) || numberOfCounts > strings.size()) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Go through all counts
+	for(uint64_t i = 0; i < numberOfCounts; ++i) {
+	
+		// Check if reading count failed or its string doesn't exist
+		uint64_t stringId;
+		uint64_t count;
+		if(!BinarySerializer::readVarint(current, end, stringId) || !BinarySerializer::readVarint(current, end, count) || stringId >= strings.size() || !count) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set count
+		counts[stringId] = count;
+	}
+	
+	// Return true
+	return true;
+}
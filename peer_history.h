@@ -0,0 +1,206 @@
+// Header guard
+#ifndef PEER_HISTORY_H
+#define PEER_HISTORY_H
+
+
+// Header files
+#include "./binary_serializer.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include "./geolocation.h"
+#include "./json_serializer.h"
+#include <map>
+#include <memory>
+#include "./node/mwc_validation_node.h"
+#include "roaring/roaring.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "./user_agent.h"
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Peer history class (which peers were seen each day as bitmaps over stable peer IDs along with the attribute changes seen that day, with old days downsampled to weeks so that its size is bounded)
+class PeerHistory final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit PeerHistory(const char *location, const UserAgentTable &userAgentTable);
+		
+		// Load
+		void load();
+		
+		// Add peer
+		void addPeer(const string &peerIdentifier, const chrono::system_clock::time_point &time, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation);
+		
+		// Get number of unique peers (for the day or the week that it was downsampled into)
+		uint64_t getNumberOfUniquePeers(const uint64_t day) const;
+		
+		// Get number of unique peers
+		uint64_t getNumberOfUniquePeers(const uint64_t firstDay, const uint64_t lastDay) const;
+		
+		// Serialize query (number of unique peers between the query string's from and to times in seconds since the epoch and returns false if the query string is invalid)
+		bool serializeQuery(JsonSerializer &serializer, const string_view &queryString) const;
+		
+		// Serialize
+		void serialize(JsonSerializer &serializer) const;
+		
+		// Serialize
+		void serialize();
+		
+		// Save
+		void save();
+		
+		// Get day
+		static uint64_t getDay(const chrono::system_clock::time_point &time);
+		
+	// Private
+	private:
+	
+		// Magic
+		static constexpr const char MAGIC[] = "MWCH";
+		
+		// Version
+		static constexpr const uint8_t VERSION = 1;
+		
+		// Max number of daily periods
+		static const size_t MAX_NUMBER_OF_DAILY_PERIODS = 90;
+		
+		// Max number of periods
+		static const size_t MAX_NUMBER_OF_PERIODS = MAX_NUMBER_OF_DAILY_PERIODS + 3 * 52;
+		
+		// Days per week
+		static const uint64_t DAYS_PER_WEEK = 7;
+		
+		// Max number of new peers per day (peers first seen after this many in a day aren't recorded so that a flood of distinct addresses can't grow the history without limit)
+		static const uint64_t MAX_NUMBER_OF_NEW_PEERS_PER_DAY = 8192;
+		
+		// Bitmap type
+		typedef unique_ptr<roaring_bitmap_t, decltype(&roaring_bitmap_free)> Bitmap;
+		
+		// Attributes structure
+		struct Attributes {
+		
+			// Version ID
+			uint32_t versionId;
+			
+			// Continent ID
+			uint32_t continentId;
+			
+			// Country ID
+			uint32_t countryId;
+			
+			// Capabilities
+			uint32_t capabilities;
+			
+			// Base fee
+			uint64_t baseFee;
+			
+			// Equality operator
+			bool operator==(const Attributes &other) const = default;
+		};
+		
+		// Period structure
+		struct Period {
+		
+			// First day
+			uint64_t firstDay;
+			
+			// Number of days
+			uint64_t numberOfDays;
+			
+			// Peers
+			Bitmap peers;
+			
+			// Changes (the attributes of peers whose attributes were new or different in the period by stable peer ID)
+			map<uint32_t, Attributes> changes;
+			
+			// Versions (number of the period's peers with each version by string ID)
+			unordered_map<uint32_t, uint64_t> versions;
+			
+			// Continents (number of the period's peers in each continent by string ID)
+			unordered_map<uint32_t, uint64_t> continents;
+			
+			// Countries (number of the period's peers in each country by string ID)
+			unordered_map<uint32_t, uint64_t> countries;
+		};
+		
+		// Create bitmap
+		static Bitmap createBitmap();
+		
+		// Start period
+		void startPeriod(const uint64_t day);
+		
+		// Downsample
+		void downsample();
+		
+		// Get version ID
+		uint32_t getVersionId(const uint16_t userAgentId);
+		
+		// Get string ID
+		uint32_t getStringId(const string &value, const uint32_t previousStringId);
+		
+		// Update counts
+		static void updateCounts(Period &period, const Attributes &attributes, const bool add);
+		
+		// Update count
+		static void updateCount(unordered_map<uint32_t, uint64_t> &counts, const uint32_t stringId, const bool add);
+		
+		// Serialize counts
+		void serializeCounts(JsonSerializer &serializer, const char *name, const unordered_map<uint32_t, uint64_t> &counts) const;
+		
+		// Append attributes
+		static void appendAttributes(BinarySerializer &serializer, const Attributes &attributes);
+		
+		// Read attributes
+		bool readAttributes(const uint8_t *&current, const uint8_t *end, Attributes &attributes) const;
+		
+		// Read counts
+		bool readCounts(const uint8_t *&current, const uint8_t *end, unordered_map<uint32_t, uint64_t> &counts) const;
+		
+		// Location
+		const string location;
+		
+		// User agent table
+		const UserAgentTable &userAgentTable;
+		
+		// Strings
+		vector<string> strings;
+		
+		// String IDs
+		unordered_map<string, uint32_t> stringIds;
+		
+		// Version IDs by user agent ID
+		unordered_map<uint16_t, uint32_t> versionIds;
+		
+		// Stable IDs (given in the order that peers are first seen and renumbered in that order along with the periods' bitmaps when old periods are removed)
+		unordered_map<string, uint32_t> stableIds;
+		
+		// Peer identifiers by stable ID (views of the stable IDs' keys or empty for peers that weren't in any period when a history from before stable IDs were renumbered was saved)
+		vector<string_view> peerIdentifiers;
+		
+		// Latest attributes by stable ID
+		vector<Attributes> latestAttributes;
+		
+		// Periods from oldest to newest
+		deque<Period> periods;
+		
+		// Number of new peers (peers first seen in the current period)
+		uint64_t numberOfNewPeers;
+		
+		// Serializer
+		BinarySerializer serializer;
+		
+		// Changed
+		bool changed;
+};
+
+
+#endif
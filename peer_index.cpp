@@ -0,0 +1,653 @@
+// Header files
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include "./peer_index.h"
+#include <stdexcept>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+PeerIndex::PeerIndex(const UserAgentTable &userAgentTable) :
+
+	// Set user agent table to user agent table
+	userAgentTable(userAgentTable),
+	
+	// Create all peers bitmap
+	allPeers(createBitmap()),
+	
+	// Create Tor peers bitmap
+	torPeers(createBitmap()),
+	
+	// Create inbound peers bitmap
+	inboundPeers(createBitmap())
+{
+}
+
+// Add peer
+void PeerIndex::addPeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation, const bool isInbound) {
+
+	// Check if a free ID exists
+	uint32_t id;
+	if(!freeIds.empty()) {
+	
+		// Use the most recently freed ID
+		id = freeIds.back();
+		freeIds.pop_back();
+		peerIdentifiers[id] = peerIdentifier;
+		baseFees[id] = baseFee;
+	}
+	
+	// Otherwise
+	else {
+	
+		// Check if there's too many peers
+		if(peerIdentifiers.size() == UINT32_MAX) {
+		
+			// Throw exception
+			throw runtime_error("Peer index has too many peers");
+		}
+		
+		// Use the next ID
+		id = peerIdentifiers.size();
+		peerIdentifiers.push_back(peerIdentifier);
+		baseFees.push_back(baseFee);
+	}
+	
+	// Set peer's ID
+	ids.emplace(peerIdentifiers[id], id);
+	
+	// Add peer to all peers
+	roaring_bitmap_add(allPeers.get(), id);
+	
+	// Check if peer is a Tor peer
+	if(peerIdentifier.ends_with(".onion")) {
+	
+		// Add peer to the Tor peers
+		roaring_bitmap_add(torPeers.get(), id);
+	}
+	
+	// Check if peer is inbound
+	if(isInbound) {
+	
+		// Add peer to the inbound peers
+		roaring_bitmap_add(inboundPeers.get(), id);
+	}
+	
+	// Go through all capability bits
+	for(uint8_t i = 0; i < sizeof(uint32_t) * 8; ++i) {
+	
+		// Check if peer has the capability
+		if(static_cast<uint32_t>(capabilities) & (static_cast<uint32_t>(1) << i)) {
+		
+			// Add peer to the capability's peers
+			addToBitmap(capabilityPeers, i, id);
+		}
+	}
+	
+	// Check if peer has a continent
+	if(!geolocation.continent.empty()) {
+	
+		// Add peer to the continent's peers
+		addToBitmap(continentPeers, geolocation.continent, id);
+	}
+	
+	// Check if peer has a country
+	if(!geolocation.country.empty()) {
+	
+		// Add peer to the country's peers
+		addToBitmap(countryPeers, geolocation.country, id);
+	}
+	
+	// Add peer to the user agent's and base fee tier's peers
+	addToBitmap(userAgentPeers, userAgentId, id);
+	addToBitmap(baseFeeTierPeers, getBaseFeeTier(baseFee), id);
+}
+
+// Remove peer
+void PeerIndex::removePeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation, const bool isInbound) {
+
+	// Check if peer isn't in the index
+	const unordered_map<string_view, uint32_t>::const_iterator peerId = ids.find(peerIdentifier);
+	if(peerId == ids.end()) {
+	
+		// Return
+		return;
+	}
+	
+	// Free peer's ID
+	const uint32_t id = peerId->second;
+	ids.erase(peerId);
+	peerIdentifiers[id] = string_view();
+	freeIds.push_back(id);
+	
+	// Remove peer from all, Tor, and inbound peers
+	roaring_bitmap_remove(allPeers.get(), id);
+	roaring_bitmap_remove(torPeers.get(), id);
+	roaring_bitmap_remove(inboundPeers.get(), id);
+	
+	// Go through all capability bits
+	for(uint8_t i = 0; i < sizeof(uint32_t) * 8; ++i) {
+	
+		// Check if peer has the capability
+		if(static_cast<uint32_t>(capabilities) & (static_cast<uint32_t>(1) << i)) {
+		
+			// Remove peer from the capability's peers
+			removeFromBitmap(capabilityPeers, i, id);
+		}
+	}
+	
+	// Check if peer has a continent
+	if(!geolocation.continent.empty()) {
+	
+		// Remove peer from the continent's peers
+		removeFromBitmap(continentPeers, geolocation.continent, id);
+	}
+	
+	// Check if peer has a country
+	if(!geolocation.country.empty()) {
+	
+		// Remove peer from the country's peers
+		removeFromBitmap(countryPeers, geolocation.country, id);
+	}
+	
+	// Remove peer from the user agent's and base fee tier's peers
+	removeFromBitmap(userAgentPeers, userAgentId, id);
+	removeFromBitmap(baseFeeTierPeers, getBaseFeeTier(baseFee), id);
+	
+	// Check if no peers exist
+	if(ids.empty()) {
+	
+		// Reset IDs so that they start at zero again
+		peerIdentifiers.clear();
+		baseFees.clear();
+		freeIds.clear();
+	}
+}
+
+// Clear
+void PeerIndex::clear() {
+
+	// Clear IDs
+	ids.clear();
+	peerIdentifiers.clear();
+	baseFees.clear();
+	freeIds.clear();
+	
+	// Clear all, Tor, and inbound peers
+	roaring_bitmap_clear(allPeers.get());
+	roaring_bitmap_clear(torPeers.get());
+	roaring_bitmap_clear(inboundPeers.get());
+	
+	// Clear capability, continent, country, user agent, and base fee tier peers
+	capabilityPeers.clear();
+	continentPeers.clear();
+	countryPeers.clear();
+	userAgentPeers.clear();
+	baseFeeTierPeers.clear();
+}
+
+// Query
+uint64_t PeerIndex::query(const Query &query, const function<void(const string_view &peerIdentifier)> &onPeerCallback) const {
+
+	// Start with all peers
+	const Bitmap result(roaring_bitmap_copy(allPeers.get()), roaring_bitmap_free);
+	if(!result) {
+	
+		// Throw exception
+		throw runtime_error("Creating bitmap failed");
+	}
+	
+	// Check if query has a continent
+	if(query.continent.has_value()) {
+	
+		// Check if continent doesn't have any peers
+		const unordered_map<string, Bitmap>::const_iterator continent = continentPeers.find(*query.continent);
+		if(continent == continentPeers.end()) {
+		
+			// Return zero
+			return 0;
+		}
+		
+		// Intersect result with the continent's peers
+		roaring_bitmap_and_inplace(result.get(), continent->second.get());
+	}
+	
+	// Check if query has a country
+	if(query.country.has_value()) {
+	
+		// Check if country doesn't have any peers
+		const unordered_map<string, Bitmap>::const_iterator country = countryPeers.find(*query.country);
+		if(country == countryPeers.end()) {
+		
+			// Return zero
+			return 0;
+		}
+		
+		// Intersect result with the country's peers
+		roaring_bitmap_and_inplace(result.get(), country->second.get());
+	}
+	
+	// Go through all capability bits
+	for(uint8_t i = 0; i < sizeof(uint32_t) * 8; ++i) {
+	
+		// Check if query requires the capability
+		if(query.capabilities & (static_cast<uint32_t>(1) << i)) {
+		
+			// Check if capability doesn't have any peers
+			const unordered_map<uint8_t, Bitmap>::const_iterator capability = capabilityPeers.find(i);
+			if(capability == capabilityPeers.end()) {
+			
+				// Return zero
+				return 0;
+			}
+			
+			// Intersect result with the capability's peers
+			roaring_bitmap_and_inplace(result.get(), capability->second.get());
+		}
+	}
+	
+	// Check if query has a user agent prefix or version
+	if(query.userAgentPrefix.has_value() || !query.version.empty()) {
+	
+		// Go through all user agents that have peers
+		const Bitmap userAgentsResult = createBitmap();
+		for(const pair<const uint16_t, Bitmap> &userAgent : userAgentPeers) {
+		
+			// Check if user agent doesn't start with the prefix
+			if(query.userAgentPrefix.has_value() && !userAgentTable.getName(userAgent.first).starts_with(*query.userAgentPrefix)) {
+			
+				// Continue
+				continue;
+			}
+			
+			// Check if query has a version
+			if(!query.version.empty()) {
+			
+				// Check if user agent's version isn't known or doesn't match the version
+				const optional<UserAgent> &parsedUserAgent = userAgentTable.getUserAgent(userAgent.first);
+				if(!parsedUserAgent.has_value() || parsedUserAgent->majorVersion != query.version[0] || (query.version.size() > 1 && parsedUserAgent->minorVersion != query.version[1]) || (query.version.size() > 2 && parsedUserAgent->patchVersion != query.version[2])) {
+				
+					// Continue
+					continue;
+				}
+			}
+			
+			// Add user agent's peers to the user agents result
+			roaring_bitmap_or_inplace(userAgentsResult.get(), userAgent.second.get());
+		}
+		
+		// Intersect result with the user agents result
+		roaring_bitmap_and_inplace(result.get(), userAgentsResult.get());
+	}
+	
+	// Check if query has a min or max base fee
+	if(query.minBaseFee.has_value() || query.maxBaseFee.has_value()) {
+	
+		// Go through all base fee tiers that have peers
+		const uint64_t minBaseFee = query.minBaseFee.value_or(0);
+		const uint64_t maxBaseFee = query.maxBaseFee.value_or(UINT64_MAX);
+		const uint8_t minBaseFeeTier = getBaseFeeTier(minBaseFee);
+		const uint8_t maxBaseFeeTier = getBaseFeeTier(maxBaseFee);
+		const Bitmap baseFeesResult = createBitmap();
+		for(const pair<const uint8_t, Bitmap> &baseFeeTier : baseFeeTierPeers) {
+		
+			// Check if base fee tier overlaps the range
+			if(baseFeeTier.first >= minBaseFeeTier && baseFeeTier.first <= maxBaseFeeTier) {
+			
+				// Add base fee tier's peers to the base fees result
+				roaring_bitmap_or_inplace(baseFeesResult.get(), baseFeeTier.second.get());
+			}
+		}
+		
+		// Intersect result with the base fees result
+		roaring_bitmap_and_inplace(result.get(), baseFeesResult.get());
+		
+		// Check if the range doesn't start at its first base fee tier's lowest base fee
+		const Bitmap edgePeers = createBitmap();
+		const unordered_map<uint8_t, Bitmap>::const_iterator minBaseFeeTierPeers = baseFeeTierPeers.find(minBaseFeeTier);
+		if((minBaseFee & (minBaseFee - 1)) && minBaseFeeTierPeers != baseFeeTierPeers.end()) {
+		
+			// Add the first base fee tier's peers to the edge peers since some of their base fees may be before the range
+			roaring_bitmap_or_inplace(edgePeers.get(), minBaseFeeTierPeers->second.get());
+		}
+		
+		// Check if the range doesn't end at its last base fee tier's highest base fee
+		const unordered_map<uint8_t, Bitmap>::const_iterator maxBaseFeeTierPeers = baseFeeTierPeers.find(maxBaseFeeTier);
+		if((maxBaseFee & (maxBaseFee + 1)) && maxBaseFeeTierPeers != baseFeeTierPeers.end()) {
+		
+			// Add the last base fee tier's peers to the edge peers since some of their base fees may be after the range
+			roaring_bitmap_or_inplace(edgePeers.get(), maxBaseFeeTierPeers->second.get());
+		}
+		
+		// Get the result's edge peers
+		roaring_bitmap_and_inplace(edgePeers.get(), result.get());
+		vector<uint32_t> edgePeerIds(roaring_bitmap_get_cardinality(edgePeers.get()));
+		roaring_bitmap_to_uint32_array(edgePeers.get(), edgePeerIds.data());
+		
+		// Go through all of the result's edge peers
+		for(const uint32_t id : edgePeerIds) {
+		
+			// Check if peer's base fee isn't in the range
+			if(baseFees[id] < minBaseFee || baseFees[id] > maxBaseFee) {
+			
+				// Remove peer from the result
+				roaring_bitmap_remove(result.get(), id);
+			}
+		}
+	}
+	
+	// Check if query has Tor
+	if(query.isTor.has_value()) {
+	
+		// Check if query wants Tor peers
+		if(*query.isTor) {
+		
+			// Intersect result with the Tor peers
+			roaring_bitmap_and_inplace(result.get(), torPeers.get());
+		}
+		
+		// Otherwise
+		else {
+		
+			// Remove Tor peers from the result
+			roaring_bitmap_andnot_inplace(result.get(), torPeers.get());
+		}
+	}
+	
+	// Check if query has inbound
+	if(query.isInbound.has_value()) {
+	
+		// Check if query wants inbound peers
+		if(*query.isInbound) {
+		
+			// Intersect result with the inbound peers
+			roaring_bitmap_and_inplace(result.get(), inboundPeers.get());
+		}
+		
+		// Otherwise
+		else {
+		
+			// Remove inbound peers from the result
+			roaring_bitmap_andnot_inplace(result.get(), inboundPeers.get());
+		}
+	}
+	
+	// Get result's IDs that are in the requested page
+	const uint64_t numberOfPeers = roaring_bitmap_get_cardinality(result.get());
+	vector<uint32_t> resultIds((query.offset < numberOfPeers) ? min<uint64_t>(numberOfPeers - query.offset, query.limit) : 0);
+	if(!resultIds.empty()) {
+	
+		// Check if getting the result's IDs failed
+		if(!roaring_bitmap_range_uint32_array(result.get(), query.offset, resultIds.size(), resultIds.data())) {
+		
+			// Throw exception
+			throw runtime_error("Getting bitmap values failed");
+		}
+	}
+	
+	// Go through all of the result's IDs
+	for(const uint32_t id : resultIds) {
+	
+		// Run on peer callback
+		onPeerCallback(peerIdentifiers[id]);
+	}
+	
+	// Return number of peers
+	return numberOfPeers;
+}
+
+// Get base fee tier
+uint8_t PeerIndex::getBaseFeeTier(const uint64_t baseFee) {
+
+	// Return base fee's bit width
+	return bit_width(baseFee);
+}
+
+// Parse query
+optional<PeerIndex::Query> PeerIndex::parseQuery(const string_view &queryString) {
+
+	// Go through all of the query string's parameters
+	Query query;
+	for(size_t parameterStart = 0; parameterStart < queryString.size();) {
+	
+		// Get parameter
+		const size_t parameterEnd = min(queryString.find('&', parameterStart), queryString.size());
+		const string_view parameter = queryString.substr(parameterStart, parameterEnd - parameterStart);
+		parameterStart = parameterEnd + sizeof('&');
+		
+		// Check if parameter is empty
+		if(parameter.empty()) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if parameter's name or value is invalid
+		const size_t nameEnd = parameter.find('=');
+		const string_view name = parameter.substr(0, nameEnd);
+		const optional<string> value = decodeQueryValue((nameEnd == string_view::npos) ? string_view() : parameter.substr(nameEnd + sizeof('=')));
+		if(!value.has_value() || value->empty()) {
+		
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Check if parameter is a string
+		if(name == "continent" || name == "country" || name == "user_agent") {
+		
+			// Set query's string
+			((name == "continent") ? query.continent : ((name == "country") ? query.country : query.userAgentPrefix)) = *value;
+		}
+		
+		// Otherwise check if parameter is a boolean
+		else if(name == "tor" || name == "inbound") {
+		
+			// Check if value isn't a boolean
+			if(*value != "true" && *value != "false") {
+			
+				// Return nothing
+				return nullopt;
+			}
+			
+			// Set query's boolean
+			((name == "tor") ? query.isTor : query.isInbound) = *value == "true";
+		}
+		
+		// Otherwise check if parameter is a version
+		else if(name == "version") {
+		
+			// Go through all of the version's components
+			query.version.clear();
+			for(const char *current = value->c_str();; current += sizeof('.')) {
+			
+				// Check if version component is invalid
+				char *end;
+				const unsigned long versionComponent = strtoul(current, &end, 10);
+				if(*current < '0' || *current > '9' || versionComponent > UINT16_MAX || (*end != '.' && *end != '\0') || query.version.size() == 3) {
+				
+					// Return nothing
+					return nullopt;
+				}
+				
+				// Append version component to the version
+				query.version.push_back(versionComponent);
+				
+				// Check if at the end of the version
+				current = end;
+				if(*current == '\0') {
+				
+					// Break
+					break;
+				}
+			}
+		}
+		
+		// Otherwise check if parameter is a number
+		else if(name == "capabilities" || name == "min_base_fee" || name == "max_base_fee" || name == "offset" || name == "limit") {
+		
+			// Check if value isn't a number
+			char *end;
+			errno = 0;
+			const unsigned long long number = strtoull(value->c_str(), &end, 10);
+			if(*end != '\0' || (*value)[0] < '0' || (*value)[0] > '9' || errno == ERANGE) {
+			
+				// Return nothing
+				return nullopt;
+			}
+			
+			// Check if parameter is capabilities
+			if(name == "capabilities") {
+			
+				// Check if capabilities are invalid
+				if(number > UINT32_MAX) {
+				
+					// Return nothing
+					return nullopt;
+				}
+				
+				// Set query's capabilities
+				query.capabilities = number;
+			}
+			
+			// Otherwise check if parameter is a base fee
+			else if(name == "min_base_fee" || name == "max_base_fee") {
+			
+				// Set query's base fee
+				((name == "min_base_fee") ? query.minBaseFee : query.maxBaseFee) = number;
+			}
+			
+			// Otherwise check if parameter is offset
+			else if(name == "offset") {
+			
+				// Set query's offset
+				query.offset = number;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Check if limit is invalid
+				if(number > MAX_QUERY_LIMIT) {
+				
+					// Return nothing
+					return nullopt;
+				}
+				
+				// Set query's limit
+				query.limit = number;
+			}
+		}
+		
+		// Otherwise
+		else {
+		
+			// Return nothing
+			return nullopt;
+		}
+	}
+	
+	// Return query
+	return query;
+}
+
+// Create bitmap
+PeerIndex::Bitmap PeerIndex::createBitmap() {
+
+	// Check if creating bitmap failed
+	Bitmap bitmap(roaring_bitmap_create(), roaring_bitmap_free);
+	if(!bitmap) {
+	
+		// Throw exception
+		throw runtime_error("Creating bitmap failed");
+	}
+	
+	// Return bitmap
+	return bitmap;
+}
+
+// Add to bitmap
+template<typename Key> void PeerIndex::addToBitmap(unordered_map<Key, Bitmap> &bitmaps, const Key &key, const uint32_t id) {
+
+	// Check if key's bitmap doesn't exist
+	typename unordered_map<Key, Bitmap>::iterator bitmap = bitmaps.find(key);
+	if(bitmap == bitmaps.end()) {
+	
+		// Create key's bitmap
+		bitmap = bitmaps.emplace(key, createBitmap()).first;
+	}
+	
+	// Add ID to the key's bitmap
+	roaring_bitmap_add(bitmap->second.get(), id);
+}
+
+// Remove from bitmap
+template<typename Key> void PeerIndex::removeFromBitmap(unordered_map<Key, Bitmap> &bitmaps, const Key &key, const uint32_t id) {
+
+	// Remove ID from the key's bitmap
+	typename unordered_map<Key, Bitmap>::iterator bitmap = bitmaps.find(key);
+	roaring_bitmap_remove(bitmap->second.get(), id);
+	
+	// Check if key's bitmap doesn't have any other IDs
+	if(roaring_bitmap_is_empty(bitmap->second.get())) {
+	
+		// Remove key's bitmap so that keys that no peers have don't accumulate
+		bitmaps.erase(bitmap);
+	}
+}
+
+// Decode query value
+optional<string> PeerIndex::decodeQueryValue(const string_view &value) {
+
+	// Go through all of the value's characters
+	string decodedValue;
+	decodedValue.reserve(value.size());
+	for(size_t i = 0; i < value.size(); ++i) {
+	
+		// Check character
+		switch(value[i]) {
+		
+			// Plus
+			case '+':
+			
+				// Append space to the decoded value
+				decodedValue.push_back(' ');
+				
+				// Break
+				break;
+				
+			// Percent
+			case '%':
+			
+				// Check if percent encoding is invalid
+				if(i + 2 >= value.size() || !isxdigit(value[i + 1]) || !isxdigit(value[i + 2])) {
+				
+					// Return nothing
+					return nullopt;
+				}
+				
+				// Append percent encoded character to the decoded value
+				decodedValue.push_back(strtoul(string(value.substr(i + 1, 2)).c_str(), nullptr, 16));
+				i += 2;
+				
+				// Break
+				break;
+				
+			// Default
+			default:
+			
+				// Append character to the decoded value
+				decodedValue.push_back(value[i]);
+				
+				// Break
+				break;
+		}
+	}
+	
+	// Return decoded value
+	return decodedValue;
+}
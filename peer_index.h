@@ -0,0 +1,151 @@
+// Header guard
+#ifndef PEER_INDEX_H
+#define PEER_INDEX_H
+
+
+// Header files
+#include <cstdint>
+#include <functional>
+#include "./geolocation.h"
+#include <memory>
+#include "./node/mwc_validation_node.h"
+#include <optional>
+#include "roaring/roaring.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "./user_agent.h"
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Peer index class (incrementally maintained bitmaps of which peers have each attribute so that filtered queries are bitmap intersections instead of going through every peer)
+class PeerIndex final {
+
+	// Public
+	public:
+	
+		// Max query limit
+		static const size_t MAX_QUERY_LIMIT = 1000;
+		
+		// Query structure
+		struct Query {
+		
+			// Continent
+			optional<string> continent;
+			
+			// Country
+			optional<string> country;
+			
+			// User agent prefix
+			optional<string> userAgentPrefix;
+			
+			// Version (major, minor, and patch versions that must match with missing ones matching anything)
+			vector<uint16_t> version;
+			
+			// Capabilities (all of which must be present)
+			uint32_t capabilities = 0;
+			
+			// Min base fee
+			optional<uint64_t> minBaseFee;
+			
+			// Max base fee
+			optional<uint64_t> maxBaseFee;
+			
+			// Is Tor
+			optional<bool> isTor;
+			
+			// Is inbound
+			optional<bool> isInbound;
+			
+			// Offset
+			size_t offset = 0;
+			
+			// Limit
+			size_t limit = MAX_QUERY_LIMIT;
+		};
+		
+		// Constructor
+		explicit PeerIndex(const UserAgentTable &userAgentTable);
+		
+		// Add peer
+		void addPeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation, const bool isInbound);
+		
+		// Remove peer
+		void removePeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, const Geolocation &geolocation, const bool isInbound);
+		
+		// Clear
+		void clear();
+		
+		// Query
+		uint64_t query(const Query &query, const function<void(const string_view &peerIdentifier)> &onPeerCallback) const;
+		
+		// Parse query
+		static optional<Query> parseQuery(const string_view &queryString);
+		
+	// Private
+	private:
+	
+		// Bitmap type
+		typedef unique_ptr<roaring_bitmap_t, decltype(&roaring_bitmap_free)> Bitmap;
+		
+		// Create bitmap
+		static Bitmap createBitmap();
+		
+		// Add to bitmap
+		template<typename Key> static void addToBitmap(unordered_map<Key, Bitmap> &bitmaps, const Key &key, const uint32_t id);
+		
+		// Remove from bitmap
+		template<typename Key> static void removeFromBitmap(unordered_map<Key, Bitmap> &bitmaps, const Key &key, const uint32_t id);
+		
+		// Decode query value
+		static optional<string> decodeQueryValue(const string_view &value);
+		
+		// Get base fee tier (the base fee's bit width so that there's a fixed number of tiers no matter what base fees peers report)
+		static uint8_t getBaseFeeTier(const uint64_t baseFee);
+		
+		// User agent table
+		const UserAgentTable &userAgentTable;
+		
+		// IDs (views of the peer registry's keys which stay valid until the peer is removed)
+		unordered_map<string_view, uint32_t> ids;
+		
+		// Peer identifiers by ID
+		vector<string_view> peerIdentifiers;
+		
+		// Base fees by ID
+		vector<uint64_t> baseFees;
+		
+		// Free IDs (reused so that the IDs stay dense)
+		vector<uint32_t> freeIds;
+		
+		// All peers
+		Bitmap allPeers;
+		
+		// Tor peers
+		Bitmap torPeers;
+		
+		// Inbound peers
+		Bitmap inboundPeers;
+		
+		// Capability peers by capability bit
+		unordered_map<uint8_t, Bitmap> capabilityPeers;
+		
+		// Continent peers
+		unordered_map<string, Bitmap> continentPeers;
+		
+		// Country peers
+		unordered_map<string, Bitmap> countryPeers;
+		
+		// User agent peers
+		unordered_map<uint16_t, Bitmap> userAgentPeers;
+		
+		// Base fee tier peers
+		unordered_map<uint8_t, Bitmap> baseFeeTierPeers;
+};
+
+
+#endif
@@ -0,0 +1,485 @@
+// Header files
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include "./peer_protocol.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Parse genesis block hash
+optional<array<uint8_t, 32>> PeerProtocol::parseGenesisBlockHash(const char *genesisBlockHash) {
+
+	// Check if genesis block hash isn't the correct length
+	if(strlen(genesisBlockHash) != sizeof(array<uint8_t, 32>) * 2) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Go through all bytes in the genesis block hash
+	array<uint8_t, 32> result;
+	for(size_t i = 0; i < result.size(); ++i) {
+	
+		// Go through the byte's hex characters
+		result[i] = 0;
+		for(size_t j = 0; j < 2; ++j) {
+		
+			// Check hex character
+			const char character = genesisBlockHash[i * 2 + j];
+			result[i] <<= 4;
+			if(character >= '0' && character <= '9') {
+			
+				// Add hex character's value to the byte
+				result[i] |= character - '0';
+			}
+			
+			// Otherwise check if hex character is a lowercase letter
+			else if(character >= 'a' && character <= 'f') {
+			
+				// Add hex character's value to the byte
+				result[i] |= character - 'a' + 10;
+			}
+			
+			// Otherwise check if hex character is an uppercase letter
+			else if(character >= 'A' && character <= 'F') {
+			
+				// Add hex character's value to the byte
+				result[i] |= character - 'A' + 10;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Return nothing
+				return nullopt;
+			}
+		}
+	}
+	
+	// Return result
+	return result;
+}
+
+// Create hand message
+vector<uint8_t> PeerProtocol::createHandMessage(const string &receiverAddress, const uint64_t nonce, const array<uint8_t, 32> &genesisBlockHash) {
+
+	// Return hand message with no capabilities, no total difficulty, and an unspecified sender address
+	return createHandMessage({
+	
+		// Protocol version
+		.protocolVersion = PROTOCOL_VERSION,
+		
+		// Capabilities
+		.capabilities = MwcValidationNode::Node::Capabilities::NONE,
+		
+		// Total difficulty
+		.totalDifficulty = 0,
+		
+		// User agent
+		.userAgent = USER_AGENT,
+		
+		// Genesis block hash
+		.genesisBlockHash = genesisBlockHash,
+		
+		// Base fee
+		.baseFee = MwcValidationNode::Node::DEFAULT_BASE_FEE
+		
+	}, "0.0.0.0:0", receiverAddress, nonce);
+}
+
+// Create hand message
+vector<uint8_t> PeerProtocol::createHandMessage(const Handshake &handshake, const string &senderAddress, const string &receiverAddress, const uint64_t nonce) {
+
+	// Append protocol version, capabilities, nonce, and total difficulty
+	vector<uint8_t> payload;
+	appendInteger(payload, handshake.protocolVersion);
+	appendInteger(payload, static_cast<uint32_t>(handshake.capabilities));
+	appendInteger(payload, nonce);
+	appendInteger(payload, handshake.totalDifficulty);
+	
+	// Check if appending sender address failed
+	if(!appendPeerAddress(payload, senderAddress)) {
+	
+		// Append unspecified sender address
+		appendPeerAddress(payload, "0.0.0.0:0");
+	}
+	
+	// Check if appending receiver address failed
+	if(!appendPeerAddress(payload, receiverAddress)) {
+	
+		// Append unspecified receiver address
+		appendPeerAddress(payload, "0.0.0.0:0");
+	}
+	
+	// Append user agent, genesis block hash, and base fee
+	appendString(payload, handshake.userAgent);
+	payload.insert(payload.end(), handshake.genesisBlockHash.begin(), handshake.genesisBlockHash.end());
+	appendInteger(payload, handshake.baseFee);
+	
+	// Return hand message
+	return createMessage(MessageType::HAND, payload);
+}
+
+// Create get peer addresses message
+vector<uint8_t> PeerProtocol::createGetPeerAddressesMessage() {
+
+	// Append capabilities that peers must have
+	vector<uint8_t> payload;
+	appendInteger(payload, static_cast<uint32_t>(MwcValidationNode::Node::Capabilities::NONE));
+	
+	// Return get peer addresses message
+	return createMessage(MessageType::GET_PEER_ADDRESSES, payload);
+}
+
+// Parse message header
+optional<PeerProtocol::MessageHeader> PeerProtocol::parseMessageHeader(const uint8_t *data) {
+
+	// Check if magic is invalid
+	if(data[0] != MAGIC[0] || data[1] != MAGIC[1]) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Get length
+	uint64_t length = 0;
+	for(size_t i = 0; i < sizeof(length); ++i) {
+	
+		// Append byte to the length
+		length = (length << 8) | data[MAGIC.size() + sizeof(MessageType) + i];
+	}
+	
+	// Check if length is too large
+	if(length > MAX_MESSAGE_LENGTH) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Return message header
+	return MessageHeader{
+	
+		// Type
+		.type = static_cast<MessageType>(data[MAGIC.size()]),
+		
+		// Length
+		.length = length
+	};
+}
+
+// Parse handshake
+optional<PeerProtocol::Handshake> PeerProtocol::parseHandshake(const MessageType type, const vector<uint8_t> &payload) {
+
+	// Check if reading protocol version and capabilities failed
+	Handshake handshake;
+	size_t offset = 0;
+	uint32_t capabilities;
+	if(!readInteger(payload, offset, handshake.protocolVersion) || !readInteger(payload, offset, capabilities)) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Set capabilities
+	handshake.capabilities = static_cast<MwcValidationNode::Node::Capabilities>(capabilities);
+	
+	// Check if handshake is a hand
+	string senderAddress;
+	string receiverAddress;
+	uint64_t nonce;
+	if(type == MessageType::HAND) {
+	
+		// Check if reading nonce, total difficulty, sender address, or receiver address failed
+		if(!readInteger(payload, offset, nonce) || !readInteger(payload, offset, handshake.totalDifficulty) || !readPeerAddress(payload, offset, senderAddress) || !readPeerAddress(payload, offset, receiverAddress)) {
+		
+			// Return nothing
+			return nullopt;
+		}
+	}
+	
+	// Otherwise check if reading total difficulty failed
+	else if(!readInteger(payload, offset, handshake.totalDifficulty)) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Check if reading user agent or genesis block hash failed
+	if(!readString(payload, offset, handshake.userAgent) || payload.size() - offset < handshake.genesisBlockHash.size()) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Get genesis block hash
+	memcpy(handshake.genesisBlockHash.data(), &payload[offset], handshake.genesisBlockHash.size());
+	offset += handshake.genesisBlockHash.size();
+	
+	// Check if reading base fee failed since older protocol versions don't include it
+	if(!readInteger(payload, offset, handshake.baseFee)) {
+	
+		// Set base fee to the default base fee
+		handshake.baseFee = MwcValidationNode::Node::DEFAULT_BASE_FEE;
+	}
+	
+	// Return handshake
+	return handshake;
+}
+
+// Parse peer addresses
+optional<vector<string>> PeerProtocol::parsePeerAddresses(const vector<uint8_t> &payload) {
+
+	// Check if reading number of peer addresses failed or it's too large
+	size_t offset = 0;
+	uint32_t numberOfPeerAddresses;
+	if(!readInteger(payload, offset, numberOfPeerAddresses) || numberOfPeerAddresses > MAX_NUMBER_OF_PEER_ADDRESSES) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Go through all peer addresses
+	vector<string> peerAddresses(numberOfPeerAddresses);
+	for(string &peerAddress : peerAddresses) {
+	
+		// Check if reading peer address failed
+		if(!readPeerAddress(payload, offset, peerAddress)) {
+		
+			// Return nothing
+			return nullopt;
+		}
+	}
+	
+	// Return peer addresses
+	return peerAddresses;
+}
+
+// Create message
+vector<uint8_t> PeerProtocol::createMessage(const MessageType type, const vector<uint8_t> &payload) {
+
+	// Append magic, type, length, and payload
+	vector<uint8_t> message(MAGIC.begin(), MAGIC.end());
+	message.push_back(static_cast<uint8_t>(type));
+	appendInteger(message, static_cast<uint64_t>(payload.size()));
+	message.insert(message.end(), payload.begin(), payload.end());
+	
+	// Return message
+	return message;
+}
+
+// Append integer
+template<typename Type> void PeerProtocol::appendInteger(vector<uint8_t> &data, const Type value) {
+
+	// Go through all bytes in the value
+	for(size_t i = 0; i < sizeof(value); ++i) {
+	
+		// Append byte in big endian
+		data.push_back(value >> ((sizeof(value) - i - 1) * 8));
+	}
+}
+
+// Append string
+void PeerProtocol::appendString(vector<uint8_t> &data, const string &value) {
+
+	// Append value's length and value
+	appendInteger(data, static_cast<uint64_t>(value.size()));
+	data.insert(data.end(), value.begin(), value.end());
+}
+
+// Append peer address
+bool PeerProtocol::appendPeerAddress(vector<uint8_t> &data, const string &peerAddress) {
+
+	// Check if peer address is an onion address
+	if(peerAddress.ends_with(".onion")) {
+	
+		// Append onion address
+		data.push_back(static_cast<uint8_t>(PeerAddressType::ONION));
+		appendString(data, peerAddress);
+		
+		// Return true
+		return true;
+	}
+	
+	// Check if peer address doesn't have a port
+	const size_t portSeparator = peerAddress.rfind(':');
+	if(portSeparator == string::npos) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if parsing port failed
+	char *end;
+	const unsigned long port = strtoul(&peerAddress[portSeparator + sizeof(':')], &end, 10);
+	if(*end || port > UINT16_MAX) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if peer address is an IPv6 address
+	if(peerAddress.starts_with('[') && portSeparator && peerAddress[portSeparator - sizeof(']')] == ']') {
+	
+		// Check if parsing the IPv6 address failed
+		in6_addr ipAddress;
+		if(inet_pton(AF_INET6, peerAddress.substr(sizeof('['), portSeparator - sizeof('[') - sizeof(']')).c_str(), &ipAddress) != 1) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Append IPv6 address and port
+		data.push_back(static_cast<uint8_t>(PeerAddressType::IPV6));
+		data.insert(data.end(), ipAddress.s6_addr, ipAddress.s6_addr + sizeof(ipAddress.s6_addr));
+		appendInteger(data, static_cast<uint16_t>(port));
+	}
+	
+	// Otherwise
+	else {
+	
+		// Check if parsing the IPv4 address failed
+		in_addr ipAddress;
+		if(inet_pton(AF_INET, peerAddress.substr(0, portSeparator).c_str(), &ipAddress) != 1) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Append IPv4 address and port
+		data.push_back(static_cast<uint8_t>(PeerAddressType::IPV4));
+		const uint8_t *ipAddressBytes = reinterpret_cast<const uint8_t *>(&ipAddress.s_addr);
+		data.insert(data.end(), ipAddressBytes, ipAddressBytes + sizeof(ipAddress.s_addr));
+		appendInteger(data, static_cast<uint16_t>(port));
+	}
+	
+	// Return true
+	return true;
+}
+
+// Read integer
+template<typename Type> bool PeerProtocol::readInteger(const vector<uint8_t> &data, size_t &offset, Type &value) {
+
+	// Check if value is outside of the data
+	if(data.size() - offset < sizeof(value)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Go through all bytes in the value
+	value = 0;
+	for(size_t i = 0; i < sizeof(value); ++i) {
+	
+		// Append byte in big endian
+		value = (value << 8) | data[offset++];
+	}
+	
+	// Return true
+	return true;
+}
+
+// Read string
+bool PeerProtocol::readString(const vector<uint8_t> &data, size_t &offset, string &value) {
+
+	// Check if reading length failed or the string is outside of the data
+	uint64_t length;
+	if(!readInteger(data, offset, length) || length > MAX_STRING_LENGTH || data.size() - offset < length) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Get string
+	value.assign(reinterpret_cast<const char *>(&data[offset]), length);
+	offset += length;
+	
+	// Return true
+	return true;
+}
+
+// Read peer address
+bool PeerProtocol::readPeerAddress(const vector<uint8_t> &data, size_t &offset, string &value) {
+
+	// Check if reading type failed
+	uint8_t type;
+	if(!readInteger(data, offset, type)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check type
+	switch(static_cast<PeerAddressType>(type)) {
+	
+		// IPv4
+		case PeerAddressType::IPV4: {
+		
+			// Check if reading IPv4 address and port failed
+			in_addr ipAddress;
+			uint16_t port;
+			if(data.size() - offset < sizeof(ipAddress.s_addr)) {
+			
+				// Return false
+				return false;
+			}
+			memcpy(&ipAddress.s_addr, &data[offset], sizeof(ipAddress.s_addr));
+			offset += sizeof(ipAddress.s_addr);
+			if(!readInteger(data, offset, port)) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Get IPv4 address and port
+			char ipAddressString[INET_ADDRSTRLEN];
+			inet_ntop(AF_INET, &ipAddress, ipAddressString, sizeof(ipAddressString));
+			value = string(ipAddressString) + ':' + to_string(port);
+			
+			// Return true
+			return true;
+		}
+		
+		// IPv6
+		case PeerAddressType::IPV6: {
+		
+			// Check if reading IPv6 address and port failed
+			in6_addr ipAddress;
+			uint16_t port;
+			if(data.size() - offset < sizeof(ipAddress.s6_addr)) {
+			
+				// Return false
+				return false;
+			}
+			memcpy(ipAddress.s6_addr, &data[offset], sizeof(ipAddress.s6_addr));
+			offset += sizeof(ipAddress.s6_addr);
+			if(!readInteger(data, offset, port)) {
+			
+				// Return false
+				return false;
+			}
+			
+			// Get IPv6 address and port
+			char ipAddressString[INET6_ADDRSTRLEN];
+			inet_ntop(AF_INET6, &ipAddress, ipAddressString, sizeof(ipAddressString));
+			value = '[' + string(ipAddressString) + "]:" + to_string(port);
+			
+			// Return true
+			return true;
+		}
+		
+		// Onion
+		case PeerAddressType::ONION:
+		
+			// Return reading onion address
+			return readString(data, offset, value);
+			
+		// Default
+		default:
+		
+			// Return false
+			return false;
+	}
+}
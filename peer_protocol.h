@@ -0,0 +1,167 @@
+// Header guard
+#ifndef PEER_PROTOCOL_H
+#define PEER_PROTOCOL_H
+
+
+// Header files
+#include <array>
+#include <cstdint>
+#include "./node/mwc_validation_node.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Peer protocol class (the subset of the peer to peer protocol needed to handshake with a peer and ask it for the addresses of other peers)
+class PeerProtocol final {
+
+	// Public
+	public:
+	
+		// Message type
+		enum class MessageType : uint8_t {
+		
+			// Hand
+			HAND = 1,
+			
+			// Shake
+			SHAKE = 2,
+			
+			// Get peer addresses
+			GET_PEER_ADDRESSES = 5,
+			
+			// Peer addresses
+			PEER_ADDRESSES = 6
+		};
+		
+		// Message header structure
+		struct MessageHeader {
+		
+			// Type
+			MessageType type;
+			
+			// Length
+			uint64_t length;
+		};
+		
+		// Handshake structure
+		struct Handshake {
+		
+			// Protocol version
+			uint32_t protocolVersion;
+			
+			// Capabilities
+			MwcValidationNode::Node::Capabilities capabilities;
+			
+			// Total difficulty
+			uint64_t totalDifficulty;
+			
+			// User agent
+			string userAgent;
+			
+			// Genesis block hash
+			array<uint8_t, 32> genesisBlockHash;
+			
+			// Base fee
+			uint64_t baseFee;
+		};
+		
+		// Message header size
+		static const size_t MESSAGE_HEADER_SIZE = 2 + sizeof(uint8_t) + sizeof(uint64_t);
+		
+		// Max message length
+		static const uint64_t MAX_MESSAGE_LENGTH = 64 * 1024;
+		
+		// Max number of peer addresses
+		static const uint32_t MAX_NUMBER_OF_PEER_ADDRESSES = 256;
+		
+		// Protocol version
+		static const uint32_t PROTOCOL_VERSION = 4;
+		
+		// User agent
+		static constexpr const char USER_AGENT[] = "MWC Node Map " TOSTRING(PROGRAM_VERSION);
+		
+		// Constructor
+		PeerProtocol() = delete;
+		
+		// Parse genesis block hash
+		static optional<array<uint8_t, 32>> parseGenesisBlockHash(const char *genesisBlockHash);
+		
+		// Create hand message
+		static vector<uint8_t> createHandMessage(const string &receiverAddress, const uint64_t nonce, const array<uint8_t, 32> &genesisBlockHash);
+		
+		// Create hand message
+		static vector<uint8_t> createHandMessage(const Handshake &handshake, const string &senderAddress, const string &receiverAddress, const uint64_t nonce);
+		
+		// Create get peer addresses message
+		static vector<uint8_t> createGetPeerAddressesMessage();
+		
+		// Parse message header
+		static optional<MessageHeader> parseMessageHeader(const uint8_t *data);
+		
+		// Parse handshake
+		static optional<Handshake> parseHandshake(const MessageType type, const vector<uint8_t> &payload);
+		
+		// Parse peer addresses
+		static optional<vector<string>> parsePeerAddresses(const vector<uint8_t> &payload);
+		
+	// Private
+	private:
+	
+		// Check if floonet
+		#ifdef ENABLE_FLOONET
+		
+			// Magic
+			static constexpr const array<uint8_t, 2> MAGIC = {17, 36};
+			
+		// Otherwise
+		#else
+		
+			// Magic
+			static constexpr const array<uint8_t, 2> MAGIC = {13, 77};
+		#endif
+		
+		// Peer address type
+		enum class PeerAddressType : uint8_t {
+		
+			// IPv4
+			IPV4 = 0,
+			
+			// IPv6
+			IPV6 = 1,
+			
+			// Onion
+			ONION = 2
+		};
+		
+		// Max string length
+		static const uint64_t MAX_STRING_LENGTH = 1024;
+		
+		// Create message
+		static vector<uint8_t> createMessage(const MessageType type, const vector<uint8_t> &payload);
+		
+		// Append integer
+		template<typename Type> static void appendInteger(vector<uint8_t> &data, const Type value);
+		
+		// Append string
+		static void appendString(vector<uint8_t> &data, const string &value);
+		
+		// Append peer address
+		static bool appendPeerAddress(vector<uint8_t> &data, const string &peerAddress);
+		
+		// Read integer
+		template<typename Type> static bool readInteger(const vector<uint8_t> &data, size_t &offset, Type &value);
+		
+		// Read string
+		static bool readString(const vector<uint8_t> &data, size_t &offset, string &value);
+		
+		// Read peer address
+		static bool readPeerAddress(const vector<uint8_t> &data, size_t &offset, string &value);
+};
+
+
+#endif
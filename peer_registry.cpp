@@ -0,0 +1,907 @@
+// Header files
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cmath>
+#include <netinet/in.h>
+#include "./peer_registry.h"
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+PeerRegistry::PeerRegistry(const UserAgentTable &userAgentTable, const chrono::hours livenessWindow, const size_t capacity) :
+
+	// Set user agent table to user agent table
+	userAgentTable(userAgentTable),
+	
+	// Create a liveness bucket for each hour in the liveness window
+	livenessBuckets(max<chrono::hours::rep>(livenessWindow.count(), 1)),
+	
+	// Set current hour to the current time's hour
+	currentHour(getHour(chrono::system_clock::now())),
+	
+	// Set capacity to capacity
+	capacity(clamp<size_t>(capacity, 1, UINT32_MAX)),
+	
+	// Create index
+	index(userAgentTable)
+{
+}
+
+// Set history
+void PeerRegistry::setHistory(PeerHistory *history) {
+
+	// Set history to history
+	this->history = history;
+}
+
+// Set on peer changed callback
+void PeerRegistry::setOnPeerChangedCallback(const function<void(ChangeType changeType, const string &peerIdentifier, const Peer &peer)> &onPeerChangedCallback) {
+
+	// Set on peer changed callback to on peer changed callback
+	this->onPeerChangedCallback = onPeerChangedCallback;
+}
+
+// Update peer
+bool PeerRegistry::updatePeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, Geolocation &&geolocation, const bool isInbound, const chrono::microseconds latency) {
+
+	// Get current time
+	const chrono::system_clock::time_point currentTime = chrono::system_clock::now();
+	
+	// Expire peers that haven't been seen within the liveness window
+	expirePeers(getHour(currentTime));
+	
+	// Check if peer isn't already in the peers
+	Peers::iterator peer = peers.find(peerIdentifier);
+	const bool isNewPeer = peer == peers.end();
+	if(isNewPeer) {
+	
+		// Check if admitting peer failed
+		const optional<uint32_t> slot = admitPeer(peerIdentifier);
+		if(!slot.has_value()) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Add peer to the peers
+		peer = peers.emplace(peerIdentifier, Peer{
+		
+			// First seen time
+			.firstSeenTime = currentTime,
+			
+			// Seen count
+			.seenCount = 0,
+			
+			// Liveness hour
+			.livenessHour = currentHour,
+			
+			// Slot
+			.slot = slot.value()
+			
+		}).first;
+		
+		// Set peer's slot to reference the peer
+		slots[slot.value()].peer = &*peer;
+		
+		// Add peer to the current hour's liveness bucket
+		addPeerToLivenessBucket(peer->second);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Remove peer's previous record from the aggregates and index
+		aggregates.removePeer(peer->first, peer->second.geolocation, peer->second.latency);
+		index.removePeer(peer->first, peer->second.capabilities, peer->second.userAgentId, peer->second.baseFee, peer->second.geolocation, peer->second.isInbound);
+		
+		// Set peer's slot as referenced so that the clock hand passes over it the next time
+		slots[peer->second.slot].referenced = true;
+		
+		// Check if peer isn't in the current hour's liveness bucket
+		if(peer->second.livenessHour != currentHour) {
+		
+			// Move peer to the current hour's liveness bucket and leave its entry in the previous bucket to be skipped when that bucket expires
+			peer->second.livenessHour = currentHour;
+			addPeerToLivenessBucket(peer->second);
+		}
+	}
+	
+	// Update peer's latest record
+	peer->second.capabilities = capabilities;
+	peer->second.userAgentId = userAgentId;
+	peer->second.baseFee = baseFee;
+	peer->second.geolocation = move(geolocation);
+	peer->second.lastSeenTime = currentTime;
+	++peer->second.seenCount;
+	peer->second.isInbound = isInbound;
+	
+	// Check if latency was measured
+	if(latency != chrono::microseconds::zero()) {
+	
+		// Check if peer's latency was never measured
+		if(peer->second.latency == chrono::microseconds::zero()) {
+		
+			// Set peer's latency and minimum latency to the latency
+			peer->second.latency = latency;
+			peer->second.minimumLatency = latency;
+		}
+		
+		// Otherwise
+		else {
+		
+			// Move peer's latency towards the latency and update its minimum latency
+			peer->second.latency += (latency - peer->second.latency) / LATENCY_SMOOTHING_FACTOR;
+			peer->second.minimumLatency = min(peer->second.minimumLatency, latency);
+		}
+	}
+	
+	// Add peer's latest record to the aggregates and index using the peers' key since they reference it
+	aggregates.addPeer(peer->first, userAgentId, peer->second.geolocation, peer->second.latency);
+	index.addPeer(peer->first, capabilities, userAgentId, baseFee, peer->second.geolocation, isInbound);
+	
+	// Check if history exists
+	if(history) {
+	
+		// Add peer to the history
+		history->addPeer(peer->first, currentTime, capabilities, userAgentId, baseFee, peer->second.geolocation);
+	}
+	
+	// Set changed to true
+	changed = true;
+	
+	// Check if on peer changed callback exists
+	if(onPeerChangedCallback) {
+	
+		// Run on peer changed callback
+		onPeerChangedCallback(isNewPeer ? ChangeType::ADDED : ChangeType::UPDATED, peer->first, peer->second);
+	}
+	
+	// Return true
+	return true;
+}
+
+// Restore peer
+void PeerRegistry::restorePeer(const string &peerIdentifier, Peer &&peer) {
+
+	// Check if peer wasn't seen within the liveness window
+	const uint64_t hour = getHour(peer.lastSeenTime);
+	if(hour + livenessBuckets.size() <= currentHour) {
+	
+		// Return
+		return;
+	}
+	
+	// Set peer's liveness hour to the hour it was last seen without going past the current hour
+	peer.livenessHour = min(hour, currentHour);
+	
+	// Check if peer isn't already in the peers
+	Peers::iterator existingPeer = peers.find(peerIdentifier);
+	if(existingPeer == peers.end()) {
+	
+		// Check if admitting peer failed
+		const optional<uint32_t> slot = admitPeer(peerIdentifier);
+		if(!slot.has_value()) {
+		
+			// Return
+			return;
+		}
+		
+		// Add peer to the peers
+		peer.slot = slot.value();
+		existingPeer = peers.emplace(peerIdentifier, move(peer)).first;
+		
+		// Set peer's slot to reference the peer
+		slots[slot.value()].peer = &*existingPeer;
+		
+		// Add peer to its liveness bucket
+		addPeerToLivenessBucket(existingPeer->second);
+	}
+	
+	// Otherwise check if peer isn't older than the existing peer since later records in the log are more recent
+	else if(peer.lastSeenTime >= existingPeer->second.lastSeenTime) {
+	
+		// Remove existing peer from the aggregates and index
+		aggregates.removePeer(existingPeer->first, existingPeer->second.geolocation, existingPeer->second.latency);
+		index.removePeer(existingPeer->first, existingPeer->second.capabilities, existingPeer->second.userAgentId, existingPeer->second.baseFee, existingPeer->second.geolocation, existingPeer->second.isInbound);
+		
+		// Replace existing peer with the peer while keeping its slot
+		const uint64_t existingLivenessHour = existingPeer->second.livenessHour;
+		const uint32_t slot = existingPeer->second.slot;
+		existingPeer->second = move(peer);
+		existingPeer->second.slot = slot;
+		
+		// Check if peer is in a later liveness bucket than the existing peer
+		if(existingPeer->second.livenessHour > existingLivenessHour) {
+		
+			// Add peer to its liveness bucket and leave the existing peer's entry to be skipped when that bucket expires
+			addPeerToLivenessBucket(existingPeer->second);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Keep existing peer's liveness hour so that it matches the bucket that the peer is in
+			existingPeer->second.livenessHour = existingLivenessHour;
+		}
+	}
+	
+	// Otherwise
+	else {
+	
+		// Return
+		return;
+	}
+	
+	// Add peer to the aggregates and index using the peers' key since they reference it
+	aggregates.addPeer(existingPeer->first, existingPeer->second.userAgentId, existingPeer->second.geolocation, existingPeer->second.latency);
+	index.addPeer(existingPeer->first, existingPeer->second.capabilities, existingPeer->second.userAgentId, existingPeer->second.baseFee, existingPeer->second.geolocation, existingPeer->second.isInbound);
+	
+	// Set changed to true
+	changed = true;
+}
+
+// Forget peer
+void PeerRegistry::forgetPeer(const string &peerIdentifier) {
+
+	// Check if peer exists
+	const Peers::iterator peer = peers.find(peerIdentifier);
+	if(peer != peers.end()) {
+	
+		// Remove peer
+		removePeer(*peer);
+	}
+}
+
+// Take evicted peers
+optional<vector<string>> PeerRegistry::takeEvictedPeers() {
+
+	// Check if evicted peers are incomplete
+	if(evictedPeersIncomplete) {
+	
+		// Clear evicted peers and set evicted peers incomplete to false
+		evictedPeers.clear();
+		evictedPeersIncomplete = false;
+		
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Return evicted peers and leave them empty
+	return exchange(evictedPeers, vector<string>());
+}
+
+// Get peers
+const PeerRegistry::Peers &PeerRegistry::getPeers() const {
+
+	// Return peers
+	return peers;
+}
+
+// Is changed
+bool PeerRegistry::isChanged() const {
+
+	// Return if changed
+	return changed;
+}
+
+// Expire peers
+void PeerRegistry::expirePeers() {
+
+	// Expire peers that haven't been seen within the liveness window
+	expirePeers(getHour(chrono::system_clock::now()));
+}
+
+// Serialize
+void PeerRegistry::serialize(JsonSerializer &serializer) {
+
+	// Append start of peers
+	serializer.appendRaw('[');
+	
+	// Go through all peers
+	bool firstPeer = true;
+	for(const pair<const string, Peer> &peer : peers) {
+	
+		// Append separator
+		serializer.appendRaw(firstPeer ? "\n" : ",\n");
+		
+		// Append peer
+		serializePeer(serializer, peer.first, peer.second);
+		
+		// Set first peer to false
+		firstPeer = false;
+	}
+	
+	// Append end of peers
+	serializer.appendRaw("\n]");
+	
+	// Set changed to false
+	changed = false;
+}
+
+// Serialize
+void PeerRegistry::serialize(BinarySerializer &serializer) {
+
+	// Initialize location string tables and each peer's location indices in the same order that the peers are iterated
+	array<vector<string_view>, 4> locationStringTables;
+	array<unordered_map<string_view, uint32_t>, 4> locationStringIndices;
+	vector<array<uint32_t, 4>> peersLocationIndices;
+	peersLocationIndices.reserve(peers.size());
+	
+	// Go through all peers
+	for(const pair<const string, Peer> &peer : peers) {
+	
+		// Go through all of the peer's location fields
+		const array<const string *, 4> locationFields = {&peer.second.geolocation.continent, &peer.second.geolocation.country, &peer.second.geolocation.subdivision, &peer.second.geolocation.city};
+		array<uint32_t, 4> &locationIndices = peersLocationIndices.emplace_back();
+		for(size_t i = 0; i < locationFields.size(); ++i) {
+		
+			// Check if location field doesn't exist
+			if(locationFields[i]->empty()) {
+			
+				// Set location index to null
+				locationIndices[i] = 0;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Add location field to its string table if it's not already in it and set location index to its position after null
+				const pair<unordered_map<string_view, uint32_t>::iterator, bool> locationStringIndex = locationStringIndices[i].emplace(*locationFields[i], locationStringTables[i].size() + 1);
+				if(locationStringIndex.second) {
+				
+					// Append location field to its string table
+					locationStringTables[i].push_back(*locationFields[i]);
+				}
+				
+				// Set location index
+				locationIndices[i] = locationStringIndex.first->second;
+			}
+		}
+	}
+	
+	// Append magic and version
+	serializer.appendRaw(string_view(BINARY_MAGIC, sizeof(BINARY_MAGIC) - sizeof('\0')));
+	serializer.appendVarint(BINARY_VERSION);
+	
+	// Append user agent string table
+	const size_t numberOfUserAgents = userAgentTable.getNumberOfUserAgents();
+	serializer.appendVarint(numberOfUserAgents);
+	for(size_t i = 0; i < numberOfUserAgents; ++i) {
+	
+		// Append user agent's name
+		serializer.appendString(userAgentTable.getName(i));
+	}
+	
+	// Go through all location string tables
+	for(const vector<string_view> &locationStringTable : locationStringTables) {
+	
+		// Append location string table
+		serializer.appendVarint(locationStringTable.size());
+		for(const string_view &locationString : locationStringTable) {
+		
+			// Append location string
+			serializer.appendString(locationString);
+		}
+	}
+	
+	// Append number of peers
+	serializer.appendVarint(peers.size());
+	
+	// Go through all peers
+	vector<array<uint32_t, 4>>::const_iterator locationIndices = peersLocationIndices.cbegin();
+	for(const pair<const string, Peer> &peer : peers) {
+	
+		// Append address
+		serializer.appendString(getPublishedAddress(peer.first));
+		
+		// Append capabilities, user agent, and base fee
+		serializer.appendVarint(static_cast<uint32_t>(peer.second.capabilities));
+		serializer.appendVarint(peer.second.userAgentId);
+		serializer.appendVarint(peer.second.baseFee);
+		
+		// Append location indices
+		for(const uint32_t locationIndex : *locationIndices++) {
+		
+			// Append location index
+			serializer.appendVarint(locationIndex);
+		}
+		
+		// Append longitude and latitude
+		serializer.appendFixedPointOrNull(peer.second.geolocation.longitude);
+		serializer.appendFixedPointOrNull(peer.second.geolocation.latitude);
+		
+		// Append first seen, last seen, and seen count
+		serializer.appendVarint(chrono::duration_cast<chrono::seconds>(peer.second.firstSeenTime.time_since_epoch()).count());
+		serializer.appendVarint(chrono::duration_cast<chrono::seconds>(peer.second.lastSeenTime.time_since_epoch()).count());
+		serializer.appendVarint(peer.second.seenCount);
+		
+		// Append latency and minimum latency
+		serializer.appendFixedPointOrNull(getLatencyInSeconds(peer.second.latency));
+		serializer.appendFixedPointOrNull(getLatencyInSeconds(peer.second.minimumLatency));
+	}
+	
+	// Set changed to false
+	changed = false;
+}
+
+// Serialize aggregates
+void PeerRegistry::serializeAggregates(JsonSerializer &serializer) const {
+
+	// Serialize aggregates
+	aggregates.serialize(serializer, userAgentTable);
+}
+
+// Serialize query
+void PeerRegistry::serializeQuery(JsonSerializer &serializer, const PeerIndex::Query &query) const {
+
+	// Append start of peers
+	serializer.appendRaw("{\"peers\":[");
+	
+	// Go through all peers that match the query
+	bool firstPeer = true;
+	const uint64_t numberOfPeers = index.query(query, [this, &serializer, &firstPeer](const string_view &peerIdentifier) -> void {
+	
+		// Append separator
+		serializer.appendRaw(firstPeer ? "\n" : ",\n");
+		
+		// Append peer
+		const Peers::const_iterator peer = peers.find(peerIdentifier);
+		serializePeer(serializer, peer->first, peer->second);
+		
+		// Set first peer to false
+		firstPeer = false;
+	});
+	
+	// Append number of peers
+	serializer.appendRaw("\n],\"count\":");
+	serializer.appendQuotedUnsignedInteger(numberOfPeers);
+	serializer.appendRaw('}');
+}
+
+// Serialize history
+void PeerRegistry::serializeHistory(JsonSerializer &serializer) const {
+
+	// Check if history exists
+	if(history) {
+	
+		// Serialize history
+		history->serialize(serializer);
+	}
+	
+	// Otherwise
+	else {
+	
+		// Append empty history
+		serializer.appendRaw("{\"periods\":[]}");
+	}
+}
+
+// Serialize peer
+void PeerRegistry::serializePeer(JsonSerializer &serializer, const string &peerIdentifier, const Peer &peer) const {
+
+	// Address
+	serializer.appendRaw("{\"address\":");
+	
+	// Check if peer is a Tor peer
+	if(peerIdentifier.ends_with(".onion")) {
+	
+		// Append obscured Tor address
+		serializer.appendRaw('"');
+		serializer.appendUnsignedInteger(hash<string>{}(peerIdentifier));
+		serializer.appendRaw(".onion\"");
+	}
+	
+	// Otherwise
+	else {
+	
+		// Append peer identifier
+		serializer.appendString(peerIdentifier);
+	}
+	
+	// Capabilities
+	serializer.appendRaw(",\"capabilities\":");
+	serializer.appendQuotedUnsignedInteger(static_cast<uint32_t>(peer.capabilities));
+	
+	// User agent
+	serializer.appendRaw(",\"user_agent\":");
+	serializer.appendString(userAgentTable.getName(peer.userAgentId));
+	
+	// Base fee
+	serializer.appendRaw(",\"base_fee\":");
+	serializer.appendQuotedUnsignedInteger(peer.baseFee);
+	
+	// Continent
+	serializer.appendRaw(",\"continent\":");
+	serializer.appendStringOrNull(peer.geolocation.continent);
+	
+	// Country
+	serializer.appendRaw(",\"country\":");
+	serializer.appendStringOrNull(peer.geolocation.country);
+	
+	// Subdivision
+	serializer.appendRaw(",\"subdivision\":");
+	serializer.appendStringOrNull(peer.geolocation.subdivision);
+	
+	// City
+	serializer.appendRaw(",\"city\":");
+	serializer.appendStringOrNull(peer.geolocation.city);
+	
+	// Longitude
+	serializer.appendRaw(",\"longitude\":");
+	serializer.appendQuotedFixedPointOrNull(peer.geolocation.longitude);
+	
+	// Latitude
+	serializer.appendRaw(",\"latitude\":");
+	serializer.appendQuotedFixedPointOrNull(peer.geolocation.latitude);
+	
+	// First seen
+	serializer.appendRaw(",\"first_seen\":");
+	serializer.appendQuotedUnsignedInteger(chrono::duration_cast<chrono::seconds>(peer.firstSeenTime.time_since_epoch()).count());
+	
+	// Last seen
+	serializer.appendRaw(",\"last_seen\":");
+	serializer.appendQuotedUnsignedInteger(chrono::duration_cast<chrono::seconds>(peer.lastSeenTime.time_since_epoch()).count());
+	
+	// Seen count
+	serializer.appendRaw(",\"seen_count\":");
+	serializer.appendQuotedUnsignedInteger(peer.seenCount);
+	
+	// Latency
+	serializer.appendRaw(",\"latency\":");
+	serializer.appendQuotedFixedPointOrNull(getLatencyInSeconds(peer.latency));
+	
+	// Minimum latency
+	serializer.appendRaw(",\"min_latency\":");
+	serializer.appendQuotedFixedPointOrNull(getLatencyInSeconds(peer.minimumLatency));
+	serializer.appendRaw('}');
+}
+
+// Get published address
+string PeerRegistry::getPublishedAddress(const string_view &peerIdentifier) {
+
+	// Return obscured Tor address if peer is a Tor peer or the peer identifier otherwise
+	return peerIdentifier.ends_with(".onion") ? to_string(hash<string_view>{}(peerIdentifier)) + ".onion" : string(peerIdentifier);
+}
+
+// Get latency in seconds
+double PeerRegistry::getLatencyInSeconds(const chrono::microseconds &latency) {
+
+	// Return latency in seconds or not a number if it wasn't measured
+	return (latency == chrono::microseconds::zero()) ? NAN : chrono::duration<double>(latency).count();
+}
+
+// Get capacity
+size_t PeerRegistry::getCapacity() const {
+
+	// Return capacity
+	return capacity;
+}
+
+// Get number of evicted peers
+uint64_t PeerRegistry::getNumberOfEvictedPeers() const {
+
+	// Return number of evicted peers
+	return numberOfEvictedPeers.load(memory_order_relaxed);
+}
+
+// Get number of rejected peers
+uint64_t PeerRegistry::getNumberOfRejectedPeers() const {
+
+	// Return number of rejected peers
+	return numberOfRejectedPeers.load(memory_order_relaxed);
+}
+
+// Clear
+void PeerRegistry::clear() {
+
+	// Clear peers, aggregates, and index
+	peers.clear();
+	aggregates.clear();
+	index.clear();
+	
+	// Clear slots and number of peers per subnet
+	slots.clear();
+	freeSlots.clear();
+	clockHand = 0;
+	numberOfPeersPerSubnet.clear();
+	
+	// Go through all liveness buckets
+	for(vector<LivenessEntry> &livenessBucket : livenessBuckets) {
+	
+		// Clear liveness bucket
+		livenessBucket.clear();
+	}
+	numberOfLivenessEntries = 0;
+	
+	// Clear evicted peers and set evicted peers incomplete to true since the cleared peers weren't evicted
+	evictedPeers.clear();
+	evictedPeersIncomplete = true;
+	
+	// Set changed to true
+	changed = true;
+}
+
+// Get hour
+uint64_t PeerRegistry::getHour(const chrono::system_clock::time_point &time) {
+
+	// Return number of hours since the epoch
+	return chrono::floor<chrono::hours>(time).time_since_epoch().count();
+}
+
+// Get subnet
+uint64_t PeerRegistry::getSubnet(const string_view &peerIdentifier) {
+
+	// Check if peer is a Tor peer
+	if(peerIdentifier.ends_with(".onion")) {
+	
+		// Go through the characters in the address's prefix
+		uint64_t subnet = static_cast<uint64_t>(SubnetType::ONION) << SUBNET_TYPE_SHIFT;
+		for(size_t i = 0; i < ONION_PREFIX_LENGTH && i < peerIdentifier.size(); ++i) {
+		
+			// Add character to the subnet
+			subnet |= static_cast<uint64_t>(static_cast<uint8_t>(peerIdentifier[i])) << (i * 8);
+		}
+		
+		// Return subnet
+		return subnet;
+	}
+	
+	// Otherwise check if peer is an IPv6 address and port
+	else if(peerIdentifier.starts_with('[') && peerIdentifier.contains(']')) {
+	
+		// Check if parsing the address without port as an IPv6 address was successful
+		const string addressWithoutPort(peerIdentifier.substr(sizeof('['), peerIdentifier.find(']') - sizeof('[')));
+		in6_addr address;
+		if(inet_pton(AF_INET6, addressWithoutPort.c_str(), &address) == 1) {
+		
+			// Go through the bytes in the address's /48 prefix
+			uint64_t subnet = static_cast<uint64_t>(SubnetType::IPV6) << SUBNET_TYPE_SHIFT;
+			for(size_t i = 0; i < 6; ++i) {
+			
+				// Add byte to the subnet
+				subnet |= static_cast<uint64_t>(address.s6_addr[i]) << (i * 8);
+			}
+			
+			// Return subnet
+			return subnet;
+		}
+	}
+	
+	// Otherwise check if peer is an IPv4 address and port
+	else if(peerIdentifier.contains(':')) {
+	
+		// Check if parsing the address without port as an IPv4 address was successful
+		const string addressWithoutPort(peerIdentifier.substr(0, peerIdentifier.find(':')));
+		in_addr address;
+		if(inet_pton(AF_INET, addressWithoutPort.c_str(), &address) == 1) {
+		
+			// Return subnet made from the address's /24 prefix
+			return (static_cast<uint64_t>(SubnetType::IPV4) << SUBNET_TYPE_SHIFT) | (ntohl(address.s_addr) >> 8);
+		}
+	}
+	
+	// Return other subnet so that peers with unknown addresses share a single quota
+	return static_cast<uint64_t>(SubnetType::OTHER) << SUBNET_TYPE_SHIFT;
+}
+
+// Get subnet quota
+uint32_t PeerRegistry::getSubnetQuota(const uint64_t subnet) {
+
+	// Return max number of peers per onion prefix if subnet is an onion prefix or the max number of peers per subnet otherwise
+	return (static_cast<SubnetType>(subnet >> SUBNET_TYPE_SHIFT) == SubnetType::ONION) ? MAX_NUMBER_OF_PEERS_PER_ONION_PREFIX : MAX_NUMBER_OF_PEERS_PER_SUBNET;
+}
+
+// Expire peers
+void PeerRegistry::expirePeers(const uint64_t hour) {
+
+	// Check if hour isn't after the current hour
+	if(hour <= currentHour) {
+	
+		// Return
+		return;
+	}
+	
+	// Go through the liveness buckets that fall out of the window when advancing to the hour from oldest to newest so that a peer's stale entries are always visited before its current one
+	const uint64_t numberOfExpiredHours = min<uint64_t>(hour - currentHour, livenessBuckets.size());
+	for(uint64_t expiredHour = currentHour + 1; expiredHour <= currentHour + numberOfExpiredHours; ++expiredHour) {
+	
+		// Go through all peers in the liveness bucket
+		vector<LivenessEntry> &livenessBucket = livenessBuckets[expiredHour % livenessBuckets.size()];
+		for(const LivenessEntry &livenessEntry : livenessBucket) {
+		
+			// Check if peer wasn't removed and wasn't seen again after it was added to the liveness bucket
+			const Slot &slot = slots[livenessEntry.slot];
+			if(slot.generation == livenessEntry.generation && slot.peer->second.livenessHour == expiredHour - livenessBuckets.size()) {
+			
+				// Check if on peer changed callback exists
+				if(onPeerChangedCallback) {
+				
+					// Run on peer changed callback
+					onPeerChangedCallback(ChangeType::EXPIRED, slot.peer->first, slot.peer->second);
+				}
+				
+				// Remove peer
+				removePeer(*slot.peer);
+			}
+		}
+		
+		// Clear liveness bucket so that it can be used for the hour
+		numberOfLivenessEntries -= livenessBucket.size();
+		livenessBucket.clear();
+	}
+	
+	// Set current hour to the hour
+	currentHour = hour;
+}
+
+// Admit peer
+optional<uint32_t> PeerRegistry::admitPeer(const string &peerIdentifier) {
+
+	// Check if peer's subnet already has its quota of peers
+	const uint64_t subnet = getSubnet(peerIdentifier);
+	const unordered_map<uint64_t, uint32_t>::const_iterator numberOfPeersInSubnet = numberOfPeersPerSubnet.find(subnet);
+	if(numberOfPeersInSubnet != numberOfPeersPerSubnet.cend() && numberOfPeersInSubnet->second >= getSubnetQuota(subnet)) {
+	
+		// Increment number of rejected peers
+		numberOfRejectedPeers.fetch_add(1, memory_order_relaxed);
+		
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Check if the registry is full
+	if(peers.size() >= capacity) {
+	
+		// Loop while the peer at the clock hand was seen since the clock hand last passed it
+		while(slots[clockHand].referenced) {
+		
+			// Clear peer's referenced so that it's evicted the next time unless it's seen again
+			slots[clockHand].referenced = false;
+			
+			// Advance clock hand
+			clockHand = (clockHand + 1) % slots.size();
+		}
+		
+		// Advance clock hand past the peer that will be evicted
+		pair<const string, Peer> &evictedPeer = *slots[clockHand].peer;
+		clockHand = (clockHand + 1) % slots.size();
+		
+		// Check if on peer changed callback exists
+		if(onPeerChangedCallback) {
+		
+			// Run on peer changed callback
+			onPeerChangedCallback(ChangeType::EXPIRED, evictedPeer.first, evictedPeer.second);
+		}
+		
+		// Check if evicted peers can be remembered
+		if(evictedPeers.size() < capacity) {
+		
+			// Add peer to the evicted peers
+			evictedPeers.push_back(evictedPeer.first);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Set evicted peers incomplete to true
+			evictedPeersIncomplete = true;
+		}
+		
+		// Remove evicted peer
+		removePeer(evictedPeer);
+		
+		// Increment number of evicted peers
+		numberOfEvictedPeers.fetch_add(1, memory_order_relaxed);
+	}
+	
+	// Check if a free slot exists
+	uint32_t slot;
+	if(!freeSlots.empty()) {
+	
+		// Use the most recently freed slot
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	
+	// Otherwise
+	else {
+	
+		// Add a slot
+		slot = slots.size();
+		slots.push_back({
+		
+			// Peer
+			.peer = nullptr,
+			
+			// Generation
+			.generation = 0,
+			
+			// Referenced
+			.referenced = false
+		});
+	}
+	
+	// Increment number of peers in the peer's subnet
+	++numberOfPeersPerSubnet[subnet];
+	
+	// Return slot
+	return slot;
+}
+
+// Add peer to liveness bucket
+void PeerRegistry::addPeerToLivenessBucket(const Peer &peer) {
+
+	// Add peer's slot to the liveness bucket for the peer's liveness hour
+	livenessBuckets[peer.livenessHour % livenessBuckets.size()].push_back({
+	
+		// Slot
+		.slot = peer.slot,
+		
+		// Generation
+		.generation = slots[peer.slot].generation
+	});
+	
+	// Check if the liveness buckets have more than twice as many entries as there can be peers
+	if(++numberOfLivenessEntries > capacity * 2) {
+	
+		// Compact liveness buckets so that entries left behind by peers that were seen again or evicted don't grow without bound
+		compactLivenessBuckets();
+	}
+}
+
+// Remove peer
+void PeerRegistry::removePeer(pair<const string, Peer> &peer) {
+
+	// Remove peer from the aggregates and index
+	aggregates.removePeer(peer.first, peer.second.geolocation, peer.second.latency);
+	index.removePeer(peer.first, peer.second.capabilities, peer.second.userAgentId, peer.second.baseFee, peer.second.geolocation, peer.second.isInbound);
+	
+	// Free peer's slot and increment its generation so that the peer's liveness entries are skipped
+	Slot &slot = slots[peer.second.slot];
+	slot.peer = nullptr;
+	++slot.generation;
+	slot.referenced = false;
+	freeSlots.push_back(peer.second.slot);
+	
+	// Check if peer was the last one in its subnet
+	const unordered_map<uint64_t, uint32_t>::iterator numberOfPeersInSubnet = numberOfPeersPerSubnet.find(getSubnet(peer.first));
+	if(!--numberOfPeersInSubnet->second) {
+	
+		// Remove subnet's number of peers
+		numberOfPeersPerSubnet.erase(numberOfPeersInSubnet);
+	}
+	
+	// Remove peer from the peers
+	peers.erase(peers.find(peer.first));
+	
+	// Set changed to true
+	changed = true;
+}
+
+// Compact liveness buckets
+void PeerRegistry::compactLivenessBuckets() {
+
+	// Go through all liveness buckets
+	numberOfLivenessEntries = 0;
+	for(size_t i = 0; i < livenessBuckets.size(); ++i) {
+	
+		// Remove entries for peers that were removed or moved to another liveness bucket
+		vector<LivenessEntry> &livenessBucket = livenessBuckets[i];
+		erase_if(livenessBucket, [this, i](const LivenessEntry &livenessEntry) -> bool {
+		
+			// Return if entry's peer was removed or is in another liveness bucket
+			const Slot &slot = slots[livenessEntry.slot];
+			return slot.generation != livenessEntry.generation || slot.peer->second.livenessHour % livenessBuckets.size() != i;
+		});
+		
+		// Release the memory that the removed entries used
+		livenessBucket.shrink_to_fit();
+		numberOfLivenessEntries += livenessBucket.size();
+	}
+}
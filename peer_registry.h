@@ -0,0 +1,328 @@
+// Header guard
+#ifndef PEER_REGISTRY_H
+#define PEER_REGISTRY_H
+
+
+// Header files
+#include <atomic>
+#include "./binary_serializer.h"
+#include <chrono>
+#include <functional>
+#include "./geolocation.h"
+#include "./json_serializer.h"
+#include "./node/mwc_validation_node.h"
+#include "./peer_aggregates.h"
+#include "./peer_history.h"
+#include "./peer_index.h"
+#include <optional>
+#include <string_view>
+#include <string>
+#include <unordered_map>
+#include "./user_agent.h"
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Peer registry class
+class PeerRegistry final {
+
+	// Public
+	public:
+	
+		// Peer structure
+		struct Peer {
+		
+			// Capabilities
+			MwcValidationNode::Node::Capabilities capabilities;
+			
+			// User agent ID
+			uint16_t userAgentId;
+			
+			// Base fee
+			uint64_t baseFee;
+			
+			// Geolocation
+			Geolocation geolocation;
+			
+			// First seen time
+			chrono::system_clock::time_point firstSeenTime;
+			
+			// Last seen time
+			chrono::system_clock::time_point lastSeenTime;
+			
+			// Seen count
+			uint64_t seenCount;
+			
+			// Liveness hour (the hour whose liveness bucket the peer is currently in)
+			uint64_t livenessHour;
+			
+			// Is inbound (the direction of the peer's latest handshake)
+			bool isInbound;
+			
+			// Latency (exponentially weighted moving average of the peer's measured handshake round trip times or zero if it was never measured)
+			chrono::microseconds latency;
+			
+			// Minimum latency (zero if it was never measured)
+			chrono::microseconds minimumLatency;
+			
+			// Slot (the peer's position in the eviction clock)
+			uint32_t slot;
+		};
+		
+		// Peer identifier hash structure (lets peers be found with a view of their identifier without creating a string)
+		struct PeerIdentifierHash {
+		
+			// Is transparent
+			typedef void is_transparent;
+			
+			// Call operator
+			size_t operator()(const string_view &peerIdentifier) const {
+			
+				// Return hash of the peer identifier
+				return hash<string_view>()(peerIdentifier);
+			}
+		};
+		
+		// Peers type
+		typedef unordered_map<string, Peer, PeerIdentifierHash, equal_to<>> Peers;
+		
+		// Change type
+		enum class ChangeType {
+		
+			// Added
+			ADDED,
+			
+			// Updated
+			UPDATED,
+			
+			// Expired
+			EXPIRED
+		};
+		
+		// Default capacity
+		static const size_t DEFAULT_CAPACITY = 100000;
+		
+		// Constructor (the capacity is the max number of peers that are kept so that memory use stays bounded however many peers connect)
+		explicit PeerRegistry(const UserAgentTable &userAgentTable, const chrono::hours livenessWindow, const size_t capacity = DEFAULT_CAPACITY);
+		
+		// Set history (updated with the registry's lock held when a peer is updated)
+		void setHistory(PeerHistory *history);
+		
+		// Set on peer changed callback (called with the registry's lock held when a peer is added, updated, or expired but not when it's restored)
+		void setOnPeerChangedCallback(const function<void(ChangeType changeType, const string &peerIdentifier, const Peer &peer)> &onPeerChangedCallback);
+		
+		// Update peer (new peers are rejected if their subnet already has its quota of peers and evict a peer that wasn't seen recently if the registry is full, the latency is zero if it wasn't measured, and returns false if the peer was rejected)
+		bool updatePeer(const string &peerIdentifier, const MwcValidationNode::Node::Capabilities capabilities, const uint16_t userAgentId, const uint64_t baseFee, Geolocation &&geolocation, const bool isInbound, const chrono::microseconds latency);
+		
+		// Restore peer
+		void restorePeer(const string &peerIdentifier, Peer &&peer);
+		
+		// Forget peer (removes a restored peer without expiring it since it was evicted after it was stored)
+		void forgetPeer(const string &peerIdentifier);
+		
+		// Take evicted peers (returns the peers evicted since they were last taken or nothing if more were evicted than the registry's capacity or it was cleared)
+		optional<vector<string>> takeEvictedPeers();
+		
+		// Get peers
+		const Peers &getPeers() const;
+		
+		// Is changed
+		bool isChanged() const;
+		
+		// Expire peers
+		void expirePeers();
+		
+		// Serialize
+		void serialize(JsonSerializer &serializer);
+		
+		// Serialize
+		void serialize(BinarySerializer &serializer);
+		
+		// Serialize aggregates
+		void serializeAggregates(JsonSerializer &serializer) const;
+		
+		// Serialize query
+		void serializeQuery(JsonSerializer &serializer, const PeerIndex::Query &query) const;
+		
+		// Serialize history
+		void serializeHistory(JsonSerializer &serializer) const;
+		
+		// Clear
+		void clear();
+		
+		// Serialize peer
+		void serializePeer(JsonSerializer &serializer, const string &peerIdentifier, const Peer &peer) const;
+		
+		// Get published address
+		static string getPublishedAddress(const string_view &peerIdentifier);
+		
+		// Get latency in seconds (not a number if the latency wasn't measured)
+		static double getLatencyInSeconds(const chrono::microseconds &latency);
+		
+		// Get capacity
+		size_t getCapacity() const;
+		
+		// Get number of evicted peers
+		uint64_t getNumberOfEvictedPeers() const;
+		
+		// Get number of rejected peers
+		uint64_t getNumberOfRejectedPeers() const;
+		
+	// Private
+	private:
+	
+		// Binary magic
+		static constexpr const char BINARY_MAGIC[] = "MWCP";
+		
+		// Binary version
+		static const uint8_t BINARY_VERSION = 2;
+		
+		// Latency smoothing factor (each new measurement moves the peer's latency this fraction of the way towards it like TCP's smoothed round trip time)
+		static constexpr const int LATENCY_SMOOTHING_FACTOR = 8;
+		
+		// Max number of peers per subnet (IPv4 /24 or IPv6 /48 so that a single host or network can't fill the registry with addresses it controls)
+		static const uint32_t MAX_NUMBER_OF_PEERS_PER_SUBNET = 16;
+		
+		// Max number of onion peers (Tor addresses are free to create so the registry holds at most this many of them, which is far more than the network has, by splitting it evenly over the onion prefixes)
+		static const uint32_t MAX_NUMBER_OF_ONION_PEERS = 32768;
+		
+		// Onion prefix length (number of leading base32 characters of a Tor address that group it with others, at most seven so that the prefix fits below the subnet type)
+		static const size_t ONION_PREFIX_LENGTH = 2;
+		
+		// Number of onion prefixes
+		static const uint32_t NUMBER_OF_ONION_PREFIXES = 1 << (5 * ONION_PREFIX_LENGTH);
+		
+		// Max number of peers per onion prefix (Tor addresses are uniformly distributed so a prefix can only fill up when someone is generating addresses in it)
+		static const uint32_t MAX_NUMBER_OF_PEERS_PER_ONION_PREFIX = MAX_NUMBER_OF_ONION_PEERS / NUMBER_OF_ONION_PREFIXES;
+		
+		// Subnet type
+		enum class SubnetType : uint8_t {
+		
+			// Other
+			OTHER,
+			
+			// IPv4
+			IPV4,
+			
+			// IPv6
+			IPV6,
+			
+			// Onion
+			ONION
+		};
+		
+		// Subnet type shift (the subnet's type is stored in its top byte)
+		static const int SUBNET_TYPE_SHIFT = 56;
+		static_assert(ONION_PREFIX_LENGTH * 8 <= SUBNET_TYPE_SHIFT, "Onion prefix must fit below the subnet type");
+		
+		// Slot structure
+		struct Slot {
+		
+			// Peer (null if the slot is free)
+			pair<const string, Peer> *peer;
+			
+			// Generation (incremented whenever the slot's peer is removed so that liveness entries for it can be told apart from ones for the slot's next peer)
+			uint32_t generation;
+			
+			// Referenced (set when the peer is seen again and cleared when the clock hand passes it)
+			bool referenced;
+		};
+		
+		// Liveness entry structure
+		struct LivenessEntry {
+		
+			// Slot
+			uint32_t slot;
+			
+			// Generation
+			uint32_t generation;
+		};
+		
+		// Get hour
+		static uint64_t getHour(const chrono::system_clock::time_point &time);
+		
+		// Get subnet (the group of addresses that a peer's quota is shared with)
+		static uint64_t getSubnet(const string_view &peerIdentifier);
+		
+		// Get subnet quota
+		static uint32_t getSubnetQuota(const uint64_t subnet);
+		
+		// Expire peers
+		void expirePeers(const uint64_t hour);
+		
+		// Admit peer (returns the new peer's slot or nothing if the peer's subnet is full)
+		optional<uint32_t> admitPeer(const string &peerIdentifier);
+		
+		// Add peer to liveness bucket
+		void addPeerToLivenessBucket(const Peer &peer);
+		
+		// Remove peer
+		void removePeer(pair<const string, Peer> &peer);
+		
+		// Compact liveness buckets
+		void compactLivenessBuckets();
+		
+		// User agent table
+		const UserAgentTable &userAgentTable;
+		
+		// Liveness buckets (a ring with one bucket per hour in the window that contains the slots of peers last seen in that hour, so peers can be expired an hour at a time without going through every peer)
+		vector<vector<LivenessEntry>> livenessBuckets;
+		
+		// Number of liveness entries
+		size_t numberOfLivenessEntries = 0;
+		
+		// Current hour
+		uint64_t currentHour;
+		
+		// Capacity
+		const size_t capacity;
+		
+		// Peers
+		Peers peers;
+		
+		// Slots (a clock that's swept to find a peer to evict that wasn't seen since the hand last passed it)
+		vector<Slot> slots;
+		
+		// Free slots
+		vector<uint32_t> freeSlots;
+		
+		// Clock hand
+		size_t clockHand = 0;
+		
+		// Number of peers per subnet
+		unordered_map<uint64_t, uint32_t> numberOfPeersPerSubnet;
+		
+		// Number of evicted peers
+		atomic<uint64_t> numberOfEvictedPeers = 0;
+		
+		// Number of rejected peers
+		atomic<uint64_t> numberOfRejectedPeers = 0;
+		
+		// Evicted peers (identifiers of peers evicted since they were last taken so that a store can record their removal)
+		vector<string> evictedPeers;
+		
+		// Evicted peers incomplete (set when evicted peers couldn't all be remembered so that a store rewrites everything instead)
+		bool evictedPeersIncomplete = false;
+		
+		// Aggregates
+		PeerAggregates aggregates;
+		
+		// Index
+		PeerIndex index;
+		
+		// History
+		PeerHistory *history = nullptr;
+		
+		// On peer changed callback
+		function<void(ChangeType changeType, const string &peerIdentifier, const Peer &peer)> onPeerChangedCallback;
+		
+		// Changed (starts true so that the first save replaces any files left from before)
+		bool changed = true;
+};
+
+
+#endif
@@ -0,0 +1,495 @@
+// Header files
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include "./peer_store.h"
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "zlib.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+PeerStore::PeerStore(const char *location, UserAgentTable &userAgentTable) :
+
+	// Set location to location
+	location(location),
+	
+	// Set user agent table to user agent table
+	userAgentTable(userAgentTable),
+	
+	// Set file to nothing
+	file(-1),
+	
+	// Set log size to zero
+	logSize(0),
+	
+	// Set number of records to zero
+	numberOfRecords(0),
+	
+	// Set number of pending records to zero
+	numberOfPendingRecords(0),
+	
+	// Set compacting to false
+	compacting(false),
+	
+	// Set last serialize time to now
+	lastSerializeTime(chrono::system_clock::now())
+{
+}
+
+// Destructor
+PeerStore::~PeerStore() {
+
+	// Check if file is open
+	if(file != -1) {
+	
+		// Close file
+		close(file);
+	}
+}
+
+// Load
+size_t PeerStore::load(PeerRegistry &peers) {
+
+	// Check if opening file failed
+	file = open(location.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if(file == -1) {
+	
+		// Throw exception
+		throw runtime_error("Opening peer store failed");
+	}
+	
+	// Check if getting file's size failed
+	struct stat fileInfo;
+	if(fstat(file, &fileInfo)) {
+	
+		// Throw exception
+		throw runtime_error("Getting peer store's size failed");
+	}
+	
+	// Check if file has a header
+	const uint64_t fileSize = fileInfo.st_size;
+	uint64_t validSize = 0;
+	if(fileSize >= HEADER_SIZE) {
+	
+		// Check if mapping file failed
+		void *mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+		if(mapping == MAP_FAILED) {
+		
+			// Throw exception
+			throw runtime_error("Mapping peer store failed");
+		}
+		
+		// Automatically unmap file when done
+		const unique_ptr<void, function<void(void *)>> mappingUniquePointer(mapping, [fileSize](void *mapping) {
+		
+			// Unmap file
+			munmap(mapping, fileSize);
+		});
+		
+		// Tell the kernel that the file will be read sequentially
+		madvise(mapping, fileSize, MADV_SEQUENTIAL);
+		
+		// Check if file's header is invalid
+		const uint8_t *data = reinterpret_cast<const uint8_t *>(mapping);
+		if(memcmp(data, MAGIC, sizeof(MAGIC) - sizeof('\0')) || data[sizeof(MAGIC) - sizeof('\0')] != VERSION) {
+		
+			// Throw exception
+			throw runtime_error("Peer store is invalid");
+		}
+		
+		// Go through all complete records in the file
+		validSize = HEADER_SIZE;
+		string peerIdentifier;
+		while(fileSize - validSize >= RECORD_HEADER_SIZE) {
+		
+			// Get record's length and checksum in little endian
+			uint32_t length = 0;
+			uint32_t checksum = 0;
+			for(size_t i = 0; i < sizeof(uint32_t); ++i) {
+			
+				// Get length's and checksum's byte
+				length |= static_cast<uint32_t>(data[validSize + i]) << (i * 8);
+				checksum |= static_cast<uint32_t>(data[validSize + sizeof(length) + i]) << (i * 8);
+			}
+			
+			// Check if record is too long or was only partially written
+			if(length > MAX_RECORD_LENGTH || fileSize - validSize - RECORD_HEADER_SIZE < length) {
+			
+				// Break
+				break;
+			}
+			
+			// Check if record's checksum is invalid
+			const uint8_t *payload = &data[validSize + RECORD_HEADER_SIZE];
+			if(crc32(0, payload, length) != checksum) {
+			
+				// Break
+				break;
+			}
+			
+			// Check if record is a tombstone
+			PeerRegistry::Peer peer;
+			if(parseTombstone(payload, length, peerIdentifier)) {
+			
+				// Forget peer in the peers since it was evicted after it was stored
+				peers.forgetPeer(peerIdentifier);
+			}
+			
+			// Otherwise check if parsing the record failed
+			else if(!parseRecord(payload, length, peerIdentifier, peer)) {
+			
+				// Break
+				break;
+			}
+			
+			// Otherwise
+			else {
+			
+				// Restore peer in the peers
+				peers.restorePeer(peerIdentifier, move(peer));
+			}
+			
+			// Update number of records and valid size
+			++numberOfRecords;
+			validSize += RECORD_HEADER_SIZE + length;
+		}
+	}
+	
+	// Check if file doesn't have a header
+	if(!validSize) {
+	
+		// Check if writing header to the file failed
+		appendHeader();
+		if(ftruncate(file, 0) || !writeAll(file, pendingSerializer.getData(), pendingSerializer.getSize()) || fdatasync(file)) {
+		
+			// Throw exception
+			throw runtime_error("Writing peer store failed");
+		}
+		
+		// Set valid size to the header's size
+		validSize = pendingSerializer.getSize();
+		pendingSerializer.clear();
+	}
+	
+	// Otherwise check if the file ends with a partially written or corrupt record
+	else if(validSize != fileSize) {
+	
+		// Check if removing the partially written or corrupt record and everything after it failed
+		if(ftruncate(file, validSize)) {
+		
+			// Throw exception
+			throw runtime_error("Truncating peer store failed");
+		}
+	}
+	
+	// Set log size to the valid size
+	logSize = validSize;
+	
+	// Set last serialize time to now since the restored peers are already in the log
+	lastSerializeTime = chrono::system_clock::now();
+	
+	// Return number of peers
+	return peers.getPeers().size();
+}
+
+// Serialize
+void PeerStore::serialize(PeerRegistry &peers) {
+
+	// Get current time and the peers that were evicted since the last serialize
+	const chrono::system_clock::time_point currentTime = chrono::system_clock::now();
+	const optional<vector<string>> evictedPeers = peers.takeEvictedPeers();
+	
+	// Check if compacting, not all evicted peers are known, or the log has too many records compared to the number of peers
+	if(compacting || !evictedPeers.has_value() || (logSize + pendingSerializer.getSize() >= MINIMUM_COMPACTION_SIZE && numberOfRecords + numberOfPendingRecords > peers.getPeers().size() * COMPACTION_RATIO)) {
+	
+		// Set compacting to true
+		compacting = true;
+		
+		// Replace pending records with a header
+		pendingSerializer.clear();
+		numberOfPendingRecords = 0;
+		appendHeader();
+		
+		// Go through all peers
+		for(const pair<const string, PeerRegistry::Peer> &peer : peers.getPeers()) {
+		
+			// Append record for the peer
+			appendRecord(peer.first, peer.second);
+		}
+	}
+	
+	// Otherwise
+	else {
+	
+		// Go through all evicted peers
+		for(const string &evictedPeer : evictedPeers.value()) {
+		
+			// Append tombstone for the evicted peer before any records so that a peer that was evicted and then seen again is restored
+			appendTombstone(evictedPeer);
+		}
+		
+		// Go through all peers
+		for(const pair<const string, PeerRegistry::Peer> &peer : peers.getPeers()) {
+		
+			// Check if peer was seen since the last serialize
+			if(peer.second.lastSeenTime >= lastSerializeTime) {
+			
+				// Append record for the peer so that a peer that was seen many times is only written once
+				appendRecord(peer.first, peer.second);
+			}
+		}
+	}
+	
+	// Set last serialize time to the current time
+	lastSerializeTime = currentTime;
+}
+
+// Save
+void PeerStore::save() {
+
+	// Check if file isn't open
+	if(file == -1) {
+	
+		// Throw exception
+		throw runtime_error("Peer store isn't loaded");
+	}
+	
+	// Check if compacting
+	if(compacting) {
+	
+		// Check if creating temporary file failed
+		const string temporaryLocation = location + ".tmp";
+		const int temporaryFile = open(temporaryLocation.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+		if(temporaryFile == -1) {
+		
+			// Throw exception
+			throw runtime_error("Creating peer store failed");
+		}
+		
+		// Check if writing pending records to the temporary file failed or replacing the file with the temporary file failed
+		if(!writeAll(temporaryFile, pendingSerializer.getData(), pendingSerializer.getSize()) || fdatasync(temporaryFile) || rename(temporaryLocation.c_str(), location.c_str())) {
+		
+			// Close and remove temporary file
+			close(temporaryFile);
+			unlink(temporaryLocation.c_str());
+			
+			// Throw exception
+			throw runtime_error("Compacting peer store failed");
+		}
+		
+		// Replace file with the temporary file
+		close(file);
+		file = temporaryFile;
+		
+		// Set log size and number of records to the compacted log's
+		logSize = pendingSerializer.getSize();
+		numberOfRecords = numberOfPendingRecords;
+		
+		// Set compacting to false
+		compacting = false;
+	}
+	
+	// Otherwise check if records are pending
+	else if(numberOfPendingRecords) {
+	
+		// Check if appending pending records to the file failed
+		if(!writeAll(file, pendingSerializer.getData(), pendingSerializer.getSize()) || fdatasync(file)) {
+		
+			// Remove anything that was partially appended so that later records aren't written after it
+			if(ftruncate(file, logSize)) {
+			
+				// Throw exception
+				throw runtime_error("Truncating peer store failed");
+			}
+			
+			// Throw exception
+			throw runtime_error("Writing peer store failed");
+		}
+		
+		// Update log size and number of records
+		logSize += pendingSerializer.getSize();
+		numberOfRecords += numberOfPendingRecords;
+	}
+	
+	// Clear pending records
+	pendingSerializer.clear();
+	numberOfPendingRecords = 0;
+}
+
+// Append header
+void PeerStore::appendHeader() {
+
+	// Append magic and version
+	pendingSerializer.appendRaw(string_view(MAGIC, sizeof(MAGIC) - sizeof('\0')));
+	pendingSerializer.appendRaw(string_view(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION)));
+}
+
+// Append record
+void PeerStore::appendRecord(const string &peerIdentifier, const PeerRegistry::Peer &peer) {
+
+	// Serialize peer
+	recordSerializer.clear();
+	recordSerializer.appendString(peerIdentifier);
+	recordSerializer.appendVarint(static_cast<uint64_t>(peer.capabilities));
+	recordSerializer.appendString(userAgentTable.getName(peer.userAgentId));
+	recordSerializer.appendVarint(peer.baseFee);
+	recordSerializer.appendString(peer.geolocation.continent);
+	recordSerializer.appendString(peer.geolocation.country);
+	recordSerializer.appendString(peer.geolocation.subdivision);
+	recordSerializer.appendString(peer.geolocation.city);
+	recordSerializer.appendFixedPointOrNull(peer.geolocation.longitude);
+	recordSerializer.appendFixedPointOrNull(peer.geolocation.latitude);
+	recordSerializer.appendVarint(chrono::duration_cast<chrono::seconds>(peer.firstSeenTime.time_since_epoch()).count());
+	recordSerializer.appendVarint(chrono::duration_cast<chrono::seconds>(peer.lastSeenTime.time_since_epoch()).count());
+	recordSerializer.appendVarint(peer.seenCount);
+	recordSerializer.appendVarint(peer.isInbound);
+	recordSerializer.appendVarint(peer.latency.count());
+	recordSerializer.appendVarint(peer.minimumLatency.count());
+	
+	// Append serialized record
+	appendSerializedRecord();
+}
+
+// Append tombstone
+void PeerStore::appendTombstone(const string &peerIdentifier) {
+
+	// Serialize peer's identifier
+	recordSerializer.clear();
+	recordSerializer.appendString(peerIdentifier);
+	
+	// Append serialized record
+	appendSerializedRecord();
+}
+
+// Append serialized record
+void PeerStore::appendSerializedRecord() {
+
+	// Check if record is too long
+	if(recordSerializer.getSize() > MAX_RECORD_LENGTH) {
+	
+		// Return
+		return;
+	}
+	
+	// Append record's length and checksum in little endian followed by the record
+	const uint32_t length = recordSerializer.getSize();
+	const uint32_t checksum = crc32(0, reinterpret_cast<const Bytef *>(recordSerializer.getData()), length);
+	char recordHeader[RECORD_HEADER_SIZE];
+	for(size_t i = 0; i < sizeof(uint32_t); ++i) {
+	
+		// Set length's and checksum's byte
+		recordHeader[i] = length >> (i * 8);
+		recordHeader[sizeof(length) + i] = checksum >> (i * 8);
+	}
+	pendingSerializer.appendRaw(string_view(recordHeader, sizeof(recordHeader)));
+	pendingSerializer.appendRaw(string_view(recordSerializer.getData(), length));
+	
+	// Increment number of pending records
+	++numberOfPendingRecords;
+}
+
+// Parse tombstone
+bool PeerStore::parseTombstone(const uint8_t *data, const size_t length, string &peerIdentifier) {
+
+	// Return if the record only contains a peer identifier
+	const uint8_t *current = data;
+	const uint8_t *end = data + length;
+	return BinarySerializer::readString(current, end, peerIdentifier) && current == end;
+}
+
+// Parse record
+bool PeerStore::parseRecord(const uint8_t *data, const size_t length, string &peerIdentifier, PeerRegistry::Peer &peer) {
+
+	// Check if reading record's fields failed
+	const uint8_t *current = data;
+	const uint8_t *end = data + length;
+	uint64_t capabilities;
+	string userAgent;
+	uint64_t firstSeenTime;
+	uint64_t lastSeenTime;
+	uint64_t isInbound = false;
+	uint64_t latency = 0;
+	uint64_t minimumLatency = 0;
+	if(!BinarySerializer::readString(current, end, peerIdentifier) || !BinarySerializer::readVarint(current, end, capabilities) || !BinarySerializer::readString(current, end, userAgent) || !BinarySerializer::readVarint(current, end, peer.baseFee) || !BinarySerializer::readString(current, end, peer.geolocation.continent) || !BinarySerializer::readString(current, end, peer.geolocation.country) || !BinarySerializer::readString(current, end, peer.geolocation.subdivision) || !BinarySerializer::readString(current, end, peer.geolocation.city) || !readFixedPointOrNull(current, end, peer.geolocation.longitude) || !readFixedPointOrNull(current, end, peer.geolocation.latitude) || !BinarySerializer::readVarint(current, end, firstSeenTime) || !BinarySerializer::readVarint(current, end, lastSeenTime) || !BinarySerializer::readVarint(current, end, peer.seenCount) || (current != end && !BinarySerializer::readVarint(current, end, isInbound)) || (current != end && (!BinarySerializer::readVarint(current, end, latency) || !BinarySerializer::readVarint(current, end, minimumLatency))) || current != end) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Set peer's capabilities, user agent ID, times, and direction and latencies which records written before they were stored don't have
+	peer.isInbound = isInbound;
+	peer.latency = chrono::microseconds(latency);
+	peer.minimumLatency = chrono::microseconds(minimumLatency);
+	peer.capabilities = static_cast<MwcValidationNode::Node::Capabilities>(capabilities);
+	peer.userAgentId = userAgentTable.intern(userAgent);
+	peer.firstSeenTime = chrono::system_clock::time_point(chrono::seconds(firstSeenTime));
+	peer.lastSeenTime = chrono::system_clock::time_point(chrono::seconds(lastSeenTime));
+	
+	// Return true
+	return true;
+}
+
+// Read fixed point or null
+bool PeerStore::readFixedPointOrNull(const uint8_t *&current, const uint8_t *end, double &value) {
+
+	// Check if fixed point number is truncated
+	if(static_cast<size_t>(end - current) < sizeof(int32_t)) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Get fixed point number in little endian
+	uint32_t fixedPoint = 0;
+	for(size_t i = 0; i < sizeof(fixedPoint); ++i) {
+	
+		// Get byte
+		fixedPoint |= static_cast<uint32_t>(*current++) << (i * 8);
+	}
+	
+	// Set value to the fixed point number or not a number if it's null
+	value = (static_cast<int32_t>(fixedPoint) == BinarySerializer::NULL_FIXED_POINT) ? NAN : static_cast<int32_t>(fixedPoint) / BinarySerializer::FIXED_POINT_SCALE;
+	
+	// Return true
+	return true;
+}
+
+// Write all
+bool PeerStore::writeAll(const int file, const char *data, size_t size) {
+
+	// Loop until all data is written
+	while(size) {
+	
+		// Check if writing data failed
+		const ssize_t numberOfBytesWritten = write(file, data, size);
+		if(numberOfBytesWritten == -1) {
+		
+			// Check if write was interrupted
+			if(errno == EINTR) {
+			
+				// Continue
+				continue;
+			}
+			
+			// Return false
+			return false;
+		}
+		
+		// Update data and size
+		data += numberOfBytesWritten;
+		size -= numberOfBytesWritten;
+	}
+	
+	// Return true
+	return true;
+}
@@ -0,0 +1,126 @@
+// Header guard
+#ifndef PEER_STORE_H
+#define PEER_STORE_H
+
+
+// Header files
+#include "./binary_serializer.h"
+#include <chrono>
+#include <cstdint>
+#include "./peer_registry.h"
+#include <string>
+#include "./user_agent.h"
+
+using namespace std;
+
+
+// Classes
+
+// Peer store class (an append-only log of checksummed peer records and tombstones for evicted peers that's periodically compacted so that the recent peers can be restored after a restart)
+class PeerStore final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit PeerStore(const char *location, UserAgentTable &userAgentTable);
+		
+		// Destructor
+		~PeerStore();
+		
+		// Copy constructor
+		PeerStore(const PeerStore &other) = delete;
+		
+		// Copy assignment operator
+		PeerStore &operator=(const PeerStore &other) = delete;
+		
+		// Load
+		size_t load(PeerRegistry &peers);
+		
+		// Serialize
+		void serialize(PeerRegistry &peers);
+		
+		// Save
+		void save();
+		
+	// Private
+	private:
+	
+		// Magic
+		static constexpr const char MAGIC[] = "MWCS";
+		
+		// Version
+		static constexpr const uint8_t VERSION = 1;
+		
+		// Header size
+		static const size_t HEADER_SIZE = sizeof(MAGIC) - sizeof('\0') + sizeof(VERSION);
+		
+		// Record header size
+		static const size_t RECORD_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint32_t);
+		
+		// Max record length
+		static const uint32_t MAX_RECORD_LENGTH = 16 * 1024;
+		
+		// Compaction ratio (the log is compacted once it has this many times more records than there are peers so that each peer is written at most a constant number of extra times)
+		static const uint64_t COMPACTION_RATIO = 4;
+		
+		// Minimum compaction size
+		static const uint64_t MINIMUM_COMPACTION_SIZE = 1024 * 1024;
+		
+		// Append header
+		void appendHeader();
+		
+		// Append record
+		void appendRecord(const string &peerIdentifier, const PeerRegistry::Peer &peer);
+		
+		// Append tombstone (a record with only the peer's identifier that removes the peer when the log is loaded)
+		void appendTombstone(const string &peerIdentifier);
+		
+		// Append serialized record
+		void appendSerializedRecord();
+		
+		// Parse tombstone
+		static bool parseTombstone(const uint8_t *data, const size_t length, string &peerIdentifier);
+		
+		// Parse record
+		bool parseRecord(const uint8_t *data, const size_t length, string &peerIdentifier, PeerRegistry::Peer &peer);
+		
+		// Read fixed point or null
+		static bool readFixedPointOrNull(const uint8_t *&current, const uint8_t *end, double &value);
+		
+		// Write all
+		static bool writeAll(const int file, const char *data, size_t size);
+		
+		// Location
+		const string location;
+		
+		// User agent table
+		UserAgentTable &userAgentTable;
+		
+		// File
+		int file;
+		
+		// Log size
+		uint64_t logSize;
+		
+		// Number of records
+		uint64_t numberOfRecords;
+		
+		// Record serializer
+		BinarySerializer recordSerializer;
+		
+		// Pending serializer
+		BinarySerializer pendingSerializer;
+		
+		// Number of pending records
+		uint64_t numberOfPendingRecords;
+		
+		// Compacting
+		bool compacting;
+		
+		// Last serialize time
+		chrono::system_clock::time_point lastSerializeTime;
+};
+
+
+#endif
@@ -0,0 +1,531 @@
+// Header files
+#include <filesystem>
+#include <fstream>
+#include "git2.h"
+#include <iterator>
+#include <memory>
+#include "./recent_peers_uploader.h"
+
+using namespace std;
+
+
+// Constants
+
+// Git repo refspecs
+static const char *GIT_REPO_REFSPECS = "refs/heads/master";
+
+// Git uploader name
+static const char *GIT_UPLOADER_NAME = TOSTRING(PROGRAM_NAME) " Automatic Updater";
+
+
+// Supporting function implementation
+
+// Constructor
+RecentPeersUploader::RecentPeersUploader(const string &accessToken, const char *recentPeersJsonLocation, const char *recentPeersBinaryLocation, const char *recentPeersAggregatesLocation, const char *recentPeersHistoryLocation, vector<string> &&otherNetworkRecentPeersLocations, mutex &recentPeersJsonFileLock, Metrics &metrics, Logger &logger) :
+
+	// Set access token to access token
+	accessToken(accessToken),
+	
+	// Set recent peers JSON file lock to recent peers JSON file lock
+	recentPeersJsonFileLock(recentPeersJsonFileLock),
+	
+	// Set metrics to metrics
+	metrics(metrics),
+	
+	// Set logger to logger
+	logger(logger),
+	
+	// Set recent peers locations to the JSON, binary, aggregates, history, and their compressed locations
+	recentPeersLocations(SnapshotWriter::createLocations(recentPeersJsonLocation, recentPeersBinaryLocation, recentPeersAggregatesLocation, recentPeersHistoryLocation)),
+	
+	// Set other network recent peers locations to other network recent peers locations
+	otherNetworkRecentPeersLocations(move(otherNetworkRecentPeersLocations)),
+	
+	// Initialize Git
+	initializeGitResult(git_libgit2_init()),
+	
+	// Set repo to nothing
+	repo(nullptr, git_repository_free),
+	
+	// Set remote to nothing
+	remote(nullptr, git_remote_free),
+	
+	// Set push pending to false
+	pushPending(false),
+	
+	// Set uploading to false
+	uploading(false),
+	
+	// Set stopping to false
+	stopping(false),
+	
+	// Create worker
+	worker(&RecentPeersUploader::run, this)
+{
+
+	// Set push options's credentials to use the access token
+	pushOptions.callbacks.payload = const_cast<char *>(accessToken.c_str());
+	pushOptions.callbacks.credentials = [](git_credential **out, const char *url, const char *usernameFromUrl, unsigned int allowedTypes, void *payload) -> int {
+	
+		// Check if plain text credentials is allowed
+		if(allowedTypes & GIT_CREDENTIAL_USERPASS_PLAINTEXT) {
+		
+			// Get access token from payload
+			const char *accessToken = reinterpret_cast<const char *>(payload);
+			
+			// Return plain text credentials
+			return git_credential_userpass_plaintext_new(out, GIT_UPLOADER_NAME, accessToken);
+		}
+		
+		// Otherwise
+		else {
+		
+			// Return error
+			return -1;
+		}
+	};
+}
+
+// Destructor
+RecentPeersUploader::~RecentPeersUploader() {
+
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Set stopping to true
+		stopping = true;
+	}
+	
+	// Notify worker
+	condition.notify_one();
+	
+	// Check if worker is running
+	if(worker.joinable()) {
+	
+		// Wait for worker to finish
+		worker.join();
+	}
+	
+	// Free remote and repo
+	remote.reset();
+	repo.reset();
+	
+	// Check if Git was initialized
+	if(initializeGitResult >= 0) {
+	
+		// Shutdown Git
+		git_libgit2_shutdown();
+	}
+}
+
+// Upload
+bool RecentPeersUploader::upload() {
+
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Check if already uploading
+		if(uploading) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Set uploading to true
+		uploading = true;
+	}
+	
+	// Notify worker
+	condition.notify_one();
+	
+	// Return true
+	return true;
+}
+
+// Run
+void RecentPeersUploader::run() {
+
+	// Loop forever
+	while(true) {
+	
+		// Wait until uploading or stopping
+		unique_lock guard(lock);
+		condition.wait(guard, [this]() -> bool {
+		
+			// Return if uploading or stopping
+			return uploading || stopping;
+		});
+		
+		// Check if stopping
+		if(stopping) {
+		
+			// Break
+			break;
+		}
+		
+		// Unlock so that the next upload can be requested while this one is in progress
+		guard.unlock();
+		
+		// Try
+		const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+		try {
+		
+			// Lock recent peers JSON file
+			{
+				const chrono::steady_clock::time_point lockStartTime = chrono::steady_clock::now();
+				lock_guard recentPeersJsonFileGuard(recentPeersJsonFileLock);
+				metrics.recentPeersFileLockWaitDuration.observe(chrono::steady_clock::now() - lockStartTime);
+				
+				// Go through all of the recent peers files
+				for(size_t i = 0; i < recentPeersLocations.size(); ++i) {
+				
+					// Read the recent peers file as it was last saved so that the upload never serializes the recent peers itself
+					recentPeersData[i] = readRecentPeersFile(recentPeersLocations[i]);
+				}
+			}
+			
+			// Check if repo isn't open
+			if(!repo) {
+			
+				// Open repo
+				openRepo();
+			}
+			
+			// Check if committing the recent peers files created a commit
+			if(commitRecentPeersFiles()) {
+			
+				// Set push pending to true
+				pushPending = true;
+			}
+			
+			// Check if a push is pending
+			if(pushPending) {
+			
+				// Push changes
+				pushChanges();
+				
+				// Set push pending to false
+				pushPending = false;
+				
+				// Increment number of successful uploads
+				metrics.numberOfSuccessfulUploads.fetch_add(1, memory_order_relaxed);
+				
+				// Log message
+				logger.log(Logger::Severity::INFO, Logger::MessageType::GENERAL, "Successfully uploading recent peers JSON file");
+			}
+			
+			// Otherwise
+			else {
+			
+				// Increment number of skipped uploads
+				metrics.numberOfSkippedUploads.fetch_add(1, memory_order_relaxed);
+				
+				// Log message
+				logger.log(Logger::Severity::INFO, Logger::MessageType::GENERAL, "Skipped uploading recent peers JSON file since it didn't change");
+			}
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Increment number of failed uploads
+			metrics.numberOfFailedUploads.fetch_add(1, memory_order_relaxed);
+			
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Uploading recent peers JSON file failed: ", error.what());
+		}
+		
+		// Catch errors
+		catch(...) {
+		
+			// Increment number of failed uploads
+			metrics.numberOfFailedUploads.fetch_add(1, memory_order_relaxed);
+			
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::GENERAL, "Uploading recent peers JSON file failed");
+		}
+		
+		// Observe upload duration
+		metrics.uploadDuration.observe(chrono::steady_clock::now() - startTime);
+		
+		// Lock
+		guard.lock();
+		
+		// Set uploading to false
+		uploading = false;
+	}
+}
+
+// Open repo
+void RecentPeersUploader::openRepo() {
+
+	// Check if initializing Git failed
+	if(initializeGitResult < 0) {
+	
+		// Throw exception
+		throw runtime_error("Initializing Git failed");
+	}
+	
+	// Check if opening repo failed
+	git_repository *newRepo;
+	if(git_repository_open(&newRepo, "./") < 0) {
+	
+		// Throw exception
+		throw runtime_error("Opening repo failed");
+	}
+	
+	// Automatically free new repo when done
+	unique_ptr<git_repository, decltype(&git_repository_free)> newRepoUniquePointer(newRepo, git_repository_free);
+	
+	// Check if getting repo's remote failed
+	git_remote *newRemote;
+	if(git_remote_lookup(&newRemote, newRepo, "origin") < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting repo's remote failed");
+	}
+	
+	// Keep repo and remote open for all future uploads
+	remote.reset(newRemote);
+	repo = move(newRepoUniquePointer);
+}
+
+// Commit recent peers files
+bool RecentPeersUploader::commitRecentPeersFiles() const {
+
+	// Check if getting repo's head ID failed
+	git_oid headId;
+	if(git_reference_name_to_id(&headId, repo.get(), "HEAD") < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting repo's head ID failed");
+	}
+	
+	// Check if getting head commit failed
+	git_commit *headCommit;
+	if(git_commit_lookup(&headCommit, repo.get(), &headId) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting head commit failed");
+	}
+	
+	// Automatically free head commit when done
+	const unique_ptr<git_commit, decltype(&git_commit_free)> headCommitUniquePointer(headCommit, git_commit_free);
+	
+	// Check if getting head commit's tree failed
+	git_tree *headTree;
+	if(git_commit_tree(&headTree, headCommit) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting head commit's tree failed");
+	}
+	
+	// Automatically free head tree when done
+	const unique_ptr<git_tree, decltype(&git_tree_free)> headTreeUniquePointer(headTree, git_tree_free);
+	
+	// Check if creating tree builder from the head tree failed
+	git_treebuilder *treeBuilder;
+	if(git_treebuilder_new(&treeBuilder, repo.get(), headTree) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Creating tree builder failed");
+	}
+	
+	// Automatically free tree builder when done
+	const unique_ptr<git_treebuilder, decltype(&git_treebuilder_free)> treeBuilderUniquePointer(treeBuilder, git_treebuilder_free);
+	
+	// Go through all of the recent peers files
+	bool changed = false;
+	for(size_t i = 0; i < recentPeersLocations.size(); ++i) {
+	
+		// Check if the recent peers file hasn't been saved yet
+		if(recentPeersData[i].empty()) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if adding the recent peers file to the tree builder changed it
+		if(addRecentPeersFile(treeBuilder, headTree, &recentPeersLocations[i][sizeof("./") - sizeof('\0')], recentPeersData[i])) {
+		
+			// Set changed to true
+			changed = true;
+		}
+	}
+	
+	// Go through all of the other network's recent peers files
+	bool otherNetworkChanged = false;
+	for(const string &location : otherNetworkRecentPeersLocations) {
+	
+		// Check if the other network's recent peers file hasn't been saved yet by the other network's process
+		const string data = readRecentPeersFile(location);
+		if(data.empty()) {
+		
+			// Continue
+			continue;
+		}
+		
+		// Check if adding the other network's recent peers file to the tree builder changed it
+		if(addRecentPeersFile(treeBuilder, headTree, &location[sizeof("./") - sizeof('\0')], data)) {
+		
+			// Set other network changed to true
+			otherNetworkChanged = true;
+		}
+	}
+	
+	// Check if no recent peers files changed
+	if(!changed && !otherNetworkChanged) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if writing tree failed
+	git_oid treeId;
+	if(git_treebuilder_write(&treeId, treeBuilder) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Writing tree failed");
+	}
+	
+	// Check if getting tree with the tree ID failed
+	git_tree *tree;
+	if(git_tree_lookup(&tree, repo.get(), &treeId) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting tree with the tree ID failed");
+	}
+	
+	// Automatically free tree when done
+	const unique_ptr<git_tree, decltype(&git_tree_free)> treeUniquePointer(tree, git_tree_free);
+	
+	// Check if creating signature failed
+	git_signature *signature;
+	if(git_signature_now(&signature, GIT_UPLOADER_NAME, "unknown") < 0) {
+	
+		// Throw exception
+		throw runtime_error("Creating signature failed");
+	}
+	
+	// Automatically free signature when done
+	const unique_ptr<git_signature, decltype(&git_signature_free)> signatureUniquePointer(signature, git_signature_free);
+	
+	// Initialize commit message
+	string message = "Automatically updated ";
+	
+	// Check if recent peers files changed
+	if(changed) {
+	
+		// Append recent peers JSON file's path to the commit message
+		message += &recentPeersLocations[0][sizeof("./") - sizeof('\0')];
+	}
+	
+	// Check if the other network's recent peers files changed
+	if(otherNetworkChanged) {
+	
+		// Append other network's recent peers JSON file's path to the commit message
+		message += changed ? " and " : "";
+		message += &otherNetworkRecentPeersLocations.front()[sizeof("./") - sizeof('\0')];
+	}
+	
+	// Check if creating commit for the tree failed
+	git_oid commitId;
+	if(git_commit_create(&commitId, repo.get(), "HEAD", signature, signature, "UTF-8", message.c_str(), tree, 1, const_cast<const git_commit **>(&headCommit)) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Creating commit for the tree failed");
+	}
+	
+	// Return true
+	return true;
+}
+
+// Read recent peers file
+string RecentPeersUploader::readRecentPeersFile(const string &location) {
+
+	// Check if the recent peers file doesn't exist since it hasn't been saved yet
+	if(!filesystem::exists(location)) {
+	
+		// Return nothing
+		return string();
+	}
+	
+	// Check if opening the recent peers file failed
+	ifstream file(location, ios::binary);
+	if(!file) {
+	
+		// Throw exception
+		throw runtime_error("Opening recent peers file failed");
+	}
+	
+	// Check if reading the recent peers file failed
+	string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	if(file.bad()) {
+	
+		// Throw exception
+		throw runtime_error("Reading recent peers file failed");
+	}
+	
+	// Return data
+	return data;
+}
+
+// Add recent peers file
+bool RecentPeersUploader::addRecentPeersFile(git_treebuilder *treeBuilder, const git_tree *headTree, const char *path, const string_view &data) const {
+
+	// Check if getting the recent peers file's blob ID failed
+	git_oid blobId;
+	if(git_odb_hash(&blobId, data.data(), data.size(), GIT_OBJECT_BLOB) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Getting recent peers file's blob ID failed");
+	}
+	
+	// Check if recent peers file is the same as the one in the head tree
+	const git_tree_entry *headEntry = git_tree_entry_byname(headTree, path);
+	if(headEntry && git_oid_equal(&blobId, git_tree_entry_id(headEntry))) {
+	
+		// Return false
+		return false;
+	}
+	
+	// Check if creating blob from the recent peers file failed
+	if(git_blob_create_from_buffer(&blobId, repo.get(), data.data(), data.size()) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Creating blob from recent peers file failed");
+	}
+	
+	// Check if adding blob to the tree builder failed
+	if(git_treebuilder_insert(nullptr, treeBuilder, path, &blobId, GIT_FILEMODE_BLOB) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Adding blob to the tree builder failed");
+	}
+	
+	// Return true
+	return true;
+}
+
+// Push changes
+void RecentPeersUploader::pushChanges() const {
+
+	// Set refspecs
+	const git_strarray refspecs = {
+	
+		// Strings
+		const_cast<char **>(&GIT_REPO_REFSPECS),
+		
+		// Count
+		1
+	};
+	
+	// Check if pushing changes to remote failed
+	if(git_remote_push(remote.get(), &refspecs, &pushOptions) < 0) {
+	
+		// Throw exception
+		throw runtime_error("Pushing changes to remote failed");
+	}
+}
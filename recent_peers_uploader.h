@@ -0,0 +1,113 @@
+// Header guard
+#ifndef RECENT_PEERS_UPLOADER_H
+#define RECENT_PEERS_UPLOADER_H
+
+
+// Header files
+#include <condition_variable>
+#include "git2.h"
+#include "./logger.h"
+#include <memory>
+#include "./metrics.h"
+#include <mutex>
+#include "./snapshot_writer.h"
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Recent peers uploader class
+class RecentPeersUploader final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit RecentPeersUploader(const string &accessToken, const char *recentPeersJsonLocation, const char *recentPeersBinaryLocation, const char *recentPeersAggregatesLocation, const char *recentPeersHistoryLocation, vector<string> &&otherNetworkRecentPeersLocations, mutex &recentPeersJsonFileLock, Metrics &metrics, Logger &logger);
+		
+		// Destructor
+		~RecentPeersUploader();
+		
+		// Upload
+		bool upload();
+		
+	// Private
+	private:
+	
+		// Run
+		void run();
+		
+		// Open repo
+		void openRepo();
+		
+		// Commit recent peers files
+		bool commitRecentPeersFiles() const;
+		
+		// Read recent peers file
+		static string readRecentPeersFile(const string &location);
+		
+		// Add recent peers file
+		bool addRecentPeersFile(git_treebuilder *treeBuilder, const git_tree *headTree, const char *path, const string_view &data) const;
+		
+		// Push changes
+		void pushChanges() const;
+		
+		// Access token
+		const string &accessToken;
+		
+		// Recent peers JSON file lock
+		mutex &recentPeersJsonFileLock;
+		
+		// Metrics
+		Metrics &metrics;
+		
+		// Logger
+		Logger &logger;
+		
+		// Recent peers locations
+		const array<string, SnapshotWriter::NUMBER_OF_FILES> recentPeersLocations;
+		
+		// Recent peers data (contents of the recent peers files as they were last saved)
+		array<string, SnapshotWriter::NUMBER_OF_FILES> recentPeersData;
+		
+		// Other network recent peers locations (files saved by the other network's process that are committed along with this network's files so that both networks are uploaded in one push)
+		const vector<string> otherNetworkRecentPeersLocations;
+		
+		// Initialize Git result
+		const int initializeGitResult;
+		
+		// Repo
+		unique_ptr<git_repository, decltype(&git_repository_free)> repo;
+		
+		// Remote
+		unique_ptr<git_remote, decltype(&git_remote_free)> remote;
+		
+		// Push options
+		git_push_options pushOptions = GIT_PUSH_OPTIONS_INIT;
+		
+		// Push pending
+		bool pushPending;
+		
+		// Lock
+		mutex lock;
+		
+		// Condition
+		condition_variable condition;
+		
+		// Uploading
+		bool uploading;
+		
+		// Stopping
+		bool stopping;
+		
+		// Worker
+		thread worker;
+};
+
+
+#endif
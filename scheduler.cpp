@@ -0,0 +1,208 @@
+// Header files
+#include "./scheduler.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+Scheduler::Scheduler(Metrics &metrics, Logger &logger, const size_t numberOfWorkers) :
+
+	// Set metrics to metrics
+	metrics(metrics),
+	
+	// Set logger to logger
+	logger(logger),
+	
+	// Set next task ID to zero
+	nextTaskId(0),
+	
+	// Set stopping to false
+	stopping(false)
+{
+
+	// Go through all workers
+	for(size_t i = 0; i < numberOfWorkers; ++i) {
+	
+		// Create worker
+		workers.emplace_back(&Scheduler::run, this);
+	}
+}
+
+// Destructor
+Scheduler::~Scheduler() {
+
+	// Stop
+	stop();
+}
+
+// Schedule
+void Scheduler::schedule(const char *name, const chrono::steady_clock::duration &delay, const function<void()> &task) {
+
+	// Add task without an interval
+	addTask(name, delay, chrono::steady_clock::duration::zero(), task);
+}
+
+// Schedule periodic
+void Scheduler::schedulePeriodic(const char *name, const chrono::steady_clock::duration &interval, const function<void()> &task) {
+
+	// Add task with the interval
+	addTask(name, interval, interval, task);
+}
+
+// Stop
+void Scheduler::stop() {
+
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Set stopping to true
+		stopping = true;
+	}
+	
+	// Notify workers
+	condition.notify_all();
+	
+	// Go through all workers
+	for(thread &worker : workers) {
+	
+		// Check if worker is running
+		if(worker.joinable()) {
+		
+			// Wait for worker to finish
+			worker.join();
+		}
+	}
+}
+
+// Add task
+void Scheduler::addTask(const char *name, const chrono::steady_clock::duration &delay, const chrono::steady_clock::duration &interval, const function<void()> &task) {
+
+	// Lock
+	{
+		lock_guard guard(lock);
+		
+		// Add task to the tasks
+		const uint64_t taskId = nextTaskId++;
+		tasks.emplace(taskId, Task{
+		
+			// Name
+			.name = name,
+			
+			// Interval
+			.interval = interval,
+			
+			// Callback
+			.callback = task
+		});
+		
+		// Schedule task
+		scheduledTasks.emplace(chrono::steady_clock::now() + delay, taskId);
+	}
+	
+	// Notify a worker since the task may be due before the one that the workers are waiting for
+	condition.notify_one();
+}
+
+// Run
+void Scheduler::run() {
+
+	// Lock
+	unique_lock guard(lock);
+	
+	// Loop while not stopping
+	while(!stopping) {
+	
+		// Check if there's no scheduled tasks
+		if(scheduledTasks.empty()) {
+		
+			// Wait until a task is scheduled or stopping
+			condition.wait(guard);
+			
+			// Continue
+			continue;
+		}
+		
+		// Check if the next scheduled task isn't due yet
+		const ScheduledTask scheduledTask = scheduledTasks.top();
+		if(scheduledTask.first > chrono::steady_clock::now()) {
+		
+			// Wait until the scheduled task is due, an earlier task is scheduled, or stopping
+			condition.wait_until(guard, scheduledTask.first);
+			
+			// Continue
+			continue;
+		}
+		
+		// Remove scheduled task
+		scheduledTasks.pop();
+		
+		// Get task's name, interval, and callback
+		const unordered_map<uint64_t, Task>::iterator task = tasks.find(scheduledTask.second);
+		const char *name = task->second.name;
+		const chrono::steady_clock::duration interval = task->second.interval;
+		const function<void()> callback = task->second.callback;
+		
+		// Check if task is one-shot
+		if(interval == chrono::steady_clock::duration::zero()) {
+		
+			// Remove task
+			tasks.erase(task);
+		}
+		
+		// Unlock so that other workers can run tasks while this one is running
+		guard.unlock();
+		
+		// Observe how late the task started
+		const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+		metrics.schedulerTaskLag.observe(startTime - scheduledTask.first);
+		
+		// Try
+		try {
+		
+			// Run task
+			callback();
+		}
+		
+		// Catch errors
+		catch(const exception &error) {
+		
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::TASK_FAILED, "Running ", name, " task failed: ", error.what());
+		}
+		
+		// Catch errors
+		catch(...) {
+		
+			// Log message
+			logger.log(Logger::Severity::ERROR, Logger::MessageType::TASK_FAILED, "Running ", name, " task failed");
+		}
+		
+		// Observe task's run time
+		const chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+		metrics.schedulerTaskDuration.observe(endTime - startTime);
+		
+		// Lock
+		guard.lock();
+		
+		// Check if task is periodic
+		if(interval != chrono::steady_clock::duration::zero()) {
+		
+			// Get task's next deadline skipping any that were missed while it was running
+			chrono::steady_clock::time_point deadline = scheduledTask.first + interval;
+			if(deadline <= endTime) {
+			
+				// Set deadline to the next one after now
+				deadline += ((endTime - deadline) / interval + 1) * interval;
+			}
+			
+			// Schedule task's next run
+			scheduledTasks.emplace(deadline, scheduledTask.second);
+			
+			// Notify a worker since the task may be due before the one that the other workers are waiting for
+			condition.notify_one();
+		}
+	}
+}
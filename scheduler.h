@@ -0,0 +1,100 @@
+// Header guard
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+
+// Header files
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include "./logger.h"
+#include "./metrics.h"
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Scheduler class (runs periodic and one-shot tasks on a pool of workers that sleep until the next task's deadline)
+class Scheduler final {
+
+	// Public
+	public:
+	
+		// Constructor
+		explicit Scheduler(Metrics &metrics, Logger &logger, const size_t numberOfWorkers);
+		
+		// Destructor
+		~Scheduler();
+		
+		// Schedule (runs the task once after the delay)
+		void schedule(const char *name, const chrono::steady_clock::duration &delay, const function<void()> &task);
+		
+		// Schedule periodic (runs the task every interval starting one interval from now without running it again until the previous run finished)
+		void schedulePeriodic(const char *name, const chrono::steady_clock::duration &interval, const function<void()> &task);
+		
+		// Stop (waits for running tasks to finish and doesn't run any more tasks)
+		void stop();
+		
+	// Private
+	private:
+	
+		// Task structure
+		struct Task {
+		
+			// Name
+			const char *name;
+			
+			// Interval (zero if the task is one-shot)
+			chrono::steady_clock::duration interval;
+			
+			// Callback
+			function<void()> callback;
+		};
+		
+		// Scheduled task type
+		typedef pair<chrono::steady_clock::time_point, uint64_t> ScheduledTask;
+		
+		// Add task
+		void addTask(const char *name, const chrono::steady_clock::duration &delay, const chrono::steady_clock::duration &interval, const function<void()> &task);
+		
+		// Run
+		void run();
+		
+		// Metrics
+		Metrics &metrics;
+		
+		// Logger
+		Logger &logger;
+		
+		// Tasks by task ID
+		unordered_map<uint64_t, Task> tasks;
+		
+		// Next task ID
+		uint64_t nextTaskId;
+		
+		// Scheduled tasks
+		priority_queue<ScheduledTask, vector<ScheduledTask>, greater<ScheduledTask>> scheduledTasks;
+		
+		// Lock
+		mutex lock;
+		
+		// Condition
+		condition_variable condition;
+		
+		// Stopping
+		bool stopping;
+		
+		// Workers
+		vector<thread> workers;
+};
+
+
+#endif
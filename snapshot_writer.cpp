@@ -0,0 +1,112 @@
+// Header files
+#include "./file_writer.h"
+#include "./snapshot_writer.h"
+
+using namespace std;
+
+
+// Supporting function implementation
+
+// Constructor
+SnapshotWriter::SnapshotWriter(const char *jsonLocation, const char *binaryLocation, const char *aggregatesLocation, const char *historyLocation) :
+
+	// Set locations to the JSON, binary, aggregates, history, and their compressed locations
+	locations(createLocations(jsonLocation, binaryLocation, aggregatesLocation, historyLocation))
+{
+}
+
+// Serialize
+void SnapshotWriter::serialize(PeerRegistry &peers) {
+
+	// Serialize peers as JSON
+	jsonSerializer.clear();
+	peers.serialize(jsonSerializer);
+	
+	// Serialize peers as binary
+	binarySerializer.clear();
+	peers.serialize(binarySerializer);
+	
+	// Serialize peers' aggregates
+	aggregatesSerializer.clear();
+	peers.serializeAggregates(aggregatesSerializer);
+	
+	// Serialize peers' history
+	historySerializer.clear();
+	peers.serializeHistory(historySerializer);
+}
+
+// Compress
+void SnapshotWriter::compress() {
+
+	// Go through all serialized data
+	for(size_t i = 0; i < compressedData.size(); ++i) {
+	
+		// Compress serialized data
+		const string_view data = getData(i);
+		FileWriter::compress(compressedData[i], data.data(), data.size());
+	}
+}
+
+// Save
+void SnapshotWriter::save() const {
+
+	// Go through all files
+	for(size_t i = 0; i < locations.size(); ++i) {
+	
+		// Save file's data
+		const string_view data = getData(i);
+		FileWriter::write(locations[i], data.data(), data.size());
+	}
+}
+
+// Get locations
+const array<string, SnapshotWriter::NUMBER_OF_FILES> &SnapshotWriter::getLocations() const {
+
+	// Return locations
+	return locations;
+}
+
+// Get data
+string_view SnapshotWriter::getData(const size_t index) const {
+
+	// Check index
+	switch(index) {
+	
+		// JSON
+		case 0:
+		
+			// Return JSON serializer's data
+			return string_view(jsonSerializer.getData(), jsonSerializer.getSize());
+			
+		// Binary
+		case 1:
+		
+			// Return binary serializer's data
+			return string_view(binarySerializer.getData(), binarySerializer.getSize());
+			
+		// Aggregates
+		case 2:
+		
+			// Return aggregates serializer's data
+			return string_view(aggregatesSerializer.getData(), aggregatesSerializer.getSize());
+			
+		// History
+		case 3:
+		
+			// Return history serializer's data
+			return string_view(historySerializer.getData(), historySerializer.getSize());
+			
+		// Default
+		default:
+		
+			// Return compressed data
+			return string_view(compressedData[index - compressedData.size()].data(), compressedData[index - compressedData.size()].size());
+	}
+}
+
+// Create locations
+array<string, SnapshotWriter::NUMBER_OF_FILES> SnapshotWriter::createLocations(const char *jsonLocation, const char *binaryLocation, const char *aggregatesLocation, const char *historyLocation) {
+
+	// Return the JSON, binary, aggregates, history, and their compressed locations
+	return {jsonLocation, binaryLocation, aggregatesLocation, historyLocation, string(jsonLocation) + COMPRESSED_EXTENSION, string(binaryLocation) + COMPRESSED_EXTENSION, string(aggregatesLocation) + COMPRESSED_EXTENSION, string(historyLocation) + COMPRESSED_EXTENSION};
+}
@@ -0,0 +1,76 @@
+// Header guard
+#ifndef SNAPSHOT_WRITER_H
+#define SNAPSHOT_WRITER_H
+
+
+// Header files
+#include <array>
+#include "./binary_serializer.h"
+#include "./json_serializer.h"
+#include "./peer_registry.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+
+// Classes
+
+// Snapshot writer class
+class SnapshotWriter final {
+
+	// Public
+	public:
+	
+		// Compressed extension
+		static constexpr const char COMPRESSED_EXTENSION[] = ".gz";
+		
+		// Number of files
+		static const size_t NUMBER_OF_FILES = 8;
+		
+		// Constructor
+		explicit SnapshotWriter(const char *jsonLocation, const char *binaryLocation, const char *aggregatesLocation, const char *historyLocation);
+		
+		// Serialize
+		void serialize(PeerRegistry &peers);
+		
+		// Compress
+		void compress();
+		
+		// Save
+		void save() const;
+		
+		// Get locations
+		const array<string, NUMBER_OF_FILES> &getLocations() const;
+		
+		// Get data
+		string_view getData(const size_t index) const;
+		
+		// Create locations
+		static array<string, NUMBER_OF_FILES> createLocations(const char *jsonLocation, const char *binaryLocation, const char *aggregatesLocation, const char *historyLocation);
+		
+	// Private
+	private:
+	
+		// Locations
+		const array<string, NUMBER_OF_FILES> locations;
+		
+		// JSON serializer
+		JsonSerializer jsonSerializer;
+		
+		// Binary serializer
+		BinarySerializer binarySerializer;
+		
+		// Aggregates serializer
+		JsonSerializer aggregatesSerializer;
+		
+		// History serializer
+		JsonSerializer historySerializer;
+		
+		// Compressed data
+		array<vector<char>, NUMBER_OF_FILES / 2> compressedData;
+};
+
+
+#endif
@@ -0,0 +1,288 @@
+// Header files
+#include "./user_agent.h"
+
+using namespace std;
+
+
+// Structures
+
+// Trie node structure
+struct TrieNode {
+
+	// Character
+	char character;
+	
+	// First child
+	uint8_t firstChild;
+	
+	// Next sibling
+	uint8_t nextSibling;
+	
+	// Implementation
+	int8_t implementation;
+};
+
+
+// Constants
+
+// No trie node
+static const uint8_t NO_TRIE_NODE = 0;
+
+// No implementation
+static const int8_t NO_IMPLEMENTATION = -1;
+
+// Number of trie nodes
+static constexpr const size_t NUMBER_OF_TRIE_NODES = []() -> size_t {
+
+	// Go through all implementation names
+	size_t numberOfTrieNodes = 1;
+	for(const string_view &implementationName : UserAgentMatcher::IMPLEMENTATION_NAMES) {
+	
+		// Add implementation name's length to the number of trie nodes
+		numberOfTrieNodes += implementationName.size();
+	}
+	
+	// Return number of trie nodes
+	return numberOfTrieNodes;
+}();
+
+// Check if trie nodes can't be indexed by a byte
+static_assert(NUMBER_OF_TRIE_NODES <= UINT8_MAX, "Trie nodes can't be indexed by a byte");
+
+// Trie (prefix trie of the implementation names built at compile time)
+static constexpr const array<TrieNode, NUMBER_OF_TRIE_NODES> TRIE = []() -> array<TrieNode, NUMBER_OF_TRIE_NODES> {
+
+	// Initialize trie with only a root node
+	array<TrieNode, NUMBER_OF_TRIE_NODES> trie = {};
+	trie[0].implementation = NO_IMPLEMENTATION;
+	size_t numberOfTrieNodes = 1;
+	
+	// Go through all implementation names
+	for(size_t implementation = 0; implementation < UserAgentMatcher::IMPLEMENTATION_NAMES.size(); ++implementation) {
+	
+		// Go through all characters in the implementation name
+		uint8_t node = 0;
+		for(const char character : UserAgentMatcher::IMPLEMENTATION_NAMES[implementation]) {
+		
+			// Go through all of the node's children
+			uint8_t child = trie[node].firstChild;
+			while(child != NO_TRIE_NODE && trie[child].character != character) {
+			
+				// Go to next sibling
+				child = trie[child].nextSibling;
+			}
+			
+			// Check if no child has the character
+			if(child == NO_TRIE_NODE) {
+			
+				// Add child to the trie as the node's first child
+				child = numberOfTrieNodes++;
+				trie[child] = {
+				
+					// Character
+					.character = character,
+					
+					// First child
+					.firstChild = NO_TRIE_NODE,
+					
+					// Next sibling
+					.nextSibling = trie[node].firstChild,
+					
+					// Implementation
+					.implementation = NO_IMPLEMENTATION
+				};
+				trie[node].firstChild = child;
+			}
+			
+			// Otherwise check if the implementation name is a prefix of another one
+			else if(trie[child].implementation != NO_IMPLEMENTATION) {
+			
+				// Throw error
+				throw "Implementation names can't be prefixes of each other";
+			}
+			
+			// Go to child
+			node = child;
+		}
+		
+		// Check if the implementation name is a prefix of another one
+		if(trie[node].firstChild != NO_TRIE_NODE) {
+		
+			// Throw error
+			throw "Implementation names can't be prefixes of each other";
+		}
+		
+		// Set node's implementation
+		trie[node].implementation = implementation;
+	}
+	
+	// Return trie
+	return trie;
+}();
+
+// Unknown user agent name
+static const char *UNKNOWN_USER_AGENT_NAME = "Unknown";
+
+
+// Supporting function implementation
+
+// Match
+optional<UserAgent> UserAgentMatcher::match(const string_view &userAgent) {
+
+	// Go through all characters in the user agent until an implementation name is matched
+	const char *current = userAgent.data();
+	const char *end = userAgent.data() + userAgent.size();
+	uint8_t node = 0;
+	while(TRIE[node].implementation == NO_IMPLEMENTATION) {
+	
+		// Check if at the end of the user agent
+		if(current == end) {
+		
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Go through all of the node's children
+		uint8_t child = TRIE[node].firstChild;
+		while(child != NO_TRIE_NODE && TRIE[child].character != *current) {
+		
+			// Go to next sibling
+			child = TRIE[child].nextSibling;
+		}
+		
+		// Check if no child has the character
+		if(child == NO_TRIE_NODE) {
+		
+			// Return nothing
+			return nullopt;
+		}
+		
+		// Go to child and next character
+		node = child;
+		++current;
+	}
+	
+	// Check if parsing the major version, minor version, and patch version failed
+	UserAgent result = {
+	
+		// Implementation
+		.implementation = static_cast<uint8_t>(TRIE[node].implementation)
+	};
+	if(!parseVersionComponent(current, end, result.majorVersion) || current == end || *current++ != '.' || !parseVersionComponent(current, end, result.minorVersion) || current == end || *current++ != '.' || !parseVersionComponent(current, end, result.patchVersion) || current != end) {
+	
+		// Return nothing
+		return nullopt;
+	}
+	
+	// Return result
+	return result;
+}
+
+// Parse version component
+bool UserAgentMatcher::parseVersionComponent(const char *&current, const char *end, uint16_t &versionComponent) {
+
+	// Go through all digits in the version component
+	const char *start = current;
+	versionComponent = 0;
+	while(current != end && *current >= '0' && *current <= '9') {
+	
+		// Check if version component is too long
+		if(current - start == MAX_VERSION_COMPONENT_LENGTH) {
+		
+			// Return false
+			return false;
+		}
+		
+		// Add digit to the version component
+		versionComponent = versionComponent * 10 + (*current++ - '0');
+	}
+	
+	// Return if the version component has at least one digit
+	return current != start;
+}
+
+// Constructor
+UserAgentTable::UserAgentTable() :
+
+	// Create entries
+	entries(make_unique<Entry[]>(CAPACITY)),
+	
+	// Set number of entries to one
+	numberOfEntries(1)
+{
+
+	// Set first entry to the unknown user agent
+	entries[UNKNOWN_USER_AGENT_ID].name = UNKNOWN_USER_AGENT_NAME;
+}
+
+// Intern
+uint16_t UserAgentTable::intern(const string_view &userAgent) {
+
+	// Check if user agent isn't known
+	const optional<UserAgent> result = UserAgentMatcher::match(userAgent);
+	if(!result.has_value()) {
+	
+		// Return unknown user agent ID
+		return UNKNOWN_USER_AGENT_ID;
+	}
+	
+	// Lock
+	lock_guard guard(lock);
+	
+	// Check if user agent was already interned
+	const uint64_t key = getKey(result.value());
+	const unordered_map<uint64_t, uint16_t>::const_iterator id = ids.find(key);
+	if(id != ids.end()) {
+	
+		// Return user agent's ID
+		return id->second;
+	}
+	
+	// Check if table is full
+	const size_t currentNumberOfEntries = numberOfEntries.load(memory_order_relaxed);
+	if(currentNumberOfEntries == CAPACITY) {
+	
+		// Return unknown user agent ID
+		return UNKNOWN_USER_AGENT_ID;
+	}
+	
+	// Create entry with the user agent's canonical name
+	Entry &entry = entries[currentNumberOfEntries];
+	entry.name = string(UserAgentMatcher::IMPLEMENTATION_NAMES[result.value().implementation]) + to_string(result.value().majorVersion) + '.' + to_string(result.value().minorVersion) + '.' + to_string(result.value().patchVersion);
+	entry.userAgent = result;
+	
+	// Publish entry
+	ids.emplace(key, currentNumberOfEntries);
+	numberOfEntries.store(currentNumberOfEntries + 1, memory_order_release);
+	
+	// Return user agent's ID
+	return currentNumberOfEntries;
+}
+
+// Get name
+const string &UserAgentTable::getName(const uint16_t userAgentId) const {
+
+	// Return entry's name or the unknown user agent's name if the entry doesn't exist
+	return entries[(userAgentId < numberOfEntries.load(memory_order_acquire)) ? userAgentId : UNKNOWN_USER_AGENT_ID].name;
+}
+
+// Get user agent
+const optional<UserAgent> &UserAgentTable::getUserAgent(const uint16_t userAgentId) const {
+
+	// Return entry's user agent or the unknown user agent if the entry doesn't exist
+	return entries[(userAgentId < numberOfEntries.load(memory_order_acquire)) ? userAgentId : UNKNOWN_USER_AGENT_ID].userAgent;
+}
+
+// Get number of user agents
+size_t UserAgentTable::getNumberOfUserAgents() const {
+
+	// Return number of entries
+	return numberOfEntries.load(memory_order_acquire);
+}
+
+// Get key
+uint64_t UserAgentTable::getKey(const UserAgent &userAgent) {
+
+	// Return user agent's fields packed into a key
+	return (static_cast<uint64_t>(userAgent.implementation) << 48) | (static_cast<uint64_t>(userAgent.majorVersion) << 32) | (static_cast<uint64_t>(userAgent.minorVersion) << 16) | userAgent.patchVersion;
+}
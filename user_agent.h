@@ -0,0 +1,142 @@
+// Header guard
+#ifndef USER_AGENT_H
+#define USER_AGENT_H
+
+
+// Header files
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+
+// Structures
+
+// User agent structure
+struct UserAgent {
+
+	// Implementation
+	uint8_t implementation;
+	
+	// Major version
+	uint16_t majorVersion;
+	
+	// Minor version
+	uint16_t minorVersion;
+	
+	// Patch version
+	uint16_t patchVersion;
+};
+
+
+// Classes
+
+// User agent matcher class
+class UserAgentMatcher final {
+
+	// Public
+	public:
+	
+		// Constructor
+		UserAgentMatcher() = delete;
+		
+		// Implementation names
+		static constexpr const array<string_view, 6> IMPLEMENTATION_NAMES = {
+		
+			// MWC node
+			"MW/MWC ",
+			
+			// MWC validation node
+			"MWC Validation Node ",
+			
+			// MWC Pay
+			"MWC Pay ",
+			
+			// MWC node map
+			"MWC Node Map ",
+			
+			// MWC node C++
+			"mwc-node-cpp/",
+			
+			// MWC node Go
+			"mwc-node-go/"
+		};
+		
+		// Match
+		static optional<UserAgent> match(const string_view &userAgent);
+		
+	// Private
+	private:
+	
+		// Max version component length
+		static const size_t MAX_VERSION_COMPONENT_LENGTH = 3;
+		
+		// Parse version component
+		static bool parseVersionComponent(const char *&current, const char *end, uint16_t &versionComponent);
+};
+
+// User agent table class
+class UserAgentTable final {
+
+	// Public
+	public:
+	
+		// Unknown user agent ID
+		static const uint16_t UNKNOWN_USER_AGENT_ID = 0;
+		
+		// Constructor
+		UserAgentTable();
+		
+		// Intern
+		uint16_t intern(const string_view &userAgent);
+		
+		// Get name
+		const string &getName(const uint16_t userAgentId) const;
+		
+		// Get user agent
+		const optional<UserAgent> &getUserAgent(const uint16_t userAgentId) const;
+		
+		// Get number of user agents
+		size_t getNumberOfUserAgents() const;
+		
+	// Private
+	private:
+	
+		// Capacity
+		static const size_t CAPACITY = 4096;
+		
+		// Entry structure
+		struct Entry {
+		
+			// Name
+			string name;
+			
+			// User agent
+			optional<UserAgent> userAgent;
+		};
+		
+		// Get key
+		static uint64_t getKey(const UserAgent &userAgent);
+		
+		// Entries
+		const unique_ptr<Entry[]> entries;
+		
+		// Number of entries
+		atomic<size_t> numberOfEntries;
+		
+		// IDs
+		unordered_map<uint64_t, uint16_t> ids;
+		
+		// Lock
+		mutex lock;
+};
+
+
+#endif